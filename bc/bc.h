@@ -44,21 +44,101 @@ typedef struct bcp_struct *bcp;
 typedef __m128i *bc;
 typedef struct bcl_struct *bcl;
 typedef struct bcx_struct *bcx;
+typedef struct bcs_struct *bcs;
+typedef struct bct_struct *bct;
+typedef struct bca_struct *bca;
+typedef struct bcm_struct *bcm;
+typedef struct bcd_struct *bcd;
+typedef struct bcj_struct *bcj;
+typedef struct bcf_struct *bcf;
+
+
+/* 
+  SIMD level for the cube kernels in bcube.c, selected by bcp_New() 
+  The block itself is always one __m128i, but with AVX2 two and with AVX-512 four blocks are processed at once.
+  For this reason blk_cnt is a multiple of 2 (AVX2) or 4 (AVX-512), the additional blocks contain only don't care values
+*/
+#define BCP_SIMD_SSE2 0
+#define BCP_SIMD_AVX2 1
+#define BCP_SIMD_AVX512 2
+#ifndef BCP_SIMD_MAX_LEVEL
+#define BCP_SIMD_MAX_LEVEL BCP_SIMD_AVX512     /* use -DBCP_SIMD_MAX_LEVEL=0 to force the SSE2 kernels */
+#endif
 
+/* 
+  boolean cube problem, each function will require a pointer to this struct 
 
-/* boolean cube problem, each function will require a pointer to this struct */
+  The struct is split into the problem data, which is read only after the problem setup
+  and the execution context with the temp cubes and the string buffer.
+  bcp_New() creates the problem together with its first execution context.
+  bcp_NewContext() creates a further context for the same problem, which shares the problem data. 
+  Each thread requires its own context (bcp_GetTempCube() and bcp_GetStringFromCube() are not MT-safe),
+  but all threads can work on the same input lists.
+*/
 #define BCP_MAX_STACK_FRAME_DEPTH 500
+/* fast leaf checks of bcp_IsBCLTautologySub(), index into bcp_struct.tautology_leaf_cnt[] */
+#define BCP_TAUTOLOGY_LEAF_UNIVERSAL 0  // a cube is the universal cube: tautology
+#define BCP_TAUTOLOGY_LEAF_LITERAL 1    // a variable has the same literal in all cubes: no tautology
+#define BCP_TAUTOLOGY_LEAF_MINTERM 2    // the sum of the minterms of all cubes is too small: no tautology
+#define BCP_TAUTOLOGY_LEAF_TRUTH_TABLE 3        // only a few variables are used: decided with a truth table
+#define BCP_TAUTOLOGY_LEAF_CNT 4
+#define BCP_MAX_ARENA_FRAME_DEPTH 1100
+
+/*
+  execution statistics of a context, see bcstat.c
+  The counters are updated with bcp_IncStat()/bcp_AddStat(), use -DBCP_STAT=0 to remove all updates.
+  The statistics of a context are added to the problem by bcp_Delete().
+*/
+#ifndef BCP_STAT
+#define BCP_STAT 1
+#endif
+#define BCP_STAT_INTERSECTION_CUBE 0    // calls of the cube kernels in bcube.c
+#define BCP_STAT_IS_INTERSECTION_CUBE 1
+#define BCP_STAT_IS_SUBSET_CUBE 2
+#define BCP_STAT_CUBE_DELTA 3
+#define BCP_STAT_OR_BIT_CNT 4
+#define BCP_STAT_SLICE_QUERY 5          // queries of the bit sliced view
+#define BCP_STAT_TAUTOLOGY_NODE 6       // calls of bcp_IsBCLTautologySub()
+#define BCP_STAT_PARTITION 7            // independent partitions found by the tautology check
+#define BCP_STAT_COFACTOR_CUBE 8        // cubes of the lists created by the cofactor functions
+#define BCP_STAT_SCC_REMOVED 9          // cubes removed by single cube containment
+#define BCP_STAT_MCC_REMOVED 10         // cubes removed by multi cube containment
+#define BCP_STAT_CNT 11
+#define BCP_STAT_OP_TAUTOLOGY 0         // high level operations with wall time
+#define BCP_STAT_OP_SUBSET 1
+#define BCP_STAT_OP_SUBTRACT 2
+#define BCP_STAT_OP_INTERSECTION 3
+#define BCP_STAT_OP_COMPLEMENT 4
+#define BCP_STAT_OP_MINIMIZE 5
+#define BCP_STAT_OP_CNT 6
+struct bcp_stat_struct
+{
+  long cnt[BCP_STAT_CNT];
+  int tautology_max_depth;
+  long op_cnt[BCP_STAT_OP_CNT];         // number of calls of the operation, nested calls of the same operation are not counted
+  double op_time[BCP_STAT_OP_CNT];      // wall time in seconds, includes the time of other operations, which are called by the operation
+  int op_depth[BCP_STAT_OP_CNT];        // nesting level of the operation
+  double op_start[BCP_STAT_OP_CNT];
+};
+
 struct bcp_struct
 {
+  /* problem data: must not be modified if there are other contexts, scalar values are copied to each context */
+  
   int var_cnt;  // number of variables per cube
-  int blk_cnt;  // number of blocks per cube, one block is one __m128i = 64 variables
+  int blk_cnt;  // number of blocks per cube, one block is one __m128i = 64 variables, multiple of 2 or 4 depending on simd_level
   int vars_per_blk_cnt; // number of variables per block --> 64
   int bytes_per_cube_cnt; // number of bytes per cube, this is blk_cnt*sizeof(__m128i)
-  char *cube_to_str;    // storage area for one visual representation of a cube
-  bcl stack_cube_list;    // storage area for temp cubes
-  int stack_frame_pos[BCP_MAX_STACK_FRAME_DEPTH];
-  int stack_depth;
-  bcl global_cube_list;    // storage area for temp cubes
+  int simd_level;       // BCP_SIMD_SSE2, BCP_SIMD_AVX2 or BCP_SIMD_AVX512
+  
+  /* cube kernels, assigned by bcp_SetCubeFunctions() according to simd_level, see bcube.c */
+  int (*intersection_cube)(bcp p, bc r, bc a, bc b);
+  int (*is_intersection_cube)(bcp p, bc a, bc b);
+  int (*is_subset_cube)(bcp p, bc a, bc b);
+  int (*get_cube_delta)(bcp p, bc a, bc b);
+  unsigned (*or_bit_cnt)(bcp p, bc r, bc a, bc b);
+  
+  bcl global_cube_list;    // constant cubes, shared with all contexts
   
   int x_end;
   int x_not;
@@ -68,6 +148,138 @@ struct bcp_struct
   
   co var_map;           // map with all variables, key=name, value=position (double), p->x_var_cnt contains the number of variables in var_map
   co var_list;                  // vector with all variables, derived from var_map
+  
+  /* execution context: private to each context */
+  
+  bcp master;           // NULL for the problem itself, otherwise the problem, from which this context was created by bcp_NewContext()
+  char *cube_to_str;    // storage area for one visual representation of a cube
+  bcl stack_cube_list;    // storage area for temp cubes
+  int stack_frame_pos[BCP_MAX_STACK_FRAME_DEPTH];
+  int stack_depth;
+  bca arena_first;      // first memory block of the bcl arena, NULL if not yet required
+  bca arena_current;    // block, which is used for the next allocation
+  bca arena_frame_block[BCP_MAX_ARENA_FRAME_DEPTH];
+  size_t arena_frame_pos[BCP_MAX_ARENA_FRAME_DEPTH];
+  int arena_depth;
+  long tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_CNT];  // number of sub problems, which were solved by the fast leaf checks
+  struct bcp_stat_struct stat;  // execution statistics, see bcstat.c
+  int *partition_var;   // union find for bcp_GetBCLPartition(): 3*var_cnt entries (parent, stamp and partition of each variable)
+  int partition_stamp;
+  bcm tautology_cache;  // optional cache for the results of bcp_IsBCLTautologySub(), NULL if disabled, see bcp_EnableTautologyCache()
+  struct bcp_taut_worker_struct *tautology_worker;      // worker of bcp_IsBCLTautologyParallel(), which uses this context, otherwise NULL
+};
+
+/* 
+  one memory block of the bcl arena, see bcp_StartBCLArenaFrame() 
+  blocks are never moved, so pointers into a block are valid until the frame is closed
+*/
+#define BCA_BLOCK_SIZE (1<<20)
+struct bca_struct
+{
+  bca next;
+  size_t size;          // number of bytes in "data"
+  size_t pos;           // first free byte in "data"
+  __m128i data[];
+};
+
+/* 
+  tautology result cache, one per execution context
+  The key is the set of the cubes of a list: the cubes are sorted by their hash value (and content),
+  so that lists, which differ only in the order of the cubes, will have the same key.
+  The table is direct mapped: a new entry replaces the entry in the same slot.
+  An entry holds a copy of the sorted cubes, so that a hash collision can not produce a wrong result.
+  If the memory of all entries exceeds "mem_budget", then the complete table is cleared.
+*/
+#define BCM_DEFAULT_SLOT_CNT 4096
+#define BCM_DEFAULT_MIN_CNT 16
+struct bcm_entry_struct
+{
+  uint64_t hash;
+  int cnt;              // number of cubes in "list", 0 for an unused slot
+  int result;           // tautology result for the cubes in "list"
+  __m128i *list;        // cnt cubes in canonical order
+};
+
+struct bcm_struct
+{
+  int slot_cnt;         // power of 2
+  int min_cnt;          // lists with fewer cubes are not cached
+  size_t mem_budget;    // max number of bytes for the cubes of all entries
+  size_t mem_used;
+  struct bcm_entry_struct *slot;
+  long hit_cnt;
+  long miss_cnt;
+  long collision_cnt;   // same slot and hash, but different cubes
+  long flush_cnt;       // number of times, the table was cleared because of the memory budget
+};
+
+/*
+  scope of the multi threaded tautology check, see bcltautologymt.c
+  A new scope is started for each independent partition. Once a sub problem is not tautology,
+  the scope is canceled: All other tasks of this scope (and of the inner scopes) are not required any more.
+*/
+struct bcp_taut_scope_struct
+{
+  int is_cancel;                // set to 1 if any sub problem of this scope is not tautology
+  struct bcp_taut_scope_struct *parent; // outer scope or NULL
+};
+
+/*
+  DIMACS CNF reader, created by bcp_NewBCD()
+  A regular file is mapped into memory ("data" points to the complete file),
+  any other input is read block by block into "buffer" ("data" points to "buffer").
+*/
+#define BCD_DEFAULT_BUFFER_SIZE (1<<20)
+struct bcd_struct
+{
+  FILE *fp;
+  int is_fp_owner;      // "fp" is closed by bcp_DeleteBCD()
+  int is_mmap;
+  char *buffer;         // NULL for a memory mapped file
+  size_t buffer_size;
+  const char *data;
+  size_t len;           // number of valid bytes in "data"
+  size_t pos;           // read position inside "data"
+  int var_cnt;          // values from the "p cnf" header
+  int clause_cnt;
+};
+
+/*
+  multiple output function, created by bcp_NewBCFByPLA(), see bclpla.c
+  The problem "p" has in_cnt+out_cnt variables, the output variables follow the input variables.
+*/
+#define BCF_TYPE_ON 1
+#define BCF_TYPE_DC 2
+#define BCF_TYPE_OFF 4
+struct bcf_struct
+{
+  int in_cnt;           // values from the ".i" and ".o" lines
+  int out_cnt;
+  int type;             // combination of BCF_TYPE_ON, BCF_TYPE_DC and BCF_TYPE_OFF from the ".type" line, default is "fd"
+  bcp p;
+  bcl on;               // on-set of all outputs
+  bcl dc;               // explicit don't care set of all outputs, might be empty
+  bcl off;              // explicit off-set, each cube belongs to exactly one output, NULL if the type does not include "r"
+  co in_name;           // vector with the ".ilb" names, NULL if not given
+  co out_name;          // vector with the ".ob" names, NULL if not given
+  char *out_part;       // out_cnt+1 chars for the output part of one cube
+};
+
+/*
+  JSON command executor, created by bc_NewBCJ()
+  The problem and the slots are kept from one command vector to the next (see bcjson.c).
+*/
+#define BCJ_DEFAULT_SLOT_CNT 9
+struct bcj_struct
+{
+  bcp p;                // created by the first bcl/expr argument, NULL before
+  int slot_cnt;
+  bcl *slot_list;
+  int is_var_check;     // 1 if an expression may only use the variables, which are already part of "p"
+  struct bcj_cmd_struct *cmd_list;      // commands of the current vector
+  struct bcj_task_struct *task_list;
+  const char *error;    // first error of the last command vector or NULL, see bc_ExecuteBCJ()
+  long error_idx;       // index of the command with this error
 };
 
 /* one cube, the number of __m128i is (var_cnt / 64) */
@@ -79,8 +291,47 @@ struct bcl_struct
   int last_deleted;
   __m128i *list;        // max * var_cnt / 64 entries
   uint8_t *flags;       // bit 0 is the cube deleted flag
+  uint64_t *sig;        // signature of each cube (see bcp_GetCubeSignature()), only valid if "is_sig" is set
+  bcs slice;            // optional bit sliced view of "list", created by bcp_GetBCLSlice(), deleted if the list is modified
+  unsigned mod_cnt;     // modification counter, incremented by bcp_InvalidateBCLSlice() and bcp_UpdateBCLSignature()
+  void *map_addr;       // if not NULL, "list" points into this file mapping of map_size bytes, see bcp_NewBCLByBinaryFile()
+  size_t map_size;
+  int arena_depth;      // arena lists: frame depth at creation, the list can only grow while this frame is the innermost frame
+  uint8_t is_arena;     // the bcl has been created inside a bcl arena frame: struct, list, sig and flags are part of the arena
+  uint8_t is_sig;       // "sig" is valid for all cubes, set by bcp_GetBCLSignature(), cleared by bcp_InvalidateBCLSlice()
 };
 
+/* 
+  bit sliced (transposed) view of a bcl 
+  For each variable there are two bitplanes with one bit per cube: 
+    plane[(2*var_pos)*word_cnt]: bit 0 of the variable code (set for zero and don't care)
+    plane[(2*var_pos+1)*word_cnt]: bit 1 of the variable code (set for one and don't care)
+  The bit for cube i is at word i/64, bit i%64.
+  The deleted flags are not part of the view, they are taken from the bcl during each query.
+*/
+struct bcs_struct
+{
+  int cnt;              // number of cubes in the view (l->cnt at the time of creation)
+  unsigned mod_cnt;     // l->mod_cnt at the time of creation, the view is outdated if l->mod_cnt differs
+  int word_cnt;         // number of uint64_t per plane, multiple of 2 so that __m128i can be used
+  uint64_t *plane;      // 2*var_cnt planes with word_cnt words each
+  uint64_t *valid;      // one more plane: bit is set if the cube does not contain any illegal variable (points into "plane")
+};
+
+/* 
+  binate split table, created by bcp_NewBCT() and filled by bcp_CalcBCLBinateSplitVariableTable()
+  contains 8 counter cubes for the number of zeros and 8 counter cubes for the number of ones for each variable 
+*/
+struct bct_struct
+{
+  int cnt;              // number of cubes, which are counted in the table
+  __m128i *zero_cnt;    // 8*blk_cnt blocks: counter cube k starts at zero_cnt + k*blk_cnt
+  __m128i *one_cnt;     // 8*blk_cnt blocks, allocated together with zero_cnt
+};
+
+/* cubes limit for the incremental update of a bct: above this limit the 16 bit counters might be saturated */
+#define BCT_INCREMENTAL_MAX_CNT 32000
+
 /* boolean cube expression */
 #define BCX_TYPE_NONE 0
 #define BCX_TYPE_ID 1
@@ -106,8 +357,9 @@ struct bcx_struct
 int bcp_GetVarCntFromString(const char *s);
 
 bcp bcp_New(size_t var_cnt);
+bcp bcp_NewContext(bcp p);      // create a new execution context for the problem of "p", must be deleted with bcp_Delete() before the problem is deleted
 int bcp_UpdateFromBCX(bcp p);
-void bcp_Delete(bcp p);
+void bcp_Delete(bcp p);         // delete a problem or a context
 //bc bcp_GetGlobalCube(bcp p, int pos);
 #define bcp_GetGlobalCube(p, pos) \
   bcp_GetBCLCube((p), (p)->global_cube_list, (pos))  
@@ -115,6 +367,9 @@ void bcp_CopyGlobalCube(bcp p, bc r, int pos);
 void bcp_StartCubeStackFrame(bcp p);
 void bcp_EndCubeStackFrame(bcp p);
 bc bcp_GetTempCube(bcp p);
+void bcp_StartBCLArenaFrame(bcp p);     // all bcl's created until bcp_EndBCLArenaFrame() are allocated from the arena of the context
+void bcp_EndBCLArenaFrame(bcp p);       // release the memory of all bcl's created since bcp_StartBCLArenaFrame()
+void *bcp_ResizeBCLArenaMemory(bcp p, void *ptr, size_t old_size, size_t size); // allocate or extend memory in the current arena frame
 
 /* bcube.c */
 /* core functions */
@@ -129,22 +384,50 @@ void bcp_SetCubeVar(bcp p, bc c, unsigned var_pos, unsigned value);
 #define bcp_GetCubeVar(p, c, var_pos) \
   ((((uint16_t *)(c))[(var_pos)/8] >> (((var_pos)&7)*2)) & 3)
 
-const char *bcp_GetStringFromCube(bcp p, bc c);
+const char *bcp_GetStringFromCube(bcp p, bc c);        // uses the string buffer of the context
+char *bcp_GetStringFromCubeBuffer(bcp p, bc c, char *s);       // "s" must have space for var_cnt+1 chars, returns "s"
+void bcp_SetCubeByStringRange(bcp p, bc c, const char **s, const char *end);  // "end" points to the '\0' of the string
 void bcp_SetCubeByStringPointer(bcp p, bc c,  const char **s);
 void bcp_SetCubeByString(bcp p, bc c, const char *s);
 
+/* simd kernel selection */
+
+int bcp_GetSIMDLevel(int blk_cnt);      // return the SIMD level, supported by the CPU and useful for the given number of blocks
+int bcp_GetSIMDBlkCnt(int simd_level);  // number of __m128i blocks processed at once: 1, 2 or 4
+void bcp_SetCubeFunctions(bcp p);       // assign the cube kernels according to p->simd_level
+
 /* boolean functions */
 
 int bcp_IsTautologyCube(bcp p, bc c);
 void bcp_GetVariableMask(bcp p, bc mask, bc c);
 int bcp_IsAndZero(bcp p, bc a, bc b);           // check if the bitwise AND is zero, should be used together with bcp_GetVariableMask()
-unsigned bcp_OrBitCnt(bcp p, bc r, bc a, bc b);
-int bcp_IntersectionCube(bcp p, bc r, bc a, bc b); // returns 0, if there is no intersection
-int bcp_IsIntersectionCube(bcp p, bc a, bc b); // returns 0, if there is no intersection
+//unsigned bcp_OrBitCnt(bcp p, bc r, bc a, bc b);
+#define bcp_OrBitCnt(p, r, a, b) \
+  (bcp_IncStat((p), BCP_STAT_OR_BIT_CNT), (p)->or_bit_cnt((p), (r), (a), (b)))
+//int bcp_IntersectionCube(bcp p, bc r, bc a, bc b); // returns 0, if there is no intersection
+#define bcp_IntersectionCube(p, r, a, b) \
+  (bcp_IncStat((p), BCP_STAT_INTERSECTION_CUBE), (p)->intersection_cube((p), (r), (a), (b)))
+//int bcp_IsIntersectionCube(bcp p, bc a, bc b); // returns 0, if there is no intersection
+#define bcp_IsIntersectionCube(p, a, b) \
+  (bcp_IncStat((p), BCP_STAT_IS_INTERSECTION_CUBE), (p)->is_intersection_cube((p), (a), (b)))
 int bcp_IsIllegal(bcp p, bc c);                                 // check whether "c" contains "00" codes
 int bcp_GetCubeVariableCount(bcp p, bc cube);   // return the number of 01 or 10 codes in "cube"
-int bcp_GetCubeDelta(bcp p, bc a, bc b);                // calculate the delta between a and b
-int bcp_IsSubsetCube(bcp p, bc a, bc b);                // is "b" is a subset of "a"
+//int bcp_GetCubeDelta(bcp p, bc a, bc b);                // calculate the delta between a and b
+#define bcp_GetCubeDelta(p, a, b) \
+  (bcp_IncStat((p), BCP_STAT_CUBE_DELTA), (p)->get_cube_delta((p), (a), (b)))
+//int bcp_IsSubsetCube(bcp p, bc a, bc b);                // is "b" is a subset of "a"
+#define bcp_IsSubsetCube(p, a, b) \
+  (bcp_IncStat((p), BCP_STAT_IS_SUBSET_CUBE), (p)->is_subset_cube((p), (a), (b)))
+
+/* 
+  64 bit cube signature: the inverted cube with all 64 bit words folded by OR, so variable v 
+  is at bit 2*(v%32) (zero is excluded) and bit 2*(v%32)+1 (one is excluded).
+  The signature tests below never give a wrong answer, they only decide a part of all cube pairs.
+*/
+uint64_t bcp_GetCubeSignature(bcp p, bc c);
+#define bcp_IsSignatureSubsetPossible(sa, sb) (((sa) & ~(sb)) == 0)     // returns 0, if "b" can not be a subset of "a"
+#define bcp_IsSignatureIntersectionSure(sa, sb) \
+  (((((sa)|(sb)) & (((sa)|(sb)) >> 1)) & 0x5555555555555555ULL) == 0)  // returns 1, if "a" and "b" do intersect (delta is 0)
 
 /* bclcore.c */
 
@@ -154,6 +437,8 @@ bcl bcp_NewBCL(bcp p);          // create new empty bcl
 bcl bcp_NewBCLByBCL(bcp p, bcl l);      // create a new bcl as a copy of an existing bcl
 bcl bcp_NewBCLWithCube(bcp p, int global_cube_pos); // creare new bcl and copy one cube from global cube list into it
 int bcp_CopyBCL(bcp p, bcl a, bcl b);   // copy content from bcl b into bcl a, return 0 for error
+int bcp_MoveBCL(bcp p, bcl a, bcl b);   // move the content of bcl b into bcl a, b is empty afterwards, return 0 for error
+int bcp_SwapBCL(bcp p, bcl a, bcl b);   // exchange the content of a and b, return 0 for error
 void bcp_ClearBCL(bcp p, bcl l);
 void bcp_DeleteBCL(bcp p, bcl l);
 int bcp_ExtendBCL(bcp p, bcl l);
@@ -166,6 +451,10 @@ int bcp_IsPurgeUsefull(bcp p, bcl l);
 void bcp_PurgeBCL(bcp p, bcl l);               /* purge deleted cubes */
 int bcp_AddBCLCube(bcp p, bcl l); // add empty cube to list l, returns the position of the new cube or -1 in case of error
 int bcp_AddBCLCubeByCube(bcp p, bcl l, bc c); // append cube c to list l, returns the position of the new cube or -1 in case of error
+uint64_t *bcp_GetBCLSignature(bcp p, bcl l);   // return the signatures of all cubes, calculated if required (not MT-safe)
+void bcp_UpdateBCLSignature(bcp p, bcl l, int pos);     // update the signature after cube "pos" has been modified directly
+int bcp_ReserveBCL(bcp p, bcl l, int cnt);      // allocate memory for at least "cnt" cubes in "l", returns 0 on error
+int bcp_ShrinkBCL(bcp p, bcl l);        // release unused memory of "l", returns 0 on error
 int bcp_AddBCLCubesByBCL(bcp p, bcl a, bcl b); // append cubes from b to a, does not do any simplification, returns 0 on error
 int bcp_AddBCLCubesByString(bcp p, bcl l, const char *s); // add cube(s) described as a string, returns 0 in case of error
 
@@ -174,24 +463,73 @@ bcl bcp_NewBCLByString(bcp p, const char *s);   // create a bcl from a CR seprat
 
 int *bcp_GetBCLVarCntList(bcp p, bcl l);
 
+/* bclslice.c */
+
+bcs bcp_GetBCLSlice(bcp p, bcl l);              // return the bit sliced view of "l", the view is created if required, returns NULL for memory error
+void bcp_InvalidateBCLSlice(bcp p, bcl l);      // delete the bit sliced view, must be called if cubes of "l" are modified directly
+int bcp_GetBCLSliceIntersectionMask(bcp p, bcl l, bc c, uint64_t *mask);        // mask of all cubes in "l", which intersect with "c", returns 0 if there is no such cube
+int bcp_GetBCLSliceSubsetMask(bcp p, bcl l, bc c, uint64_t *mask);      // mask of all cubes in "l", which are a subset of "c", returns 0 if there is no such cube
+int bcp_AndBCLSliceSubsetMask(bcp p, bcs s, bc c, uint64_t *mask);      // keep only those cubes in "mask", which are a subset of "c", returns 0 if "mask" becomes empty
+
+/* bcltruthtable.c */
+
+#define BCP_TRUTH_TABLE_MAX_VAR_CNT 16
+int bcp_GetTruthTableWordCnt(int var_cnt);      // number of uint64_t words for a truth table with "var_cnt" variables
+int bcp_GetCubeActiveVariables(bcp p, bc c, int *var_pos, int max_cnt);       // "c" is the AND of all cubes, returns max_cnt+1 if there are more than max_cnt active variables
+int bcp_GetBCLActiveVariables(bcp p, bcl l, bcl m, int *var_pos, int max_cnt);        // active variables of "l" and "m" ("m" can be NULL)
+void bcp_GetBCLTruthTable(bcp p, bcl l, const int *var_pos, int var_cnt, uint64_t *tt);
+int bcp_IsTruthTableTautology(const uint64_t *tt, int var_cnt);
+int bcp_AddBCLCubesByTruthTable(bcp p, bcl r, const uint64_t *tt, const int *var_pos, int var_cnt);  // add an irredundant cover of "tt", returns 0 for memory error
+bcl bcp_NewBCLComplementWithTruthTable(bcp p, bcl l);   // returns NULL for memory error or if "l" has too many active variables
+int bcp_IsBCLSubsetWithTruthTable(bcp p, bcl a, bcl b); // is "b" a subset of "a", returns -1 for memory error or if there are too many active variables
+
 /* bcldimacscnf.c */
 
+bcd bcp_NewBCD(FILE *fp, size_t buffer_size);   // reads the header, buffer_size 0: use mmap if possible
+bcd bcp_NewBCDByName(const char *name);         // "-" for stdin
+void bcp_DeleteBCD(bcd d);
+bcp bcp_NewByBCD(bcd d);
+int bcp_AddBCLCubesByBCD(bcp p, bcl l, bcd d);
+bcl bcp_NewBCLByBCD(bcp p, bcd d);      // create a bcl from the clauses of the reader
+
 bcp bcp_NewByDIMACSCNF(FILE *fp);
 bcl bcp_NewBCLByDIMACSCNF(bcp p, FILE *fp);   // create a bcl from a DIMACS CNF
 
+/* bclpla.c */
+
+bcf bcp_NewBCFByPLA(FILE *fp);  // read a PLA, returns NULL for memory or syntax error
+bcf bcp_NewBCFByPLAName(const char *name);      // "-" for stdin
+void bcp_DeleteBCF(bcf f);
+int bcp_IsBCFCubeOutput(bcf f, bc c, int out);  // does cube "c" of f->p cover output "out"
+bcl bcp_NewBCLDCByBCF(bcf f);   // explicit don't cares and all points, which do not belong to exactly one output
+int bcp_MinimizeBCF(bcf f);     // minimize all outputs in one run, returns 0 for memory error
+bcl bcp_NewBCLByBCFOutput(bcf f, bcl l, int out);       // cubes of "l" for output "out" with "-" for all output variables
+int bcp_WriteBCFPLA(bcf f, FILE *fp);   // write on-set and don't care set, returns 0 for write error
+int bcp_WriteBCLPLA(bcp p, bcl l, FILE *fp);    // write "l" as single output PLA, returns 0 for write error
+
+/* bclbinary.c */
+
+int bcp_SaveBCLBinaryFile(bcp p, bcl l, const char *name);     // write the valid cubes and the variable names of "p", returns 0 for error
+bcp bcp_NewByBinaryFile(const char *name);      // new problem with the number of variables and the names from the file
+bcl bcp_NewBCLByBinaryFile(bcp p, const char *name);       // map the cubes of the file into a new list without copy, returns NULL for error
 
 /* bccofactor.c */
 
-void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l);
-int bcp_GetBCLMaxBinateSplitVariableSimple(bcp p, bcl l);
-int bcp_GetBCLMaxBinateSplitVariable(bcp p, bcl l);
+bct bcp_NewBCT(bcp p);
+void bcp_DeleteBCT(bcp p, bct t);
+void bcp_CopyBCT(bcp p, bct a, bct b);
+void bcp_SubtractBCT(bcp p, bct a, bct b);
+void bcp_CalcBCLBinateSplitVariableTable(bcp p, bct t, bcl l);
+int bcp_GetBCLMaxBinateSplitVariableSimple(bcp p, bct t, bcl l);
+int bcp_GetBCLMaxBinateSplitVariable(bcp p, bct t, bcl l);
 int bcp_IsBCLVariableDC(bcp p, bcl l, unsigned var_pos);
 int bcp_IsBCLVariableUnate(bcp p, bcl l, unsigned var_pos, unsigned value);
 void bcp_DoBCLOneVariableCofactor(bcp p, bcl l, unsigned var_pos, unsigned value);
 bcl bcp_NewBCLCofacterByVariable(bcp p, bcl l, unsigned var_pos, unsigned value);       // create a new list, which is the cofactor from "l"
+bcl bcp_NewBCLCofacterByVariableWithBCT(bcp p, bcl l, bct t, bct ct, unsigned var_pos, unsigned value);    // same, also derive the table "ct" for the new list from the table "t" of "l"
 void bcp_DoBCLCofactorByCube(bcp p, bcl l, bc c, int exclude);         
 bcl bcp_NewBCLCofactorByCube(bcp p, bcl l, bc c, int exclude);          // don't use this fn, use bcp_IsBCLCubeRedundant() or bcp_IsBCLCubeCovered() instead
-int bcp_IsBCLUnate(bcp p);  // requires call to bcp_CalcBCLBinateSplitVariableTable
+int bcp_IsBCLUnate(bcp p, bct t);  // requires call to bcp_CalcBCLBinateSplitVariableTable
 
 
 /* bclcontainment.c */
@@ -200,13 +538,37 @@ void bcp_DoBCLSingleCubeContainment(bcp p, bcl l);
 int bcp_IsBCLCubeCovered(bcp p, bcl l, bc c);           // is cube c a subset of l (is cube c covered by l)
 int bcp_IsBCLCubeRedundant(bcp p, bcl l, int pos);      // is the cube at pos in l covered by all other cubes in l
 void bcp_DoBCLMultiCubeContainment(bcp p, bcl l);
+void bcp_DoBCLMultiCubeContainmentParallel(bcp p, bcl l, int thread_cnt);      // same result as bcp_DoBCLMultiCubeContainment(), but uses "thread_cnt" threads
 
 
 /* bcltautology.c */
 
-int bcp_is_bcl_partition(bcp p, bcl l);
+#define BCP_MAX_PARTITION_CNT 255
+int bcp_GetBCLPartition(bcp p, bcl l);         // write the partition index into the flags of "l", returns the number of independent partitions
+int bcp_NewBCLsByPartition(bcp p, bcl l, int k, bcl *f);       // create one list for each partition, clear the flags of "l", returns 0 for memory error
+int bcp_is_bcl_partition(bcp p, bcl l);         // two way partition: flag 0 for the first partition, flag 1 for all others
+bcl bcp_NewBCLByFlag(bcp p, bcl l, uint8_t flag);
+int bcp_IsBCLTautologySub(bcp p, bcl l, bct t, int depth, int is_2nd);  // "t" is the binate split table of "l" or NULL
+int bcp_IsBCLTautologyRecursion(bcp p, bcl l, bct t, int depth, int is_2nd);  // same as bcp_IsBCLTautologySub(), but without the cache lookup for "l"
 
 int bcp_IsBCLTautology(bcp p, bcl l);
+void bcp_ShowTautologyLeafStatistics(bcp p);
+
+/* bcltautologycache.c */
+
+int bcp_EnableTautologyCache(bcp p, size_t mem_budget, int min_cnt);   // enable the cache for the current context, returns 0 for memory error
+void bcp_DisableTautologyCache(bcp p);          // disable and delete the cache of the current context
+void bcp_ClearTautologyCache(bcp p);            // remove all entries, the counters are not modified
+int bcp_IsBCLTautologyWithCache(bcp p, bcl l, bct t, int depth, int is_2nd);   // used by bcp_IsBCLTautologySub()
+void bcp_ShowTautologyCacheStatistics(bcp p);
+
+/* bcltautologymt.c */
+
+int bcp_IsBCLTautologyParallel(bcp p, bcl l, int thread_cnt);   // multi threaded version of bcp_IsBCLTautology(), returns -1 for error
+int bcp_IsTautologyCancel(bcp p);               // returns 1 if the current scope of the worker of "p" has been canceled
+void bcp_StartTautologyScope(bcp p, struct bcp_taut_scope_struct *scope);     // start a new scope for an independent partition
+int bcp_EndTautologyScope(bcp p, struct bcp_taut_scope_struct *scope, int result);    // returns 0 if the scope was canceled, otherwise "result"
+int bcp_IsBCLTautologyCofactorMT(bcp p, bcl l, bct t, int var_pos, int depth);        // used by bcp_IsBCLTautologyRecursion(), returns -1 if not distributed
 
 
 /* bclsubtract.c */
@@ -218,14 +580,15 @@ int bcp_SubtractBCL(bcp p, bcl a, bcl b, int is_mcc);  // if is_mcc is 0, then t
 
 bcl bcp_NewBCLComplementWithSubtract(bcp p, bcl l);  // faster than with cofactor
 bcl bcp_NewBCLComplementWithCofactor(bcp p, bcl l); // slow!
-bcl bcp_NewBCLComplement(bcp p, bcl l);         // calls bcp_NewBCLComplementWithSubtract();
+bcl bcp_NewBCLComplementWithURP(bcp p, bcl l);  // unate recursive paradigm, faster than subtract for binate lists
+bcl bcp_NewBCLComplement(bcp p, bcl l);         // calls bcp_NewBCLComplementWithSubtract() for unate and bcp_NewBCLComplementWithURP() for binate lists
 
 
 /* bclsubset.c */
 
 int bcp_IsBCLSubsetWithCofactor(bcp p, bcl a, bcl b);   //   test, whether "b" is a subset of "a", returns 1 if this is the case
 int bcp_IsBCLSubsetWithSubtract(bcp p, bcl a, bcl b);  // this fn seems to be much slower than bcp_IsBCLSubsetWithCofactor
-int bcp_IsBCLSubset(bcp p, bcl a, bcl b);       //   test, whether "b" is a subset of "a", calls bcp_IsBCLSubsetWithCofactor()
+int bcp_IsBCLSubset(bcp p, bcl a, bcl b);       //   test, whether "b" is a subset of "a", calls bcp_IsBCLSubsetWithTruthTable() or bcp_IsBCLSubsetWithCofactor()
 int bcp_IsBCLEqual(bcp p, bcl a, bcl b);                // checks whether the two lists are equal
 
 
@@ -242,7 +605,13 @@ void bcp_DoBCLExpandWithCofactor(bcp p, bcl l);
 
 /* bclminimize.c */
 
-void bcp_MinimizeBCL(bcp p, bcl l);
+#define BCL_MINIMIZE_DEFAULT_LOOP_CNT 20
+int bcp_DoBCLReduce(bcp p, bcl l);      // reduce each cube as far as possible without changing the function, returns 0 for memory error
+void bcp_MinimizeBCLWithOffSet(bcp p, bcl l);    // single pass: complement, expand, irredundant
+int bcp_MinimizeBCLWithOffSetBudget(bcp p, bcl l, bcl off, int max_loop_cnt, long max_msec);  // same as below, but with a given off-set, "l" may contain don't cares
+int bcp_MinimizeBCLWithBudget(bcp p, bcl l, int max_loop_cnt, long max_msec);  // reduce/expand/irredundant loop, 0 for no limit
+void bcp_MinimizeBCL(bcp p, bcl l);     // bcp_MinimizeBCLWithBudget() with BCL_MINIMIZE_DEFAULT_LOOP_CNT
+int bcp_MinimizeBCLWithDC(bcp p, bcl l, bcl dc, bcl off);      // minimize "l" with the don't cares "dc", "off" can be NULL, returns 0 for memory error
 void bcp_MinimizeBCLWithOnSet(bcp p, bcl l);
 
 /* bcexpression.c */
@@ -255,9 +624,9 @@ int bcp_get_value(bcp p, const char **s);
 bcx bcp_NewBCX(bcp p);
 void bcp_DeleteBCX(bcp p, bcx x);
 
-//int bcp_AddVar(bcp p, const char *s);
+int bcp_AddVar(bcp p, const char *s);  // add a variable name to p->var_map, also used by bcp_NewByBinaryFile()
 //int bcp_AddVarsFromBCX(bcp p, bcx x);
-//int bcp_BuildVarList(bcp p);
+int bcp_BuildVarList(bcp p);     // called by bcp_GetExpressionBCL() and bcp_NewContext()
 
 bcx bcp_Parse(bcp p, const char *s, int is_not_propagation);
 
@@ -267,17 +636,88 @@ void bcp_PrintBCX(bcp p, bcx x);
 bcl bcp_NewBCLByBCX(bcp p, bcx x);
 
 char *bcp_GetExpressionBCL(bcp p, bcl l);       // convert "l" to a human readable expression, return value must be free'd if not NULL
+int bcp_WriteExpressionBCL(bcp p, bcl l, FILE *fp);     // write the expression of "l" to "fp", returns 0 for error
+
+
+/* bcstat.c */
+
+#if BCP_STAT
+#define bcp_IncStat(p, idx) ((void)((p)->stat.cnt[idx]++))
+#define bcp_AddStat(p, idx, n) ((void)((p)->stat.cnt[idx] += (n)))
+#define bcp_UpdateStatDepth(p, depth) \
+  ((void)((p)->stat.tautology_max_depth < (depth) ? ((p)->stat.tautology_max_depth = (depth)) : 0))
+#define bcp_StartStatOp(p, op) bcp_StartStatOpTimer((p), (op))
+#define bcp_EndStatOp(p, op) bcp_EndStatOpTimer((p), (op))
+#else
+#define bcp_IncStat(p, idx) ((void)0)
+#define bcp_AddStat(p, idx, n) ((void)(n))
+#define bcp_UpdateStatDepth(p, depth) ((void)0)
+#define bcp_StartStatOp(p, op) ((void)0)
+#define bcp_EndStatOp(p, op) ((void)0)
+#endif
+
+double bcp_GetStatTime(void);   // monotonic wall clock time in seconds
+void bcp_ClearStat(bcp p);      // clear the statistics and the tautology leaf counters of the context
+void bcp_AddStatByContext(bcp p, bcp c); // add the statistics of context "c" to "p"
+void bcp_StartStatOpTimer(bcp p, int op);       // use bcp_StartStatOp()
+void bcp_EndStatOpTimer(bcp p, int op);         // use bcp_EndStatOp()
+void bcp_ShowStat(bcp p);
+co bcp_NewStatMap(bcp p);       // map with all statistics of "p", returns NULL for memory error
 
 
 /* bcjson.c */
 
-int bc_ExecuteJSON(FILE *fp);
+bcj bc_NewBCJ(int slot_cnt);    // returns NULL for memory error
+void bc_DeleteBCJ(bcj j);
+co bc_ExecuteBCJ(bcj j, cco in, int thread_cnt);        // execute the json command vector with the slots of "j", returns the output map or NULL for memory error
+int bc_ExecuteVector(cco in, int slot_cnt, int thread_cnt, FILE *out);  // execute the json command vector, independent commands are executed by "thread_cnt" threads
+int bc_ExecuteJSON(FILE *fp, int slot_cnt, int thread_cnt);      // read the json command vector from "fp" and write the result to stdout
+
+/* bcserver.c */
+
+int bc_ExecuteServer(FILE *in, FILE *out, int slot_cnt, int thread_cnt);       // execute one json request per line of "in", the problems are kept between the requests
+
+
+
+/* bcbench.c */
 
+#define BC_BENCH_DEFAULT_REP_CNT 7
+#define BC_BENCH_DEFAULT_TOLERANCE 0.10
 
+co bc_NewBenchMap(int rep_cnt, char **file_list, int file_cnt);        // run all benchmarks, returns the result map or NULL for memory error
+int bc_CompareBench(cco result, cco baseline, double tolerance, FILE *out);   // returns the number of regressions
+int bc_ExecuteBench(int rep_cnt, char **file_list, int file_cnt, const char *out_name, const char *baseline_name, double tolerance);  // returns the number of regressions or -1 for error
 
 /* bcselftest.c */
 
 bcl bcp_NewBCLWithRandomTautology(bcp p, int size, int dc2one_conversion_cnt);
+void cubeKernelTest(int var_cnt);
+void sliceTest(int var_cnt);
+void signatureTest(int var_cnt);
+void sccTest(int var_cnt);
+void arenaTest(int var_cnt);
+void reserveTest(int var_cnt);
+void moveTest(int var_cnt);
+void urpComplementTest(int var_cnt);
+void tautologyCacheTest(int var_cnt);
+void tautologyLeafTest(int var_cnt);
+void truthTableTest(int var_cnt);
+void partitionTest(int var_cnt);
+void dimacsCNFTest(int var_cnt);
+void plaTest(int in_cnt, int out_cnt, const char *type);
+void binaryBCLTest(int var_cnt);
+void stringConversionTest(int var_cnt);
+void expressionOutputTest(int var_cnt);
+void expandTest(int var_cnt);
+void reduceMinimizeTest(int var_cnt);
+void intersectionTest(int var_cnt);
+void splitTableTest(int var_cnt);
+void parallelTautologyTest(int var_cnt);
+void contextTest(int var_cnt);
+void parallelMCCTest(int var_cnt);
+void jsonTest(int slot_cnt);
+void serverTest(void);
+void statTest(int var_cnt);
 void internalTest(int var_cnt);
 void speedTest(int var_cnt);
 void minimizeTest(int cnt);
@@ -0,0 +1,395 @@
+/*
+
+  bcbench.c
+
+  reproducible benchmarks, see the "bench" target of the Makefile
+
+  All random lists are created after srand(BC_BENCH_SEED), so each run measures the same
+  input. Each benchmark is executed rep_cnt times with a fresh copy of its first input list,
+  the copy is not part of the measured time. The result is a map with one member per benchmark:
+    { "tautology_16_400": { "cnt":400, "rep":7, "min":0.108, "median":0.110, "cubes_per_sec":3636, "result":1 }, ... }
+  "cnt" is the number of input cubes, "cubes_per_sec" is cnt/median, "result" is the value
+  returned by the operation (tautology/subset flag or the number of result cubes).
+
+  The files of the corpus are listed by their name, a DIMACS CNF file is checked for
+  tautology (same as the -dimacscnf option). All outputs of a ".pla" file are minimized
+  together (same as the -pla option).
+
+  bc_CompareBench() compares the median of each benchmark with the median of the same
+  benchmark of a previous result (the baseline). A benchmark is a regression, if it is slower
+  than the baseline by more than the tolerance or if the result differs from the baseline.
+
+*/
+
+#include "co.h"
+#include "bc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BC_BENCH_SEED 1
+
+/* one measured operation, "a" is a private copy, which can be modified, returns -1 for memory error */
+typedef int (*bc_bench_fn)(bcp p, bcl a, bcl b);
+
+static int bc_BenchTautology(bcp p, bcl a, bcl b)
+{
+  return bcp_IsBCLTautology(p, a);
+}
+
+static int bc_BenchComplement(bcp p, bcl a, bcl b)
+{
+  int cnt;
+  bcl l = bcp_NewBCLComplement(p, a);
+  if ( l == NULL )
+    return -1;
+  cnt = l->cnt;
+  bcp_DeleteBCL(p, l);
+  return cnt;
+}
+
+static int bc_BenchSubset(bcp p, bcl a, bcl b)
+{
+  return bcp_IsBCLSubset(p, a, b);
+}
+
+static int bc_BenchIntersection(bcp p, bcl a, bcl b)
+{
+  int cnt;
+  bcl l = bcp_NewBCL(p);
+  if ( l == NULL )
+    return -1;
+  if ( bcp_IntersectionBCLs(p, l, a, b) == 0 )
+    return bcp_DeleteBCL(p, l), -1;
+  cnt = l->cnt;
+  bcp_DeleteBCL(p, l);
+  return cnt;
+}
+
+static int bc_BenchMinimize(bcp p, bcl a, bcl b)
+{
+  bcp_MinimizeBCL(p, a);
+  return a->cnt;
+}
+
+/* "b" is the don't care set */
+static int bc_BenchMinimizeWithDC(bcp p, bcl a, bcl b)
+{
+  if ( bcp_MinimizeBCLWithDC(p, a, b, NULL) == 0 )
+    return -1;
+  return a->cnt;
+}
+
+static int bc_CompareTime(const void *a, const void *b)
+{
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+  if ( x < y )
+    return -1;
+  if ( x > y )
+    return 1;
+  return 0;
+}
+
+/*
+  measure "fn" and add the times as member "name" to "result"
+  "cnt" is the number of input cubes for cubes_per_sec
+  returns 0 for memory error
+*/
+static int bc_AddBench(co result, const char *name, bc_bench_fn fn, bcp p, bcl a, bcl b, int cnt, int rep_cnt)
+{
+  double *t = (double *)malloc(sizeof(double)*rep_cnt);
+  double t0, median;
+  int i;
+  int r = 0;
+  bcl x;
+  co m;
+
+  if ( t == NULL )
+    return 0;
+  for( i = 0; i < rep_cnt; i++ )
+  {
+    x = bcp_NewBCLByBCL(p, a);
+    if ( x == NULL )
+      return free(t), 0;
+    t0 = bcp_GetStatTime();
+    r = fn(p, x, b);
+    t[i] = bcp_GetStatTime() - t0;
+    bcp_DeleteBCL(p, x);
+    if ( r < 0 )
+      return free(t), 0;
+  }
+  qsort(t, rep_cnt, sizeof(double), bc_CompareTime);
+  median = (rep_cnt & 1) ? t[rep_cnt/2] : (t[rep_cnt/2-1] + t[rep_cnt/2])/2.0;
+
+  m = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+  if ( m == NULL )
+    return free(t), 0;
+  coMapAdd(m, "cnt", coNewDbl(cnt));
+  coMapAdd(m, "rep", coNewDbl(rep_cnt));
+  coMapAdd(m, "min", coNewDbl(t[0]));
+  coMapAdd(m, "median", coNewDbl(median));
+  coMapAdd(m, "cubes_per_sec", coNewDbl(median > 0.0 ? (double)cnt/median : 0.0));
+  coMapAdd(m, "result", coNewDbl(r));
+  coMapAdd(result, name, m);
+  fprintf(stderr, "bench %s cnt=%d min=%.6f median=%.6f result=%d\n", name, cnt, t[0], median, r);
+  free(t);
+  return 1;
+}
+
+/* tautology check of a random tautology, the recursion depth grows fast with "size" */
+static int bc_AddTautologyBench(co result, int var_cnt, int size, int rep_cnt)
+{
+  char name[64];
+  int is_ok;
+  bcl l;
+  bcp p = bcp_New(var_cnt);
+  if ( p == NULL )
+    return 0;
+  srand(BC_BENCH_SEED);
+  l = bcp_NewBCLWithRandomTautology(p, size, 0);
+  is_ok = l != NULL;
+  if ( is_ok )
+  {
+    sprintf(name, "tautology_%d_%d", var_cnt, size);
+    is_ok = bc_AddBench(result, name, bc_BenchTautology, p, l, NULL, l->cnt, rep_cnt);
+    bcp_DeleteBCL(p, l);
+  }
+  bcp_Delete(p);
+  return is_ok;
+}
+
+/* the intersection of two random lists is used for the complement, subset and minimize benchmark (see also speedTest()) */
+static int bc_AddListBench(co result, int var_cnt, int rep_cnt)
+{
+  char name[64];
+  int is_ok;
+  bcl a, b, ic, mc = NULL;
+  bcp p = bcp_New(var_cnt);
+  if ( p == NULL )
+    return 0;
+  srand(BC_BENCH_SEED);
+  a = bcp_NewBCLWithRandomTautology(p, var_cnt+2, var_cnt);
+  b = bcp_NewBCLWithRandomTautology(p, var_cnt+2, var_cnt);
+  ic = bcp_NewBCL(p);
+  is_ok = a != NULL && b != NULL && ic != NULL && bcp_IntersectionBCLs(p, ic, a, b) != 0;
+  if ( is_ok )
+  {
+    mc = bcp_NewBCLByBCL(p, ic);        // minimized intersection for the complement and subset benchmark
+    is_ok = mc != NULL;
+  }
+  if ( is_ok )
+  {
+    bcp_MinimizeBCL(p, mc);
+    sprintf(name, "intersection_%d", var_cnt);
+    is_ok = bc_AddBench(result, name, bc_BenchIntersection, p, a, b, a->cnt + b->cnt, rep_cnt);
+  }
+  if ( is_ok )
+  {
+    sprintf(name, "complement_%d", var_cnt);
+    is_ok = bc_AddBench(result, name, bc_BenchComplement, p, a, NULL, a->cnt, rep_cnt);
+  }
+  if ( is_ok )
+  {
+    sprintf(name, "complement_ic_%d", var_cnt);
+    is_ok = bc_AddBench(result, name, bc_BenchComplement, p, mc, NULL, mc->cnt, rep_cnt);
+  }
+  if ( is_ok )
+  {
+    sprintf(name, "subset_%d", var_cnt);
+    is_ok = bc_AddBench(result, name, bc_BenchSubset, p, a, mc, a->cnt + mc->cnt, rep_cnt);
+  }
+  if ( is_ok )
+  {
+    sprintf(name, "minimize_%d", var_cnt);
+    is_ok = bc_AddBench(result, name, bc_BenchMinimize, p, ic, NULL, ic->cnt, rep_cnt);
+  }
+  if ( a != NULL )
+    bcp_DeleteBCL(p, a);
+  if ( b != NULL )
+    bcp_DeleteBCL(p, b);
+  if ( ic != NULL )
+    bcp_DeleteBCL(p, ic);
+  if ( mc != NULL )
+    bcp_DeleteBCL(p, mc);
+  bcp_Delete(p);
+  return is_ok;
+}
+
+/* minimize all outputs of a PLA file, the off-set is always calculated (also for the type "fr") */
+static int bc_AddPLABench(co result, const char *name, int rep_cnt)
+{
+  int is_ok;
+  bcl dc;
+  bcf f = bcp_NewBCFByPLAName(name);
+  if ( f == NULL )
+    return fprintf(stderr, "bench %s: PLA read error\n", name), 0;
+  dc = bcp_NewBCLDCByBCF(f);
+  if ( dc == NULL )
+    return bcp_DeleteBCF(f), 0;
+  is_ok = bc_AddBench(result, name, bc_BenchMinimizeWithDC, f->p, f->on, dc, f->on->cnt, rep_cnt);
+  bcp_DeleteBCL(f->p, dc);
+  bcp_DeleteBCF(f);
+  return is_ok;
+}
+
+/* benchmark for one file of the corpus, returns 0 for memory error or if the file can't be read */
+static int bc_AddFileBench(co result, const char *name, int rep_cnt)
+{
+  int is_ok;
+  size_t len = strlen(name);
+  bcd d;
+  bcp p;
+  bcl l;
+  if ( len > 4 && strcmp(name + len - 4, ".pla") == 0 )
+    return bc_AddPLABench(result, name, rep_cnt);
+  d = bcp_NewBCDByName(name);
+  if ( d == NULL )
+    return fprintf(stderr, "bench %s: DIMACS CNF read error\n", name), 0;
+  p = bcp_NewByBCD(d);
+  if ( p == NULL )
+    return bcp_DeleteBCD(d), 0;
+  l = bcp_NewBCLByBCD(p, d);
+  bcp_DeleteBCD(d);
+  if ( l == NULL )
+    return fprintf(stderr, "bench %s: DIMACS CNF clause error\n", name), bcp_Delete(p), 0;
+  is_ok = bc_AddBench(result, name, bc_BenchTautology, p, l, NULL, l->cnt, rep_cnt);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+  return is_ok;
+}
+
+/* run all benchmarks, returns the result map or NULL for memory error or if a file of the corpus can't be read */
+co bc_NewBenchMap(int rep_cnt, char **file_list, int file_cnt)
+{
+  int i;
+  co result = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+  if ( result == NULL )
+    return NULL;
+  if ( rep_cnt <= 0 )
+    rep_cnt = BC_BENCH_DEFAULT_REP_CNT;
+  if ( bc_AddTautologyBench(result, 16, 400, rep_cnt) == 0 )
+    return coDelete(result), NULL;
+  if ( bc_AddTautologyBench(result, 40, 50, rep_cnt) == 0 )
+    return coDelete(result), NULL;
+  if ( bc_AddTautologyBench(result, 200, 34, rep_cnt) == 0 )   // more than one block per cube
+    return coDelete(result), NULL;
+  if ( bc_AddListBench(result, 21, rep_cnt) == 0 )
+    return coDelete(result), NULL;
+  if ( bc_AddListBench(result, 30, rep_cnt) == 0 )
+    return coDelete(result), NULL;
+  for( i = 0; i < file_cnt; i++ )
+    if ( bc_AddFileBench(result, file_list[i], rep_cnt) == 0 )
+      return coDelete(result), NULL;
+  return result;
+}
+
+/* returns the numeric member "key" of the benchmark "b" or -1 */
+static double bc_GetBenchValue(cco b, const char *key)
+{
+  cco v = coMapGet(b, key);
+  if ( v == NULL || coIsDbl(v) == 0 )
+    return -1.0;
+  return coDblGet(v);
+}
+
+/*
+  compare the medians of "result" with "baseline", one line per benchmark is written to "out"
+  benchmarks, which are not part of the baseline, are not compared
+  returns the number of regressions
+*/
+int bc_CompareBench(cco result, cco baseline, double tolerance, FILE *out)
+{
+  coMapIterator iter;
+  const char *name;
+  cco r, b;
+  double median, base_median;
+  int is_slower, is_result_diff;
+  int regression_cnt = 0;
+
+  if ( coMapLoopFirst(&iter, result) )
+  {
+    do
+    {
+      name = coMapLoopKey(&iter);
+      r = coMapLoopValue(&iter);
+      b = coMapGet(baseline, name);
+      if ( b == NULL || coIsMap(b) == 0 )
+      {
+        fprintf(out, "bench %s not in baseline\n", name);
+        continue;
+      }
+      median = bc_GetBenchValue(r, "median");
+      base_median = bc_GetBenchValue(b, "median");
+      is_slower = base_median > 0.0 && median > base_median*(1.0 + tolerance);
+      is_result_diff = bc_GetBenchValue(r, "result") != bc_GetBenchValue(b, "result");
+      fprintf(out, "bench %s median=%.6f baseline=%.6f ratio=%.3f%s%s\n", name, median, base_median,
+        base_median > 0.0 ? median/base_median : 1.0,
+        is_slower ? " regression" : "",
+        is_result_diff ? " result differs" : "");
+      if ( is_slower || is_result_diff )
+        regression_cnt++;
+    } while( coMapLoopNext(&iter) );
+  }
+  return regression_cnt;
+}
+
+/*
+  run all benchmarks and write the result map to "out_name" ("-" or NULL for stdout)
+  if "baseline_name" is not NULL, then compare the result with this previous result file
+  returns the number of regressions or -1 for error
+*/
+int bc_ExecuteBench(int rep_cnt, char **file_list, int file_cnt, const char *out_name, const char *baseline_name, double tolerance)
+{
+  FILE *fp;
+  co baseline = NULL;
+  co result;
+  int regression_cnt = 0;
+
+  if ( baseline_name != NULL )
+  {
+    fp = fopen(baseline_name, "r");
+    if ( fp == NULL )
+      return perror(baseline_name), -1;
+    baseline = coReadJSONByFP(fp);
+    fclose(fp);
+    if ( baseline == NULL )
+      return fprintf(stderr, "bench baseline read error (%s)\n", baseline_name), -1;
+    if ( coIsMap(baseline) == 0 )
+      return fprintf(stderr, "bench baseline read error (%s)\n", baseline_name), coDelete(baseline), -1;
+  }
+
+  result = bc_NewBenchMap(rep_cnt, file_list, file_cnt);
+  if ( result != NULL )
+  {
+    if ( out_name == NULL || strcmp(out_name, "-") == 0 )
+    {
+      coWriteJSON(result, 0, 1, stdout);
+      puts("");
+    }
+    else if ( (fp = fopen(out_name, "w")) != NULL )
+    {
+      coWriteJSON(result, 0, 1, fp);
+      fputc('\n', fp);
+      fclose(fp);
+    }
+    else
+    {
+      perror(out_name);
+      regression_cnt = -1;
+    }
+    if ( regression_cnt >= 0 && baseline != NULL )
+    {
+      regression_cnt = bc_CompareBench(result, baseline, tolerance, stdout);
+      printf("bench regressions: %d\n", regression_cnt);
+    }
+    coDelete(result);
+  }
+  else
+  {
+    regression_cnt = -1;
+  }
+  if ( baseline != NULL )
+    coDelete(baseline);
+  return regression_cnt;
+}
@@ -10,12 +10,105 @@
 */
 
 #include "bc.h"
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 
+/*
+  binate split table
+  For each variable, the table contains the number of zeros and ones in a bcl.
+  The counters are 16 bit signed with saturation, so the table is only exact for lists with less than 32767 cubes.
+  The table is organized as 8 counter cubes for the zeros and 8 counter cubes for the ones:
+  Within block b, the 16 bit word w of the k-th counter cube contains the counter for variable b*64 + w*8 + k.
+*/
+bct bcp_NewBCT(bcp p)
+{
+  bct t = (bct)malloc(sizeof(struct bct_struct));
+  if ( t != NULL )
+  {
+    t->cnt = 0;
+    t->zero_cnt = (__m128i *)malloc(16*p->blk_cnt*sizeof(__m128i));
+    if ( t->zero_cnt != NULL )
+    {
+      t->one_cnt = t->zero_cnt + 8*p->blk_cnt;
+      memset(t->zero_cnt, 0, 16*p->blk_cnt*sizeof(__m128i));
+      return t;
+    }
+    free(t);
+  }
+  return NULL;
+}
+
+void bcp_DeleteBCT(bcp p, bct t)
+{
+  free(t->zero_cnt);
+  free(t);
+}
+
+/* let a be a copy of b */
+void bcp_CopyBCT(bcp p, bct a, bct b)
+{
+  a->cnt = b->cnt;
+  memcpy(a->zero_cnt, b->zero_cnt, 16*p->blk_cnt*sizeof(__m128i));
+}
+
+/* a = a - b, this is used if b contains the table for a subset of the cubes which were counted for a */
+void bcp_SubtractBCT(bcp p, bct a, bct b)
+{
+  int i;
+  for( i = 0; i < 16*p->blk_cnt; i++ )
+    _mm_storeu_si128(a->zero_cnt+i, _mm_sub_epi16(_mm_loadu_si128(a->zero_cnt+i), _mm_loadu_si128(b->zero_cnt+i)));
+  a->cnt -= b->cnt;
+}
+
+static void bcp_GetBCTCubes(bcp p, bct t, bc *zero_cnt_cube, bc *one_cnt_cube)
+{
+  int k;
+  for( k = 0; k < 8; k++ )
+  {
+    zero_cnt_cube[k] = t->zero_cnt + k*p->blk_cnt;
+    one_cnt_cube[k] = t->one_cnt + k*p->blk_cnt;
+  }
+}
+
+/* remove the zeros and ones of cube "c" from the table */
+static void bcp_SubtractBCTCube(bcp p, bct t, bc c)
+{
+  int b, k;
+  __m128i x, m;
+  __m128i mc = _mm_set1_epi16(1);
+  bc zero_cnt_cube[8];
+  bc one_cnt_cube[8];
+
+  bcp_GetBCTCubes(p, t, zero_cnt_cube, one_cnt_cube);
+  for( b = 0; b < p->blk_cnt; b++ )
+  {
+    x = _mm_loadu_si128(c+b);
+    for( k = 0; k < 8; k++ )
+    {
+      /* same bit extraction as in bcp_CalcBCLBinateSplitVariableTable() */
+      m = _mm_andnot_si128(x, mc);
+      _mm_storeu_si128(one_cnt_cube[k]+b, _mm_sub_epi16(_mm_loadu_si128(one_cnt_cube[k]+b), m));
+      x = _mm_srai_epi16(x,1);
+      m = _mm_andnot_si128(x, mc);
+      _mm_storeu_si128(zero_cnt_cube[k]+b, _mm_sub_epi16(_mm_loadu_si128(zero_cnt_cube[k]+b), m));
+      x = _mm_srai_epi16(x,1);
+    }
+  }
+  t->cnt--;
+}
+
+/* clear the counter for "value" (1: zero, 2: one) of the variable at "var_pos" */
+static void bcp_ClearBCTVariable(bcp p, bct t, unsigned var_pos, unsigned value)
+{
+  __m128i *cnt_cube = (value == 1 ? t->zero_cnt : t->one_cnt) + (var_pos & 7)*p->blk_cnt;
+  ((uint16_t *)(cnt_cube + var_pos / 64))[(var_pos & 63)>>3] = 0;
+}
+
 
 /* 16 bit version */
-void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)
+void bcp_CalcBCLBinateSplitVariableTable(bcp p, bct t, bcl l)
 {
 	int i, blk_cnt = p->blk_cnt;
 	int j, list_cnt = l->cnt;
@@ -25,7 +118,7 @@ void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)
 	
 
 	__m128i c;  // current block from the current cube from the list
-	__m128i t;	// temp block
+	__m128i x;	// temp block
 	__m128i oc0, oc1, oc2, oc3, oc4, oc5, oc6, oc7;	// one count
 	__m128i zc0, zc1, zc2, zc3, zc4, zc5, zc6, zc7;	// zero count
 	__m128i mc; // mask cube for the lowest bit in each byte
@@ -41,25 +134,13 @@ void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)
 	mc = _mm_insert_epi16(mc, 1, 6);
 	mc = _mm_insert_epi16(mc, 1, 7);
 
-	/* "misuse" the cubes as SIMD storage area for the counters */
-	zero_cnt_cube[0] = bcp_GetGlobalCube(p, 4);
-	zero_cnt_cube[1] = bcp_GetGlobalCube(p, 5);
-	zero_cnt_cube[2] = bcp_GetGlobalCube(p, 6);
-	zero_cnt_cube[3] = bcp_GetGlobalCube(p, 7);
-	zero_cnt_cube[4] = bcp_GetGlobalCube(p, 8);
-	zero_cnt_cube[5] = bcp_GetGlobalCube(p, 9);
-	zero_cnt_cube[6] = bcp_GetGlobalCube(p, 10);
-	zero_cnt_cube[7] = bcp_GetGlobalCube(p, 11);
-	
-	one_cnt_cube[0] = bcp_GetGlobalCube(p, 12);
-	one_cnt_cube[1] = bcp_GetGlobalCube(p, 13);
-	one_cnt_cube[2] = bcp_GetGlobalCube(p, 14);
-	one_cnt_cube[3] = bcp_GetGlobalCube(p, 15);
-	one_cnt_cube[4] = bcp_GetGlobalCube(p, 16);
-	one_cnt_cube[5] = bcp_GetGlobalCube(p, 17);
-	one_cnt_cube[6] = bcp_GetGlobalCube(p, 18);
-	one_cnt_cube[7] = bcp_GetGlobalCube(p, 19);
-	
+	bcp_GetBCTCubes(p, t, zero_cnt_cube, one_cnt_cube);
+
+	t->cnt = 0;
+	for( j = 0; j < list_cnt; j++ )
+		if ( l->flags[j] == 0 )
+			t->cnt++;
+
 	/* loop over the blocks */
 	for( i = 0; i < blk_cnt; i++ )
 	{
@@ -112,74 +193,74 @@ void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)
 			*/
 			c = _mm_loadu_si128(bcp_GetBCLCube(p, l, j)+i);
 			/* handle variable at bits 0/1 */
-			t = _mm_andnot_si128(c, mc);		// flip the lowerst bit and mask the lowerst bit in each byte: the "10" code for value "one" will become "00000001"
-			oc0 = _mm_adds_epi16(oc0, t);		// sum the "one" value with saturation
+			x = _mm_andnot_si128(c, mc);		// flip the lowerst bit and mask the lowerst bit in each byte: the "10" code for value "one" will become "00000001"
+			oc0 = _mm_adds_epi16(oc0, x);		// sum the "one" value with saturation
 			c = _mm_srai_epi16(c,1);			// shift right to proceed with the "zero" value
-			t = _mm_andnot_si128(c, mc);
-			zc0 = _mm_adds_epi16(zc0, t);
+			x = _mm_andnot_si128(c, mc);
+			zc0 = _mm_adds_epi16(zc0, x);
 			
 			c = _mm_srai_epi16(c,1);			// shift right to process the next variable
 
 			/* handle variable at bits 2/3 */
-			t = _mm_andnot_si128(c, mc);
-			oc1 = _mm_adds_epi16(oc1, t);
+			x = _mm_andnot_si128(c, mc);
+			oc1 = _mm_adds_epi16(oc1, x);
 			c = _mm_srai_epi16(c,1);
-			t = _mm_andnot_si128(c, mc);
-			zc1 = _mm_adds_epi16(zc1, t);
+			x = _mm_andnot_si128(c, mc);
+			zc1 = _mm_adds_epi16(zc1, x);
 
 			c = _mm_srai_epi16(c,1);
 
 			/* handle variable at bits 4/5 */
-			t = _mm_andnot_si128(c, mc);
-			oc2 = _mm_adds_epi16(oc2, t);
+			x = _mm_andnot_si128(c, mc);
+			oc2 = _mm_adds_epi16(oc2, x);
 			c = _mm_srai_epi16(c,1);
-			t = _mm_andnot_si128(c, mc);
-			zc2 = _mm_adds_epi16(zc2, t);
+			x = _mm_andnot_si128(c, mc);
+			zc2 = _mm_adds_epi16(zc2, x);
 
 			c = _mm_srai_epi16(c,1);
 
 			/* handle variable at bits 6/7 */
-			t = _mm_andnot_si128(c, mc);
-			oc3 = _mm_adds_epi16(oc3, t);
+			x = _mm_andnot_si128(c, mc);
+			oc3 = _mm_adds_epi16(oc3, x);
 			c = _mm_srai_epi16(c,1);
-			t = _mm_andnot_si128(c, mc);
-			zc3 = _mm_adds_epi16(zc3, t);
+			x = _mm_andnot_si128(c, mc);
+			zc3 = _mm_adds_epi16(zc3, x);
                         
 			c = _mm_srai_epi16(c,1);
 
 			/* handle variable at bits 8/9 */
-			t = _mm_andnot_si128(c, mc);
-			oc4 = _mm_adds_epi16(oc4, t);
+			x = _mm_andnot_si128(c, mc);
+			oc4 = _mm_adds_epi16(oc4, x);
 			c = _mm_srai_epi16(c,1);
-			t = _mm_andnot_si128(c, mc);
-			zc4 = _mm_adds_epi16(zc4, t);
+			x = _mm_andnot_si128(c, mc);
+			zc4 = _mm_adds_epi16(zc4, x);
                         
 			c = _mm_srai_epi16(c,1);
 
 			/* handle variable at bits 10/11 */
-			t = _mm_andnot_si128(c, mc);
-			oc5 = _mm_adds_epi16(oc5, t);
+			x = _mm_andnot_si128(c, mc);
+			oc5 = _mm_adds_epi16(oc5, x);
 			c = _mm_srai_epi16(c,1);
-			t = _mm_andnot_si128(c, mc);
-			zc5 = _mm_adds_epi16(zc5, t);
+			x = _mm_andnot_si128(c, mc);
+			zc5 = _mm_adds_epi16(zc5, x);
                         
 			c = _mm_srai_epi16(c,1);
 
 			/* handle variable at bits 12/13 */
-			t = _mm_andnot_si128(c, mc);
-			oc6 = _mm_adds_epi16(oc6, t);
+			x = _mm_andnot_si128(c, mc);
+			oc6 = _mm_adds_epi16(oc6, x);
 			c = _mm_srai_epi16(c,1);
-			t = _mm_andnot_si128(c, mc);
-			zc6 = _mm_adds_epi16(zc6, t);
+			x = _mm_andnot_si128(c, mc);
+			zc6 = _mm_adds_epi16(zc6, x);
                         
 			c = _mm_srai_epi16(c,1);
 
 			/* handle variable at bits 14/15 */
-			t = _mm_andnot_si128(c, mc);
-			oc7 = _mm_adds_epi16(oc7, t);
+			x = _mm_andnot_si128(c, mc);
+			oc7 = _mm_adds_epi16(oc7, x);
 			c = _mm_srai_epi16(c,1);
-			t = _mm_andnot_si128(c, mc);
-			zc7 = _mm_adds_epi16(zc7, t);
+			x = _mm_andnot_si128(c, mc);
+			zc7 = _mm_adds_epi16(zc7, x);
                   }  // flag test
 		
                 } // j, list loop
@@ -212,7 +293,7 @@ void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)
 
 /*
   Precondition: call to 
-    void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)  
+    void bcp_CalcBCLBinateSplitVariableTable(bcp p, bct t, bcl l)  
 
   returns the binate variable for which the number of one's plus number of zero's is max under the condition, that both number of once's and zero's are >0 
 
@@ -220,7 +301,7 @@ void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)
 */
 
 /* 16 bit version */
-int bcp_GetBCLMaxBinateSplitVariableSimple(bcp p, bcl l)
+int bcp_GetBCLMaxBinateSplitVariableSimple(bcp p, bct t, bcl l)
 {
   int max_sum_cnt = -1;
   int max_sum_var = -1;
@@ -235,26 +316,8 @@ int bcp_GetBCLMaxBinateSplitVariableSimple(bcp p, bcl l)
   bc zero_cnt_cube[8];
   bc one_cnt_cube[8];
 
-  /* "misuse" the cubes as SIMD storage area for the counters */
-  zero_cnt_cube[0] = bcp_GetGlobalCube(p, 4);
-  zero_cnt_cube[1] = bcp_GetGlobalCube(p, 5);
-  zero_cnt_cube[2] = bcp_GetGlobalCube(p, 6);
-  zero_cnt_cube[3] = bcp_GetGlobalCube(p, 7);
-  zero_cnt_cube[4] = bcp_GetGlobalCube(p, 8);
-  zero_cnt_cube[5] = bcp_GetGlobalCube(p, 9);
-  zero_cnt_cube[6] = bcp_GetGlobalCube(p, 10);
-  zero_cnt_cube[7] = bcp_GetGlobalCube(p, 11);
-  
-  one_cnt_cube[0] = bcp_GetGlobalCube(p, 12);
-  one_cnt_cube[1] = bcp_GetGlobalCube(p, 13);
-  one_cnt_cube[2] = bcp_GetGlobalCube(p, 14);
-  one_cnt_cube[3] = bcp_GetGlobalCube(p, 15);
-  one_cnt_cube[4] = bcp_GetGlobalCube(p, 16);
-  one_cnt_cube[5] = bcp_GetGlobalCube(p, 17);
-  one_cnt_cube[6] = bcp_GetGlobalCube(p, 18);
-  one_cnt_cube[7] = bcp_GetGlobalCube(p, 19);
+  bcp_GetBCTCubes(p, t, zero_cnt_cube, one_cnt_cube);
 
-  
   max_sum_cnt = -1;
   max_sum_var = -1;
   for( i = 0; i < p->var_cnt; i++ )
@@ -283,14 +346,14 @@ int bcp_GetBCLMaxBinateSplitVariableSimple(bcp p, bcl l)
 
 /*
   Precondition: call to 
-    void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l)  
+    void bcp_CalcBCLBinateSplitVariableTable(bcp p, bct t, bcl l)  
 
   returns the binate variable for which the number of one's plus number of zero's is max under the condition, that both number of once's and zero's are >0 
 
   SSE2 Implementation
 */
 /* 16 bit version */
-int bcp_GetBCLMaxBinateSplitVariable(bcp p, bcl l)
+int bcp_GetBCLMaxBinateSplitVariable(bcp p, bct t, bcl l)
 {
   int max_sum_cnt = -1;
   int max_sum_var = -1;
@@ -316,24 +379,7 @@ int bcp_GetBCLMaxBinateSplitVariable(bcp p, bcl l)
   if ( l->cnt == 0 )
     return -1;
 
-  /* "misuse" the cubes as SIMD storage area for the counters */
-  zero_cnt_cube[0] = bcp_GetGlobalCube(p, 4);
-  zero_cnt_cube[1] = bcp_GetGlobalCube(p, 5);
-  zero_cnt_cube[2] = bcp_GetGlobalCube(p, 6);
-  zero_cnt_cube[3] = bcp_GetGlobalCube(p, 7);
-  zero_cnt_cube[4] = bcp_GetGlobalCube(p, 8);
-  zero_cnt_cube[5] = bcp_GetGlobalCube(p, 9);
-  zero_cnt_cube[6] = bcp_GetGlobalCube(p, 10);
-  zero_cnt_cube[7] = bcp_GetGlobalCube(p, 11);
-  
-  one_cnt_cube[0] = bcp_GetGlobalCube(p, 12);
-  one_cnt_cube[1] = bcp_GetGlobalCube(p, 13);
-  one_cnt_cube[2] = bcp_GetGlobalCube(p, 14);
-  one_cnt_cube[3] = bcp_GetGlobalCube(p, 15);
-  one_cnt_cube[4] = bcp_GetGlobalCube(p, 16);
-  one_cnt_cube[5] = bcp_GetGlobalCube(p, 17);
-  one_cnt_cube[6] = bcp_GetGlobalCube(p, 18);
-  one_cnt_cube[7] = bcp_GetGlobalCube(p, 19);
+  bcp_GetBCTCubes(p, t, zero_cnt_cube, one_cnt_cube);
 
   for( b = 0; b < p->blk_cnt; b++ )
   {
@@ -399,7 +445,7 @@ int bcp_GetBCLMaxBinateSplitVariable(bcp p, bcl l)
   
   /*
   {
-    int mv = bcp_GetBCLMaxBinateSplitVariableSimple(p, l);
+    int mv = bcp_GetBCLMaxBinateSplitVariableSimple(p, t, l);
     if ( max_sum_var != mv )
     {
       printf("failed max_sum_var=%d, mv=%d\n", max_sum_var, mv);
@@ -428,9 +474,11 @@ static void bcp_DoBCLSubsetCubeMark(bcp p, bcl l, int pos)
   int j;
   int cnt = l->cnt;
   bc c = bcp_GetBCLCube(p, l, pos);
+  uint64_t *sig = bcp_GetBCLSignature(p, l);
+  uint64_t s = sig[pos];
   for( j = 0; j < cnt; j++ )
   {
-    if ( j != pos && l->flags[j] == 0  )
+    if ( j != pos && l->flags[j] == 0 && bcp_IsSignatureSubsetPossible(s, sig[j]) )
     {
       /*
         test, whether "b" is a subset of "a"
@@ -505,6 +553,15 @@ int bcp_IsBCLVariableUnate(bcp p, bcl l, unsigned var_pos, unsigned value)
   Calculate the cofactor of the given list "l" with respect to the variable at "var_pos" and the given "value".
   "value" must be either 1 (zero) or 2 (one)
   
+  Cubes with the other value (3-value) at "var_pos" become don't care at "var_pos", cubes with 
+  "value" at "var_pos" are removed and don't care cubes are not modified. The result is the 
+  cofactor for "var_pos" = 3-value, it does not depend on "var_pos".
+  A removed cube covers only minterms with "value" at "var_pos". All remaining cubes are don't care
+  at "var_pos", so they cover the same minterms for both values. For this reason the removed cubes 
+  can't change the tautology test (bcltautology.c): If the minterms with 3-value at "var_pos" are 
+  covered, then also all other minterms are covered. bcp_NewBCLComplementWithCofactorSub() restricts the 
+  complement of the cofactor to 3-value at "var_pos", where the removed cubes don't contribute.
+  
   This function will update and modify the list "l"
 
 */
@@ -525,11 +582,16 @@ void bcp_DoBCLOneVariableCofactor(bcp p, bcl l, unsigned var_pos, unsigned value
     {
       c = bcp_GetBCLCube(p, l, i);
       v = bcp_GetCubeVar(p, c, var_pos);
-      if ( v != 3 )  // is the variable already don't care for the cofactor variable?
+      if ( v == value )
+      {
+        l->flags[i] = 1;        // cube is not part of the cofactor
+      }
+      else if ( v != 3 )  // is the variable already don't care for the cofactor variable?
       {
         if ( (v | value) == 3 ) // if no, then check if the variable would become don't care
         {
           bcp_SetCubeVar(p, c, var_pos, 3);   // yes, variable will become don't care
+          bcp_UpdateBCLSignature(p, l, i);
           bcp_DoBCLSubsetCubeMark(p, l, i);
         } // check for "becomes don't care'
       } // check for not don't carebcp_DoBCLOneVariableCofactor
@@ -538,16 +600,150 @@ void bcp_DoBCLOneVariableCofactor(bcp p, bcl l, unsigned var_pos, unsigned value
   bcp_PurgeBCL(p, l);  // cleanup for bcp_DoBCLSubsetCubeMark()
 }
 
+/*
+  create the cofactor of "l" with respect to "var_pos" and "value" (see bcp_DoBCLOneVariableCofactor()) in one pass:
+  Instead of copying all cubes, only those cubes are copied, which are part of the cofactor.
+  A cube, which has "value" at "var_pos", is not copied.
+  The variable of the other cubes is set to don't care during the copy.
+  After bcp_PurgeBCL() the list is equal to the result of bcp_DoBCLOneVariableCofactor().
+  The signatures of "l" are copied (if valid), cubes covered by a modified cube are marked as deleted, 
+  but are not yet purged.
+  "live_cnt" returns the number of cubes of "l", which are not deleted.
+  "del_cnt" returns the number of these cubes, which are not copied or are marked as deleted.
+*/
+static bcl bcp_NewBCLCofactorByVariableMark(bcp p, bcl l, unsigned var_pos, unsigned value, int *live_cnt, int *del_cnt)
+{
+  int i, j;
+  int cnt = 0;
+  unsigned v;
+  bc c;
+  bcl n;
+  
+  assert(value == 1 || value == 2);
+  *live_cnt = 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] == 0 )
+    {
+      (*live_cnt)++;
+      if ( bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, i), var_pos) != value )
+        cnt++;
+    }
+  }
+  
+  n = bcp_NewBCL(p);
+  if ( n == NULL )
+    return NULL;
+  if ( cnt > 0 && bcp_ReserveBCL(p, n, cnt) == 0 )
+    return bcp_DeleteBCL(p, n), NULL;
+  bcp_AddStat(p, BCP_STAT_COFACTOR_CUBE, cnt);
+  
+  j = 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] == 0 )
+    {
+      c = bcp_GetBCLCube(p, l, i);
+      v = bcp_GetCubeVar(p, c, var_pos);
+      if ( v != value )
+      {
+        bcp_CopyCube(p, bcp_GetBCLCube(p, n, j), c);
+        n->flags[j] = 0;
+        if ( v != 3 )
+          bcp_SetCubeVar(p, bcp_GetBCLCube(p, n, j), var_pos, 3);
+        if ( l->is_sig )
+          n->sig[j] = v != 3 ? bcp_GetCubeSignature(p, bcp_GetBCLCube(p, n, j)) : l->sig[i];
+        j++;
+      }
+    }
+  }
+  n->cnt = j;
+  n->is_sig = l->is_sig;
+  
+  /* the cubes, which are not modified, are already SCC free */
+  j = 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] == 0 )
+    {
+      v = bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, i), var_pos);
+      if ( v != value )
+      {
+        if ( v != 3 && n->flags[j] == 0 )
+          bcp_DoBCLSubsetCubeMark(p, n, j);
+        j++;
+      }
+    }
+  }
+  
+  *del_cnt = *live_cnt - cnt;
+  for( j = 0; j < n->cnt; j++ )
+    if ( n->flags[j] != 0 )
+      (*del_cnt)++;
+  return n;
+}
+
 /*
   same as "bcp_DoBCLOneVariableCofactor()" but will not alter "l"
   instead a new list is returned, which must be freed with bcp_DeleteBCL()
 */
 bcl bcp_NewBCLCofacterByVariable(bcp p, bcl l, unsigned var_pos, unsigned value)
 {
-  bcl n = bcp_NewBCLByBCL(p, l);
+  int live_cnt, del_cnt;
+  bcl n = bcp_NewBCLCofactorByVariableMark(p, l, var_pos, value, &live_cnt, &del_cnt);
   if ( n == NULL )
     return NULL;
-  bcp_DoBCLOneVariableCofactor(p, n, var_pos, value);
+  bcp_PurgeBCL(p, n);  // cleanup for bcp_DoBCLSubsetCubeMark()
+  return n;
+}
+
+/*
+  same as "bcp_NewBCLCofacterByVariable()", but additionally calculate the binate split table "ct" for the new list.
+  "t" must be the binate split table of "l", "t" is not modified.
+
+  The cofactor will only change the variable at "var_pos" to don't care and remove cubes, 
+  so instead of counting all cubes again, "ct" is derived from "t": The count for
+  the other value at "var_pos" is cleared and the removed cubes are subtracted.
+  If more cubes are removed than kept, then "ct" is calculated from scratch.
+*/
+bcl bcp_NewBCLCofacterByVariableWithBCT(bcp p, bcl l, bct t, bct ct, unsigned var_pos, unsigned value)
+{
+  int i;
+  int cnt;
+  int del_cnt;
+  bc c;
+  bcl n;
+  
+  assert(value == 1 || value == 2);
+  assert(t != ct);
+  
+  n = bcp_NewBCLCofactorByVariableMark(p, l, var_pos, value, &cnt, &del_cnt);
+  if ( n == NULL )
+    return NULL;
+  assert( t->cnt == cnt || t->cnt >= BCT_INCREMENTAL_MAX_CNT );  // deleted cubes are not part of "t"
+  
+  if ( t->cnt >= BCT_INCREMENTAL_MAX_CNT || del_cnt > cnt - del_cnt )
+  {
+    bcp_PurgeBCL(p, n);
+    bcp_CalcBCLBinateSplitVariableTable(p, ct, n);
+    return n;
+  }
+  
+  bcp_CopyBCT(p, ct, t);
+  bcp_ClearBCTVariable(p, ct, var_pos, 3-value);         // all cubes with the other value are now don't care at var_pos
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] == 0 )
+    {
+      c = bcp_GetBCLCube(p, l, i);
+      if ( bcp_GetCubeVar(p, c, var_pos) == value )
+        bcp_SubtractBCTCube(p, ct, c);          // cube, which is not part of "n", "value" at var_pos is still counted
+    }
+  }
+  for( i = 0; i < n->cnt; i++ )
+    if ( n->flags[i] != 0 )
+      bcp_SubtractBCTCube(p, ct, bcp_GetBCLCube(p, n, i));      // removed cube, var_pos is already don't care
+  bcp_PurgeBCL(p, n);
   return n;
 }
 
@@ -558,60 +754,134 @@ bcl bcp_NewBCLCofacterByVariable(bcp p, bcl l, unsigned var_pos, unsigned value)
   c might be part of l
   additionally ignore the element at position exclude (which is assumed to be c)
   exclude can be negative (which means, that no element of l is excluded)
+  Cubes, which do not intersect with c, are removed. For all other cubes the variables, 
+  which are not don't care in c, become don't care. Like bcp_DoBCLOneVariableCofactor(), 
+  only the modified cubes are checked for single cube containment.
 */
 void bcp_DoBCLCofactorByCube(bcp p, bcl l, bc c, int exclude)
 {
   int i;
   int b;
+  int cnt = l->cnt;
+  int is_modified;
   bc lc;
-  __m128i cc;
   __m128i dc;
+  __m128i o;
+  __m128i m;
   
   dc = _mm_loadu_si128(bcp_GetGlobalCube(p, 3));
   
   if ( exclude >= 0 )
     l->flags[exclude] = 1;
   
-  for( b = 0; b < p->blk_cnt; b++ )
+  for( i = 0; i < cnt; i++ )
   {
-    cc = _mm_andnot_si128( _mm_loadu_si128(c+b), dc);
-    
-    for( i = 0; i < l->cnt; i++ )
+    if ( l->flags[i] == 0 )
     {
-      if ( l->flags[i] == 0 )
+      lc = bcp_GetBCLCube(p, l, i);
+      if ( bcp_IsIntersectionCube(p, c, lc) == 0 )
+      {
+        l->flags[i] = 1;        // cube is not part of the cofactor
+        continue;
+      }
+      is_modified = 0;
+      for( b = 0; b < p->blk_cnt; b++ )
+      {
+        o = _mm_loadu_si128(lc+b);
+        m = _mm_or_si128(_mm_andnot_si128(_mm_loadu_si128(c+b), dc), o);
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(m, o)) != 0x0ffff )
+          is_modified = 1;
+        _mm_storeu_si128(lc+b, m);
+      }
+      if ( is_modified )
       {
-        lc = bcp_GetBCLCube(p, l, i);
-        _mm_storeu_si128(lc+b,  _mm_or_si128(cc, _mm_loadu_si128(lc+b)));
+        bcp_UpdateBCLSignature(p, l, i);
+        bcp_DoBCLSubsetCubeMark(p, l, i);
       }
     }
   }
-  bcp_DoBCLSingleCubeContainment(p, l);
+  bcp_PurgeBCL(p, l);  // cleanup for bcp_DoBCLSubsetCubeMark()
 }
 
 /*
   same as "bcp_DoBCLCofactorByCube()" but will not alter "l"
   instead a new list is returned, which must be freed with bcp_DeleteBCL()
+  Like bcp_NewBCLCofactorByVariableMark(), the list is created in one pass: Only the cubes, 
+  which intersect with "c", are copied and the variables of "c" are set to don't care during the copy.
+  The signature of an unmodified cube is taken from "l".
 */
 bcl bcp_NewBCLCofactorByCube(bcp p, bcl l, bc c, int exclude)
 {
-  bcl n = bcp_NewBCLByBCL(p, l);
+  int i, j, b;
+  int cnt = 0;
+  bc lc;
+  bc nc;
+  bcl n;
+  __m128i dc;
+  
+  dc = _mm_loadu_si128(bcp_GetGlobalCube(p, 3));
+  for( i = 0; i < l->cnt; i++ )
+    if ( i != exclude && l->flags[i] == 0 && bcp_IsIntersectionCube(p, c, bcp_GetBCLCube(p, l, i)) )
+      cnt++;
+  
+  n = bcp_NewBCL(p);
   if ( n == NULL )
     return NULL;
-  bcp_DoBCLCofactorByCube(p, n, c, exclude);
+  if ( cnt > 0 && bcp_ReserveBCL(p, n, cnt) == 0 )
+    return bcp_DeleteBCL(p, n), NULL;
+  bcp_AddStat(p, BCP_STAT_COFACTOR_CUBE, cnt);
+  
+  j = 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( i != exclude && l->flags[i] == 0 )
+    {
+      lc = bcp_GetBCLCube(p, l, i);
+      if ( bcp_IsIntersectionCube(p, c, lc) )
+      {
+        nc = bcp_GetBCLCube(p, n, j);
+        for( b = 0; b < p->blk_cnt; b++ )
+          _mm_storeu_si128(nc+b, _mm_or_si128(_mm_andnot_si128(_mm_loadu_si128(c+b), dc), _mm_loadu_si128(lc+b)));
+        n->flags[j] = 0;
+        if ( l->is_sig )
+          n->sig[j] = bcp_CompareCube(p, nc, lc) != 0 ? bcp_GetCubeSignature(p, nc) : l->sig[i];
+        j++;
+      }
+    }
+  }
+  n->cnt = j;
+  n->is_sig = l->is_sig;
+  
+  /* same as in bcp_DoBCLCofactorByCube(), only the modified cubes are checked */
+  j = 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( i != exclude && l->flags[i] == 0 )
+    {
+      lc = bcp_GetBCLCube(p, l, i);
+      if ( bcp_IsIntersectionCube(p, c, lc) )
+      {
+        if ( n->flags[j] == 0 && bcp_CompareCube(p, bcp_GetBCLCube(p, n, j), lc) != 0 )
+          bcp_DoBCLSubsetCubeMark(p, n, j);
+        j++;
+      }
+    }
+  }
+  bcp_PurgeBCL(p, n);  // cleanup for bcp_DoBCLSubsetCubeMark()
   return n;
 }
 
 
 /*
   Precondition: call to 
-    void bcp_CalcBCLBinateSplitVariableTable(bcp p, bcl l) 
+    void bcp_CalcBCLBinateSplitVariableTable(bcp p, bct t, bcl l) 
 
   return 0 if there is any variable which has one's and "zero's in the table
   otherwise this function returns 1
 
   16 bit version
 */
-int bcp_IsBCLUnate(bcp p)
+int bcp_IsBCLUnate(bcp p, bct t)
 {
   int b;
   bc zero_cnt_cube[8];
@@ -619,50 +889,33 @@ int bcp_IsBCLUnate(bcp p)
   __m128i z;
   __m128i o;
 
-  /* "misuse" the cubes as SIMD storage area for the counters */
-  zero_cnt_cube[0] = bcp_GetGlobalCube(p, 4);
-  zero_cnt_cube[1] = bcp_GetGlobalCube(p, 5);
-  zero_cnt_cube[2] = bcp_GetGlobalCube(p, 6);
-  zero_cnt_cube[3] = bcp_GetGlobalCube(p, 7);
-  zero_cnt_cube[4] = bcp_GetGlobalCube(p, 8);
-  zero_cnt_cube[5] = bcp_GetGlobalCube(p, 9);
-  zero_cnt_cube[6] = bcp_GetGlobalCube(p, 10);
-  zero_cnt_cube[7] = bcp_GetGlobalCube(p, 11);
-  
-  one_cnt_cube[0] = bcp_GetGlobalCube(p, 12);
-  one_cnt_cube[1] = bcp_GetGlobalCube(p, 13);
-  one_cnt_cube[2] = bcp_GetGlobalCube(p, 14);
-  one_cnt_cube[3] = bcp_GetGlobalCube(p, 15);
-  one_cnt_cube[4] = bcp_GetGlobalCube(p, 16);
-  one_cnt_cube[5] = bcp_GetGlobalCube(p, 17);
-  one_cnt_cube[6] = bcp_GetGlobalCube(p, 18);
-  one_cnt_cube[7] = bcp_GetGlobalCube(p, 19);
+  bcp_GetBCTCubes(p, t, zero_cnt_cube, one_cnt_cube);
 
   for( b = 0; b < p->blk_cnt; b++ )
   {
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[0]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[0]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[0]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[0]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
           return 0;
         
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[1]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[1]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[1]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[1]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
           return 0;
 
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[2]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[2]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[2]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[2]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
           return 0;
 
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[3]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[3]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[3]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[3]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
@@ -671,29 +924,29 @@ int bcp_IsBCLUnate(bcp p)
         
         
 
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[4]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[4]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[4]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[4]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
           return 0;
 
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[5]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[5]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[5]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[5]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
           return 0;
 
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[6]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[6]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[6]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[6]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
           return 0;
 
-        z = _mm_cmpeq_epi8(_mm_loadu_si128(zero_cnt_cube[7]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
-        o = _mm_cmpeq_epi8(_mm_loadu_si128(one_cnt_cube[7]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        z = _mm_cmpeq_epi16(_mm_loadu_si128(zero_cnt_cube[7]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
+        o = _mm_cmpeq_epi16(_mm_loadu_si128(one_cnt_cube[7]+b), _mm_setzero_si128());     // 0 cnt becomes 0xff and all other values become 0x00
                        // if ones and zeros are present, then both values are 0x00 and the reseult of the or is also 0x00
                       // this means, if there is any bit in c set to 0, then BCL is not unate and we can finish this procedure
         if ( _mm_movemask_epi8(_mm_or_si128(o, z)) != 0x0ffff )
@@ -6,6 +6,7 @@
 #include "bc.h"
 #include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
@@ -604,116 +605,151 @@ bcl bcp_NewBCLByBCX(bcp p, bcx x)
   convert BCL to a textual expression
 */
 
-#define STR_CHAR_EXTEND 32
+/*
+  The variable names are taken once from p->var_list into flat arrays, so that the
+  output loops do not need any co lookup. The output is generated in two passes:
+  the first pass calculates the exact length, the second pass writes the chars.
+  Only the variables with a 01 or 10 code are visited, don't care variables are skipped
+  with the literal mask of each 64 bit word.
+*/
+struct bcp_expression_names
+{
+  const char **name;    // name of each variable, "" if the variable does not have a name
+  size_t *len;          // strlen() of each name
+  size_t max_cube_len;  // upper bound for the length of one cube
+};
 
-int str_extend(char **s, size_t *max, size_t extend)
+static void bcp_ClearExpressionNames(struct bcp_expression_names *en)
 {
-  void *p;
-  if ( *max == 0 || *s == NULL )
+  free(en->name);
+  free(en->len);
+}
+
+static int bcp_InitExpressionNames(bcp p, struct bcp_expression_names *en)
+{
+  int i;
+  cco s;
+  if ( p->var_list == NULL )
+    bcp_BuildVarList(p);
+  en->name = (const char **)malloc((p->var_cnt+1)*sizeof(const char *));
+  en->len = (size_t *)malloc((p->var_cnt+1)*sizeof(size_t));
+  if ( en->name == NULL || en->len == NULL )
+    return bcp_ClearExpressionNames(en), 0;
+  en->max_cube_len = 1;         // "1" for the universal cube
+  for( i = 0; i < p->var_cnt; i++ )
   {
-    *s = (char *)malloc(extend);
-    if ( *s == NULL )
-      return 0;
-    *max = extend;
-    return 1;
+    s = NULL;
+    if ( p->var_list != NULL && i < coVectorSize(p->var_list) )
+      s = coVectorGet(p->var_list, i);
+    en->name[i] = s == NULL ? "" : coStrGet(s);
+    en->len[i] = strlen(en->name[i]);
+    en->max_cube_len += en->len[i] + 2;        // and, not, name
   }
-  p = realloc(*s, *max + extend);
-  if ( p == NULL )
-    return 0;
-  *s = (char *)p;
-  *max += extend;
   return 1;
 }
 
-int str_extend_and_append(char **s, size_t *len, size_t *max, const char *t)
+/* bit 2*k of the result is set, if variable k of the word has the code 01 or 10 */
+#define bcp_GetLiteralMask(w) (((w) ^ ((w) >> 1)) & 0x5555555555555555ULL)
+
+static size_t bcp_GetExpressionCubeLen(bcp p, bc c, const struct bcp_expression_names *en)
 {
-  size_t tl = strlen(t);
-  if ( *len+tl+1 > *max )
-    if ( str_extend(s, max, *len + tl +1 - *max + STR_CHAR_EXTEND) == 0 )
-      return 0;
-    
-  strcpy(*s+*len, t);
-  *len += tl;
-  return 1;
+  const uint64_t *w = (const uint64_t *)c;
+  int i, var, word_cnt = (p->var_cnt + 31) / 32;
+  uint64_t m;
+  size_t len = 0, lit_cnt = 0;
+  for( i = 0; i < word_cnt; i++ )
+  {
+    m = bcp_GetLiteralMask(w[i]);
+    while ( m != 0 )
+    {
+      var = i*32 + __builtin_ctzll(m)/2;
+      len += en->len[var] + (((w[i] >> ((var & 31)*2)) & 3) == 1);      // name and not
+      lit_cnt++;
+      m &= m - 1;
+    }
+  }
+  if ( lit_cnt == 0 )
+    return 1;           // "1"
+  return len + lit_cnt - 1;     // and
 }
 
-int str_extend_and_append_cube(char **s, size_t *len, size_t *max, bcp p, bc c)
+/* write the cube without '\0', returns the position after the last char */
+static char *bcp_WriteExpressionCube(bcp p, bc c, const struct bcp_expression_names *en, char *s)
 {
-  int i, var_cnt = p->var_cnt;
-  int value;
-  char not_str[2];
-  char and_str[2];
-  int is_first = 1;
-  
-  not_str[0] = p->x_not;
-  not_str[1] = '\0';
-  and_str[0] = p->x_and;
-  and_str[1] = '\0';  
-  
-  for( i = 0; i < var_cnt; i++ )
+  const uint64_t *w = (const uint64_t *)c;
+  int i, var, word_cnt = (p->var_cnt + 31) / 32;
+  uint64_t m;
+  char *start = s;
+  for( i = 0; i < word_cnt; i++ )
   {
-    value = bcp_GetCubeVar(p, c, i);
-    if ( value == 1 || value == 2 )
+    m = bcp_GetLiteralMask(w[i]);
+    while ( m != 0 )
     {
-      if ( is_first )
-        is_first = 0;
-      else
-        if ( str_extend_and_append(s, len, max, and_str) == 0 )
-          return 0;
-        
-      if ( value == 1 )
-        if ( str_extend_and_append(s, len, max, not_str) == 0 )
-          return 0;
-      
-      if ( str_extend_and_append(s, len, max, coStrGet(coVectorGet( p->var_list, i ))) == 0 )
-        return 0;
+      var = i*32 + __builtin_ctzll(m)/2;
+      if ( s != start )
+        *s++ = p->x_and;
+      if ( ((w[i] >> ((var & 31)*2)) & 3) == 1 )
+        *s++ = p->x_not;
+      memcpy(s, en->name[var], en->len[var]);
+      s += en->len[var];
+      m &= m - 1;
     }
   }
-  if ( is_first )
-    if ( str_extend_and_append(s, len, max, "1") == 0 )
-      return 0;
-  return 1;
+  if ( s == start )
+    *s++ = '1';
+  return s;
 }
 
-int str_extend_and_append_list(char **s, size_t *len, size_t *max, bcp p, bcl l)
+/* convert "l" to a human readable expression, return value must be free'd if not NULL */
+char *bcp_GetExpressionBCL(bcp p, bcl l)
 {
+  struct bcp_expression_names en;
+  size_t len = 0;
+  char *s, *t;
   int i;
-  int is_first = 1;
-  char or_str[2];
-  or_str[0] = p->x_or;
-  or_str[1] = '\0';
-  
+
+  if ( bcp_InitExpressionNames(p, &en) == 0 )
+    return NULL;
+  for( i = 0; i < l->cnt; i++ )
+    len += bcp_GetExpressionCubeLen(p, bcp_GetBCLCube(p, l, i), &en) + (i > 0);       // or
+  s = (char *)malloc(len+1);
+  if ( s == NULL )
+    return bcp_ClearExpressionNames(&en), NULL;
+  t = s;
   for( i = 0; i < l->cnt; i++ )
   {
-      if ( is_first )
-        is_first = 0;
-      else
-        if ( str_extend_and_append(s, len, max, or_str) == 0 )
-          return 0;
-        
-    if ( str_extend_and_append_cube(s, len, max, p,bcp_GetBCLCube(p, l, i)) == 0 )
-      return 0;
+    if ( i > 0 )
+      *t++ = p->x_or;
+    t = bcp_WriteExpressionCube(p, bcp_GetBCLCube(p, l, i), &en, t);
   }
-  return 1;
+  *t = '\0';
+  assert( (size_t)(t - s) == len );
+  bcp_ClearExpressionNames(&en);
+  return s;
 }
 
-
-char *bcp_GetExpressionBCL(bcp p, bcl l)
+/* write the expression of "l" to "fp" without building the complete string, returns 0 for error */
+int bcp_WriteExpressionBCL(bcp p, bcl l, FILE *fp)
 {
-  size_t len, max;
-  char *s;
-  
-  len = 0; 
-  max = 0;
-  s = NULL;
-  
-  if ( p->var_list == NULL )
-    bcp_BuildVarList(p);
-  
-  if ( str_extend(&s, &max, STR_CHAR_EXTEND) == 0 )
-    return NULL;
-  if ( str_extend_and_append_list(&s, &len, &max, p, l) == 0 )
-    return free(s), NULL;
-  
-  return s;
+  struct bcp_expression_names en;
+  char *s, *t;
+  int i;
+
+  if ( bcp_InitExpressionNames(p, &en) == 0 )
+    return 0;
+  s = (char *)malloc(en.max_cube_len + 1);      // buffer for one cube and the or
+  if ( s == NULL )
+    return bcp_ClearExpressionNames(&en), 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    t = s;
+    if ( i > 0 )
+      *t++ = p->x_or;
+    t = bcp_WriteExpressionCube(p, bcp_GetBCLCube(p, l, i), &en, t);
+    if ( fwrite(s, t - s, 1, fp) != 1 )
+      return free(s), bcp_ClearExpressionNames(&en), 0;
+  }
+  free(s);
+  bcp_ClearExpressionNames(&en);
+  return 1;
 }
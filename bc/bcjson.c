@@ -77,310 +77,762 @@
       Copy slot 0 and the given other slot
         { "cmd":"copy0", "slot":1 }
 
+    stat
+      Add the execution statistics of all previous commands to the label output as "stat" member,
+      see bcp_NewStatMap() in bcstat.c. All previous commands are finished before this command.
+        { "cmd":"stat", "label":"s" }
+
+  errors
+
+    A command with a bcl, which does not match the number of variables, or with an empty
+    argument slot is not executed. If the command has a label, then the reason is reported
+    with the "error" member of the label output.
+
+  execution
+
+    The number of slots is given by the caller (BCJ_DEFAULT_SLOT_CNT for the -json option).
+    A slot outside of the valid range is replaced by slot 0.
+    
+    All bcl/expr arguments are converted first. Then each command gets a wave number from the
+    slots, which are read and written by the command: A command is placed after the last command,
+    which writes one of its slots, and after the last command, which reads a slot written by the command.
+    "show" is also ordered with all other "show" commands. Commands of the same wave are independent
+    and are executed by a pool of threads, "equal0" is split into its two subset tests.
+    The JSON output is generated afterwards in the order of the input, so the output does not depend 
+    on the number of threads.
 
 */
 
 #include "co.h"
 #include "bc.h"
 #include <string.h>
+#include <stdlib.h>
 #include <assert.h>
+#include <pthread.h>
+
+#define BCJ_MAX_THREADS 256
 
-#define SLOT_CNT 9
+#define BCJ_CMD_NONE 0
+#define BCJ_CMD_BCL2SLOT 1
+#define BCJ_CMD_SHOW 2
+#define BCJ_CMD_INTERSECTION0 3
+#define BCJ_CMD_SUBTRACT0 4
+#define BCJ_CMD_EQUAL0 5
+#define BCJ_CMD_EXCHANGE0 6
+#define BCJ_CMD_COPY0 7
+#define BCJ_CMD_STAT 8
 
-int bc_ExecuteVector(cco in)
+/* one element of the json array */
+struct bcj_cmd_struct
+{
+  int cmd;              // BCJ_CMD_xxx, BCJ_CMD_NONE for an unknown command or if the problem is not yet known
+  int slot;
+  const char *label;    // points into the input vector
+  const char *label0;
+  bcl l;                // bcl/expr argument or NULL, owned by the command until "bcl2slot" moves it into the slot
+  int wave;             // commands with the same wave number do not depend on each other
+  int is_empty;         // results of the command, -1 if not calculated
+  int is_0_superset;
+  int is_0_subset;
+  co bcl_output;        // label0: cubes of slot 0 after the command, NULL if slot 0 is empty
+  char *expr_output;    // label0: expression of slot 0 after the command
+  int is_expr_output;
+  co stat_output;       // statistics for the "stat" command
+  const char *error;    // reason, why the command could not be executed, NULL if there was no error
+};
+
+/* one command is one task, but "equal0" has one task for each of the two subset tests */
+struct bcj_task_struct
+{
+  long cmd_idx;
+  int part;
+};
+
+struct bcj_worker_struct
+{
+  bcp p;                // context of the worker
+  bcj j;
+  long end;             // one after the last task of the current wave
+  long *next;           // next task of the current wave, shared by all workers
+};
+
+/*============================================================*/
+/* parse phase */
+
+static int bcj_GetCmdCode(const char *cmd)
+{
+  if ( cmd == NULL )
+    return BCJ_CMD_NONE;
+  if ( strcmp(cmd, "bcl2slot") == 0 )
+    return BCJ_CMD_BCL2SLOT;
+  if ( strcmp(cmd, "show") == 0 )
+    return BCJ_CMD_SHOW;
+  if ( strcmp(cmd, "intersection0") == 0 )
+    return BCJ_CMD_INTERSECTION0;
+  if ( strcmp(cmd, "subtract0") == 0 )
+    return BCJ_CMD_SUBTRACT0;
+  if ( strcmp(cmd, "equal0") == 0 )
+    return BCJ_CMD_EQUAL0;
+  if ( strcmp(cmd, "exchange0") == 0 )
+    return BCJ_CMD_EXCHANGE0;
+  if ( strcmp(cmd, "copy0") == 0 )
+    return BCJ_CMD_COPY0;
+  if ( strcmp(cmd, "stat") == 0 )
+    return BCJ_CMD_STAT;
+  return BCJ_CMD_NONE;
+}
+
+/* 
+  returns 1 if all variables of the expression are already part of "p"
+  The variable list of "p" is fixed after the first command vector, so a new variable can't be added.
+*/
+static int bcj_IsExprVarKnown(bcp p, const char *expr_str)
+{
+  coMapIterator iter;
+  int is_known = 1;
+  bcp q = bcp_New(0);                // dummy bcp for the names of the expression
+  bcx x;
+  if ( q == NULL )
+    return 0;
+  x = bcp_Parse(q, expr_str, 0);
+  if ( x == NULL )
+    is_known = 0;
+  bcp_DeleteBCX(q, x);
+  if ( is_known && q->var_map != NULL && coMapLoopFirst(&iter, q->var_map) )
+  {
+    do
+    {
+      if ( p == NULL || p->var_map == NULL || coMapExists(p->var_map, coMapLoopKey(&iter)) == 0 )
+        is_known = 0;
+    } while( is_known && coMapLoopNext(&iter) );
+  }
+  bcp_Delete(q);
+  return is_known;
+}
+
+/* 
+  check the bcl string "s" of a command, the problem of "j" is created by the first bcl string
+  Each line must contain a multiple of the number of variables, otherwise the cubes would be misaligned.
+  returns NULL if "s" can be converted or the error message
+*/
+static const char *bcj_CheckBCLString(bcj j, const char *s)
+{
+  int var_cnt;
+  if ( j->p == NULL )
+  {
+    var_cnt = bcp_GetVarCntFromString(s);
+    if ( var_cnt == 0 )
+      return "bcl without variables";
+    j->p = bcp_New(var_cnt);
+    if ( j->p == NULL )
+      return "memory error";
+  }
+  for(;;)
+  {
+    if ( j->p->var_cnt == 0 || bcp_GetVarCntFromString(s) % j->p->var_cnt != 0 )
+      return "bcl does not match the number of variables";
+    s = strchr(s, '\n');
+    if ( s == NULL )
+      break;
+    s++;
+  }
+  return NULL;
+}
+
+/* read the members of a cmd block: "cmd", "label", "label0", "slot", "bcl" and "expr" */
+static void bcj_ReadCmd(bcj j, cco cmdmap, struct bcj_cmd_struct *c)
 {
-  bcp p = NULL;
-  bcl slot_list[SLOT_CNT];
-  int var_cnt = -1;
-  long cnt = coVectorSize(in);
-  long i;
   cco o;
-  const char *cmd = NULL;
-  const char *label = NULL;
-  const char *label0 = NULL;
-  int slot = 0;
-  const char *bclstr = NULL;
-  bcl l = NULL;
-  bcl arg;              // argument.. either l or a slot
-  int result = 0;
-  int is_empty = -1;
-  int is_0_superset = -1;
-  int is_0_subset = -1;
-  co output = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
-  
-  assert( output != NULL );
-  
-  for( i = 0; i < SLOT_CNT; i++ )
-    slot_list[i] = NULL;
-  
-  assert( coIsVector(in) );
+  const char *bclstr;
+  long i;
 
-  // PRE PHASE: Collect all variable names
-  for( i = 0; i < cnt; i++ )
+  o = coMapGet(cmdmap, "cmd");
+  if (coIsStr(o))
+    c->cmd = bcj_GetCmdCode(coStrGet(o));
+
+  o = coMapGet(cmdmap, "label");
+  if (coIsStr(o))
+    c->label = coStrGet(o);
+
+  o = coMapGet(cmdmap, "label0");
+  if (coIsStr(o))
+    c->label0 = coStrGet(o);
+
+  o = coMapGet(cmdmap, "slot");
+  if (coIsDbl(o))
   {
-    cco cmdmap = coVectorGet(in, i);
-    if ( coIsMap(cmdmap) )
+    c->slot = (int)coDblGet(o);
+    if ( c->slot >= j->slot_cnt || c->slot < 0 )
+      c->slot = 0;
+  }
+  
+  o = coMapGet(cmdmap, "bcl");
+  if (coIsStr(o))
+  {
+    bclstr = coStrGet(o);
+    c->error = bcj_CheckBCLString(j, bclstr);
+    if ( c->error == NULL )
     {
-      o = coMapGet(cmdmap, "expr");             // "expr" is an alternative way to describe a bcl
-      if (coIsStr(o))                     // only of the expr is a string and only of the bcl has not been assigned before
+      c->l = bcp_NewBCLByString(j->p, bclstr);
+      if ( c->l == NULL )
+        c->error = "memory error";
+    }
+  }
+  else if ( coIsVector(o) )
+  {
+    for( i = 0; i < coVectorSize(o) && c->error == NULL; i++ )
+    {
+      cco so = coVectorGet(o, i);
+      if (coIsStr(so))
       {
-        const char *expr_str = coStrGet(o);        
-        bcx x;
-        if ( p == NULL )
-        {
-          p = bcp_New(0);               // create a dummy bcp
-          assert( p != NULL );
-        }
-        x = bcp_Parse(p, expr_str, 0);              // no propagation required, we are just collecting the names
-        if ( x != NULL )
-            bcp_DeleteBCX(p, x);                      // free the expression tree
-      }
+        bclstr = coStrGet(so);
+        c->error = bcj_CheckBCLString(j, bclstr);
+        if ( c->error != NULL )
+          break;
+        if ( c->l == NULL )
+          c->l = bcp_NewBCL(j->p);
+        if ( c->l == NULL || bcp_AddBCLCubesByString(j->p, c->l, bclstr) == 0 )
+          c->error = "memory error";
+      } // coIsStr
+    } // for
+  } // bcl is vector
+
+  o = coMapGet(cmdmap, "expr");             // "expr" is an alternative way to describe a bcl
+  if (coIsStr(o) && c->l == NULL && c->error == NULL && (j->is_var_check == 0 || bcj_IsExprVarKnown(j->p, coStrGet(o))) )      // only of the expr is a string and only of the bcl has not been assigned before
+  {
+    bcx x = bcp_Parse(j->p, coStrGet(o), 1);              // assumption: p already contains all variables of expr_str
+    if ( x != NULL )
+    {
+      c->l = bcp_NewBCLByBCX(j->p, x);          // create a bcl from the expression tree 
+      bcp_DeleteBCX(j->p, x);                      // free the expression tree
     }
   }
   
-  if ( p != NULL )      // if a dummy bcp had been created, then convert that bcp to a regular bcp
+  if ( c->error != NULL && c->l != NULL )
   {
-      bcp_UpdateFromBCX(p);
+    bcp_DeleteBCL(j->p, c->l);
+    c->l = NULL;
   }
+  if ( j->p == NULL || c->error != NULL )
+    c->cmd = BCJ_CMD_NONE;              // no problem yet or invalid bcl: the command is ignored
+}
 
+/*
+  get the slots, which are read and written by the command, slot_cnt is used for the output of "show"
+  "read" and "write" must have space for 3 entries
+*/
+static void bcj_GetCmdSlots(bcj j, struct bcj_cmd_struct *c, int *read, int *read_cnt, int *write, int *write_cnt)
+{
+  *read_cnt = 0;
+  *write_cnt = 0;
+  if ( c->label0 != NULL )
+    read[(*read_cnt)++] = 0;
+  switch( c->cmd )
+  {
+    case BCJ_CMD_BCL2SLOT:
+      if ( c->l != NULL )
+        write[(*write_cnt)++] = c->slot;
+      break;
+    case BCJ_CMD_SHOW:
+      write[(*write_cnt)++] = j->slot_cnt;
+      if ( c->l == NULL )
+        read[(*read_cnt)++] = c->slot;
+      break;
+    case BCJ_CMD_EQUAL0:
+      read[(*read_cnt)++] = 0;
+      if ( c->l == NULL )
+        read[(*read_cnt)++] = c->slot;
+      break;
+    case BCJ_CMD_INTERSECTION0:
+    case BCJ_CMD_SUBTRACT0:
+      write[(*write_cnt)++] = 0;
+      if ( c->l == NULL )
+        read[(*read_cnt)++] = c->slot;
+      break;
+    case BCJ_CMD_EXCHANGE0:
+      write[(*write_cnt)++] = 0;
+      write[(*write_cnt)++] = c->slot;
+      break;
+    case BCJ_CMD_COPY0:
+      read[(*read_cnt)++] = 0;
+      write[(*write_cnt)++] = c->slot;
+      break;
+  }
+}
+
+/* 
+  assign the wave number to each command and create the task list ordered by the wave number 
+  returns the number of tasks or -1 for memory error
+*/
+static long bcj_BuildTaskList(bcj j, long cnt, int *wave_cnt)
+{
+  int read[3], write[3];
+  int read_cnt, write_cnt;
+  int *last_read = (int *)malloc((j->slot_cnt+1)*sizeof(int));
+  int *last_write = (int *)malloc((j->slot_cnt+1)*sizeof(int));
+  long *wave_pos;
+  long i, task_cnt = 0;
+  int k, wave;
+  int min_wave = 0;             // first wave after the last "stat" command
+  struct bcj_cmd_struct *c;
+
+  if ( last_read == NULL || last_write == NULL )
+    return free(last_read), free(last_write), -1;
+  for( k = 0; k <= j->slot_cnt; k++ )
+  {
+    last_read[k] = -1;
+    last_write[k] = -1;
+  }
+  *wave_cnt = 0;
+  for( i = 0; i < cnt; i++ )
+  {
+    c = j->cmd_list + i;
+    bcj_GetCmdSlots(j, c, read, &read_cnt, write, &write_cnt);
+    wave = min_wave;
+    if ( c->cmd == BCJ_CMD_STAT )
+    {
+      wave = *wave_cnt;         // new wave after all other commands
+      min_wave = wave + 1;
+    }
+    for( k = 0; k < read_cnt; k++ )
+      if ( wave <= last_write[read[k]] )
+        wave = last_write[read[k]] + 1;
+    for( k = 0; k < write_cnt; k++ )
+    {
+      if ( wave <= last_write[write[k]] )
+        wave = last_write[write[k]] + 1;
+      if ( wave <= last_read[write[k]] )
+        wave = last_read[write[k]] + 1;
+    }
+    for( k = 0; k < read_cnt; k++ )
+      if ( last_read[read[k]] < wave )
+        last_read[read[k]] = wave;
+    for( k = 0; k < write_cnt; k++ )
+      last_write[write[k]] = wave;
+    c->wave = wave;
+    if ( *wave_cnt <= wave )
+      *wave_cnt = wave + 1;
+    task_cnt += c->cmd == BCJ_CMD_EQUAL0 ? 2 : 1;
+  }
+  free(last_read);
+  free(last_write);
   
-  // MAIN PHASE: Execute each element of the json array  
-  
+  /* counting sort of the tasks by the wave number, the order of the input is kept within a wave */
+  wave_pos = (long *)calloc(*wave_cnt+1, sizeof(long));
+  j->task_list = (struct bcj_task_struct *)malloc((task_cnt+1)*sizeof(struct bcj_task_struct));
+  if ( wave_pos == NULL || j->task_list == NULL )
+    return free(wave_pos), -1;
+  for( i = 0; i < cnt; i++ )
+    wave_pos[j->cmd_list[i].wave+1] += j->cmd_list[i].cmd == BCJ_CMD_EQUAL0 ? 2 : 1;
+  for( k = 0; k < *wave_cnt; k++ )
+    wave_pos[k+1] += wave_pos[k];
   for( i = 0; i < cnt; i++ )
   {
-    cco cmdmap = coVectorGet(in, i);
-    cmd = NULL;
-    label = NULL;
-    label0 = NULL;
-    slot = 0;
-    is_empty = -1;
-    if ( l != NULL )
-      bcp_DeleteBCL(p, l);
-    l = NULL;
-    if ( coIsMap(cmdmap) )
+    c = j->cmd_list + i;
+    for( k = 0; k < (c->cmd == BCJ_CMD_EQUAL0 ? 2 : 1); k++ )
     {
-      
-      // STEP 1: Read the member variables from a cmd block: "cmd", "slot", "bcl"
-      
-      o = coMapGet(cmdmap, "cmd");
-      if (coIsStr(o))
-        cmd = coStrGet(o);
-
-      o = coMapGet(cmdmap, "label");
-      if (coIsStr(o))
-        label = coStrGet(o);
+      j->task_list[wave_pos[c->wave]].cmd_idx = i;
+      j->task_list[wave_pos[c->wave]].part = k;
+      wave_pos[c->wave]++;
+    }
+  }
+  free(wave_pos);
+  return task_cnt;
+}
 
-      o = coMapGet(cmdmap, "label0");
-      if (coIsStr(o))
-        label0 = coStrGet(o);
+/*============================================================*/
+/* execution phase */
 
-      o = coMapGet(cmdmap, "slot");
-      if (coIsDbl(o))
+static void bcj_ExecuteTask(bcp p, bcj j, struct bcj_task_struct *t)
+{
+  struct bcj_cmd_struct *c = j->cmd_list + t->cmd_idx;
+  bcl *slot_list = j->slot_list;
+  bcl arg = (c->l!=NULL)?c->l:slot_list[c->slot];      // argument.. either l or a slot
+  bcl tmp;
+  int i;
+  
+  switch( c->cmd )
+  {
+    // "bcl2slot"  "bcl" into "slot"
+    case BCJ_CMD_BCL2SLOT:
+      if ( c->l != NULL )
       {
-        slot = (int)coDblGet(o);
-        if ( slot >= SLOT_CNT || slot < 0 )
-          slot = 0;
+        if ( slot_list[c->slot] != NULL )
+          bcp_DeleteBCL(p, slot_list[c->slot]);
+        slot_list[c->slot] = c->l;
+        c->l = NULL;
       }
-      
-      o = coMapGet(cmdmap, "bcl");
-      if (coIsStr(o))
+      break;
+    // "show"  "bcl" or "show" bcl from "slot"
+    case BCJ_CMD_SHOW:
+      if ( arg == NULL )
+        c->error = "slot is empty";
+      else
+        bcp_ShowBCL(p, arg);
+      break;
+    // intersection0: calculate intersection with slot 0
+    // result is stored in slot 0
+    case BCJ_CMD_INTERSECTION0:
+      if ( slot_list[0] == NULL || arg == NULL )
+        c->error = "slot is empty";
+      else if ( bcp_IntersectionBCL(p, slot_list[0], arg) == 0 )   // a = a intersection with b 
+        c->error = "memory error";
+      else
+        c->is_empty = slot_list[0]->cnt == 0 ? 1 : 0;
+      break;
+    case BCJ_CMD_SUBTRACT0:
+      if ( slot_list[0] == NULL || arg == NULL )
+        c->error = "slot is empty";
+      else if ( bcp_SubtractBCL(p, slot_list[0], arg, 1) == 0 )   // a = a minus b 
+        c->error = "memory error";
+      else
+        c->is_empty = slot_list[0]->cnt == 0 ? 1 : 0;
+      break;
+    case BCJ_CMD_EQUAL0:
+      if ( slot_list[0] == NULL || arg == NULL )
       {
-        bclstr = coStrGet(o);
-        if ( p == NULL )
-        {
-          var_cnt = bcp_GetVarCntFromString(bclstr);
-          if ( var_cnt > 0 )
-          {
-            p = bcp_New(var_cnt);
-            assert( p != NULL );
-          }
-        }
-        l = bcp_NewBCLByString(p, bclstr);
-        assert( l != NULL );
+        if ( t->part == 0 )             // the other part runs in parallel, only one part writes the error
+          c->error = "slot is empty";
       }
-      else if ( coIsVector(o) )
-      {
-        long i;
-        for( i = 0; i < coVectorSize(o); i++ )
-        {
-          cco so = coVectorGet(o, i);
-          if (coIsStr(so))
-          {
-            bclstr = coStrGet(so);
-            if ( p == NULL )
-            {
-              var_cnt = bcp_GetVarCntFromString(bclstr);
-              if ( var_cnt > 0 )
-              {
-                p = bcp_New(var_cnt);
-                assert( p != NULL );
-              }
-            } // p == NULL
-            if ( l == NULL )
-            {
-              l = bcp_NewBCL(p);
-              assert( l != NULL );
-            } // l == NULL
-            result = bcp_AddBCLCubesByString(p, l, bclstr);
-            assert( result != 0 );
-            
-          } // coIsStr
-        } // for
-      } // bcl is vector
-
-      o = coMapGet(cmdmap, "expr");             // "expr" is an alternative way to describe a bcl
-      if (coIsStr(o) && l == NULL )                     // only of the expr is a string and only of the bcl has not been assigned before
+      else if ( t->part == 0 )
+        c->is_0_superset = bcp_IsBCLSubset(p, slot_list[0], arg);       //   test, whether "arg" is a subset of "slot_list[0]": 1 if slot_list[0] is a superset of "arg"
+      else
+        c->is_0_subset = bcp_IsBCLSubset(p, arg, slot_list[0]);
+      break;
+    case BCJ_CMD_EXCHANGE0:
+      tmp = slot_list[c->slot];         // an empty slot is also exchanged
+      slot_list[c->slot] = slot_list[0];
+      slot_list[0] = tmp;
+      break;
+    case BCJ_CMD_STAT:
+      c->stat_output = bcp_NewStatMap(p);       // executed by the thread of the problem, see bcj_ExecuteTaskList()
+      break;
+    case BCJ_CMD_COPY0:
+      if ( slot_list[0] == NULL )
       {
-        const char *expr_str = coStrGet(o);        
-        //printf("expr: %s\n", expr_str);
-        bcx x = bcp_Parse(p, expr_str, 1);              // assumption: p already contains all variables of expr_str
-        if ( x != NULL )
-        {
-            l = bcp_NewBCLByBCX(p, x);          // create a bcl from the expression tree 
-            bcp_DeleteBCX(p, x);                      // free the expression tree
-        }
+        c->error = "slot is empty";
+        break;
       }
+      if ( slot_list[c->slot] == NULL )
+        slot_list[c->slot] = bcp_NewBCL(p);
+      if ( slot_list[c->slot] == NULL || bcp_CopyBCL(p, slot_list[c->slot], slot_list[0]) == 0 )
+        c->error = "memory error";
+      break;
+  }
+  
+  // the content of slot 0 for label0 is taken now, the remaining output is generated later
+  if ( t->part == 0 && c->label0 != NULL && slot_list[0] != NULL )
+  {
+    c->bcl_output = coNewVector(CO_FREE_VALS);
+    assert( c->bcl_output != NULL );
+    for( i = 0; i <  slot_list[0]->cnt; i++ )
+    {
+      char *cs = (char *)malloc(p->var_cnt+1);    // the string is owned by the co object
+      if ( cs != NULL )
+        coVectorAdd( c->bcl_output, coNewStr(CO_STRFREE, bcp_GetStringFromCubeBuffer(p, bcp_GetBCLCube(p, slot_list[0], i), cs)));
+    }
+    if ( p->x_var_cnt == p->var_cnt )
+    {
+      c->expr_output = bcp_GetExpressionBCL(p, slot_list[0]);
+      c->is_expr_output = 1;
+    }
+  }
+}
 
-      // STEP 2: Execute the command
-      
-      arg = (l!=NULL)?l:slot_list[slot];
+static void *bcj_WorkerThread(void *arg)
+{
+  struct bcj_worker_struct *w = (struct bcj_worker_struct *)arg;
+  long k;
+  for(;;)
+  {
+    k = __atomic_fetch_add(w->next, 1, __ATOMIC_RELAXED);
+    if ( k >= w->end )
+      break;
+    bcj_ExecuteTask(w->p, w->j, w->j->task_list + k);
+  }
+  return NULL;
+}
 
-      // "bcl2slot"  "bcl" into "slot"
-      if ( p != NULL && strcmp(cmd, "bcl2slot") == 0 )
+/* execute the tasks wave by wave, the tasks of one wave are distributed to "thread_cnt" threads */
+static void bcj_ExecuteTaskList(bcj j, long task_cnt, int thread_cnt)
+{
+  struct bcj_worker_struct w[BCJ_MAX_THREADS];
+  pthread_t thread[BCJ_MAX_THREADS];
+  long first, end, next;
+  int i, thread_start_cnt;
+
+  if ( j->p == NULL )
+    thread_cnt = 1;             // there is nothing to execute
+  if ( thread_cnt > BCJ_MAX_THREADS )
+    thread_cnt = BCJ_MAX_THREADS;
+  w[0].p = j->p;
+  for( i = 1; i < thread_cnt; i++ )
+  {
+    w[i].p = bcp_NewContext(j->p);
+    if ( w[i].p == NULL )
+      break;
+  }
+  thread_cnt = i < 1 ? 1 : i;         // in case of memory error, continue with less threads
+  
+  for( first = 0; first < task_cnt; first = end )
+  {
+    for( end = first+1; end < task_cnt; end++ )
+      if ( j->cmd_list[j->task_list[end].cmd_idx].wave != j->cmd_list[j->task_list[first].cmd_idx].wave )
+        break;
+    if ( j->cmd_list[j->task_list[first].cmd_idx].cmd == BCJ_CMD_STAT )
+    {
+      /* "stat" is the only command of its wave: collect the statistics of the other contexts */
+      for( i = 1; i < thread_cnt; i++ )
       {
-        if ( l != NULL )
-        {
-          if ( slot_list[slot] != NULL )
-            bcp_DeleteBCL(p, slot_list[slot]);
-          slot_list[slot] = l;
-          l = NULL;
-        }
+        bcp_AddStatByContext(j->p, w[i].p);
+        bcp_ClearStat(w[i].p);
       }
-      // "show"  "bcl" or "show" bcl from "slot"
-      else if ( p != NULL &&  strcmp(cmd, "show") == 0 )
+    }
+    next = first;
+    thread_start_cnt = 1;
+    for( i = 0; i < thread_cnt; i++ )
+    {
+      w[i].j = j;
+      w[i].end = end;
+      w[i].next = &next;
+    }
+    for( ; thread_start_cnt < thread_cnt && thread_start_cnt < end-first; thread_start_cnt++ )
+      if ( pthread_create(thread+thread_start_cnt, NULL, bcj_WorkerThread, w+thread_start_cnt) != 0 )
+        break;
+    bcj_WorkerThread(w);
+    for( i = 1; i < thread_start_cnt; i++ )
+      pthread_join(thread[i], NULL);
+  }
+  
+  for( i = 1; i < thread_cnt; i++ )
+    bcp_Delete(w[i].p);
+}
+
+/*============================================================*/
+/* output phase */
+
+/* generate the JSON output in the order of the input, the superset and subset flags are kept until the next "equal0" */
+static co bcj_NewOutput(bcj j, long cnt)
+{
+  int is_0_superset = -1;
+  int is_0_subset = -1;
+  struct bcj_cmd_struct *c;
+  long i;
+  co output = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+  
+  assert( output != NULL );
+  for( i = 0; i < cnt; i++ )
+  {
+    c = j->cmd_list + i;
+    if ( c->cmd == BCJ_CMD_EQUAL0 )
+    {
+      is_0_superset = c->is_0_superset;
+      is_0_subset = c->is_0_subset;
+    }
+    if ( c->label != NULL || c->label0 != NULL )
+    {
+      co e = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+      assert( e != NULL );
+      coMapAdd(e, "index", coNewDbl(i));
+      //coMapAdd(e, "label", coNewStr(CO_STRDUP, label));
+      
+      if ( c->is_empty >= 0 )
       {
-        assert(arg != NULL);
-        bcp_ShowBCL(p, arg);
+        coMapAdd(e, "empty", coNewDbl(c->is_empty));          
       }
-      // intersection0: calculate intersection with slot 0
-      // result is stored in slot 0
-      else if ( p != NULL &&  strcmp(cmd, "intersection0") == 0 )
+
+      if ( is_0_superset >= 0 )
       {
-        int intersection_result;
-        assert(slot_list[0] != NULL);
-        assert(arg != NULL);
-        bcp_IntersectionBCL(p, slot_list[0], arg);   // a = a intersection with b 
-        assert(intersection_result != 0);
-        is_empty = 0;
-        if ( slot_list[0]->cnt == 0 )
-          is_empty = 1;
+        coMapAdd(e, "superset", coNewDbl(is_0_superset));          
       }
-      else if ( p != NULL &&  strcmp(cmd, "subtract0") == 0 )
+
+      if ( is_0_subset >= 0 )
       {
-        int subtract_result;
-        assert(slot_list[0] != NULL);
-        assert(arg != NULL);
-        bcp_SubtractBCL(p, slot_list[0], arg, 1);   // a = a minus b 
-        assert(subtract_result != 0);
-        is_empty = 0;
-        if ( slot_list[0]->cnt == 0 )
-          is_empty = 1;
+        coMapAdd(e, "subset", coNewDbl(is_0_subset));          
       }
-      else if ( p != NULL &&  strcmp(cmd, "equal0") == 0 )
+      
+      if ( c->bcl_output != NULL )
       {
-        assert(slot_list[0] != NULL);
-        assert(arg != NULL);
-        is_0_superset = bcp_IsBCLSubset(p, slot_list[0], arg);       //   test, whether "arg" is a subset of "slot_list[0]": 1 if slot_list[0] is a superset of "arg"
-        is_0_subset = bcp_IsBCLSubset(p, arg, slot_list[0]);
+        coMapAdd(e, "bcl", c->bcl_output);
+        c->bcl_output = NULL;
+        if ( c->is_expr_output )
+        {
+          coMapAdd(e, "expr", coNewStr(CO_STRFREE, c->expr_output));
+          c->expr_output = NULL;
+        }
       }
-      else if ( p != NULL &&  strcmp(cmd, "exchange0") == 0 )
+      
+      if ( c->stat_output != NULL )
       {
-        bcl tmp;
-        assert(slot_list[0] != NULL);
-        assert(slot_list[slot] != NULL);
-        tmp = slot_list[slot];
-        slot_list[slot] = slot_list[0];
-        slot_list[0] = tmp;
+        coMapAdd(e, "stat", c->stat_output);
+        c->stat_output = NULL;
       }
-      else if ( p != NULL &&  strcmp(cmd, "copy0") == 0 )
+      
+      if ( c->error != NULL )
       {
-        if ( slot_list[slot] == NULL )
-          slot_list[slot] = bcp_NewBCL(p);
-        assert( slot_list[slot] != NULL );
-        assert( slot_list[0] != NULL );        
-        bcp_CopyBCL(p, slot_list[slot], slot_list[0]);
+        coMapAdd(e, "error", coNewStr(CO_STRDUP, c->error));
       }
       
+      coMapAdd(output, c->label0 != NULL?c->label0:c->label, e);
+    } // label
+  }
+  return output;
+}
 
-      // STEP 3: Generate JSON output
-    
-      if ( label != NULL || label0 != NULL )
-      {
-        co e = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
-        assert( e != NULL );
-        coMapAdd(e, "index", coNewDbl(i));
-        //coMapAdd(e, "label", coNewStr(CO_STRDUP, label));
-        
-        if ( is_empty >= 0 )
-        {
-          coMapAdd(e, "empty", coNewDbl(is_empty));          
-        }
+/*============================================================*/
 
-        if ( is_0_superset >= 0 )
-        {
-          coMapAdd(e, "superset", coNewDbl(is_0_superset));          
-        }
+bcj bc_NewBCJ(int slot_cnt)
+{
+  bcj j = (bcj)malloc(sizeof(struct bcj_struct));
+  if ( j == NULL )
+    return NULL;
+  if ( slot_cnt <= 0 )
+    slot_cnt = BCJ_DEFAULT_SLOT_CNT;
+  j->p = NULL;
+  j->slot_cnt = slot_cnt;
+  j->is_var_check = 0;
+  j->cmd_list = NULL;
+  j->task_list = NULL;
+  j->error = NULL;
+  j->error_idx = -1;
+  j->slot_list = (bcl *)calloc(slot_cnt, sizeof(bcl));
+  if ( j->slot_list == NULL )
+    return free(j), NULL;
+  return j;
+}
 
-        if ( is_0_subset >= 0 )
-        {
-          coMapAdd(e, "subset", coNewDbl(is_0_subset));          
-        }
-        
-        if ( label0 != NULL && slot_list[0] != NULL )
+void bc_DeleteBCJ(bcj j)
+{
+  int i;
+  for( i = 0; i < j->slot_cnt; i++ )
+    if ( j->slot_list[i] != NULL )
+      bcp_DeleteBCL(j->p, j->slot_list[i]);
+  free(j->slot_list);
+  bcp_Delete(j->p);
+  free(j);
+}
+
+/*
+  Execute the json command vector "in" with the slots of "j", use "thread_cnt" threads.
+  The problem of "j" is created by the first vector. Later vectors may only use the 
+  variables of this problem, an expression with a new variable is ignored.
+  A command with an invalid bcl or an empty argument slot is skipped, the first of these
+  errors is stored in j->error and j->error_idx, j->error is NULL if all commands were executed.
+  returns the output map or NULL for memory error
+*/
+co bc_ExecuteBCJ(bcj j, cco in, int thread_cnt)
+{
+  long cnt = coVectorSize(in);
+  long i, task_cnt;
+  int wave_cnt;
+  cco o;
+  co output;
+  
+  assert( coIsVector(in) );
+  j->cmd_list = (struct bcj_cmd_struct *)calloc(cnt+1, sizeof(struct bcj_cmd_struct));
+  j->task_list = NULL;
+  j->error = NULL;
+  j->error_idx = -1;
+  if ( j->cmd_list == NULL )
+    return NULL;
+  j->is_var_check = j->p != NULL;
+
+  // PRE PHASE: Collect all variable names
+  for( i = 0; i < cnt && j->is_var_check == 0; i++ )
+  {
+    cco cmdmap = coVectorGet(in, i);
+    if ( coIsMap(cmdmap) )
+    {
+      o = coMapGet(cmdmap, "expr");             // "expr" is an alternative way to describe a bcl
+      if (coIsStr(o))                     // only of the expr is a string and only of the bcl has not been assigned before
+      {
+        const char *expr_str = coStrGet(o);        
+        bcx x;
+        if ( j->p == NULL )
         {
-          int j;
-          co v = coNewVector(CO_FREE_VALS);
-          for( j = 0; j <  slot_list[0]->cnt; j++ )
-          {
-            coVectorAdd( v, coNewStr(CO_STRDUP, bcp_GetStringFromCube(p, bcp_GetBCLCube(p, slot_list[0], j))));
-          }
-          coMapAdd(e, "bcl", v);
-          if ( p->x_var_cnt == p->var_cnt )
-          {
-            coMapAdd(e, "expr", coNewStr(CO_STRFREE, bcp_GetExpressionBCL(p, slot_list[0])));
-          }
+          j->p = bcp_New(0);               // create a dummy bcp
+          assert( j->p != NULL );
         }
-        
-        coMapAdd(output, label0 != NULL?label0:label, e);
-      } // label
-    } // isMap
-    
-  } // for all cmd maps
-  
-  // Memory cleanup
+        x = bcp_Parse(j->p, expr_str, 0);              // no propagation required, we are just collecting the names
+        if ( x != NULL )
+            bcp_DeleteBCX(j->p, x);                      // free the expression tree
+      }
+    }
+  }
   
-  for( i = 0; i < SLOT_CNT; i++ )
-    if ( slot_list[i] != NULL )
-      bcp_DeleteBCL(p, slot_list[i]);
-    
-  if ( l != NULL )
-      bcp_DeleteBCL(p, l);
+  if ( j->p != NULL && j->is_var_check == 0 )      // if a dummy bcp had been created, then convert that bcp to a regular bcp
+  {
+      bcp_UpdateFromBCX(j->p);
+  }
 
-  bcp_Delete(p);
+  // PARSE PHASE: Read all commands and convert the bcl/expr arguments
+  for( i = 0; i < cnt; i++ )
+  {
+    cco cmdmap = coVectorGet(in, i);
+    j->cmd_list[i].is_empty = -1;
+    j->cmd_list[i].is_0_superset = -1;
+    j->cmd_list[i].is_0_subset = -1;
+    if ( coIsMap(cmdmap) )
+      bcj_ReadCmd(j, cmdmap, j->cmd_list+i);
+  }
   
-  coWriteJSON(output, 0, 1, stdout); // isUTF8 is 0, then output char codes >=128 via \u 
-  coDelete(output);
+  // MAIN PHASE: Execute the independent commands in parallel
+  task_cnt = bcj_BuildTaskList(j, cnt, &wave_cnt);
+  if ( task_cnt >= 0 )
+    bcj_ExecuteTaskList(j, task_cnt, thread_cnt);
+  
+  // OUTPUT PHASE
+  output = task_cnt >= 0 ? bcj_NewOutput(j, cnt) : NULL;
   
+  // Memory cleanup, the slots are kept
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( j->cmd_list[i].error != NULL && j->error == NULL )
+    {
+      j->error = j->cmd_list[i].error;
+      j->error_idx = i;
+    }
+    if ( j->cmd_list[i].l != NULL )
+      bcp_DeleteBCL(j->p, j->cmd_list[i].l);
+    if ( j->cmd_list[i].bcl_output != NULL )
+      coDelete(j->cmd_list[i].bcl_output);
+    if ( j->cmd_list[i].stat_output != NULL )
+      coDelete(j->cmd_list[i].stat_output);
+    free(j->cmd_list[i].expr_output);
+  }
+  free(j->cmd_list);
+  free(j->task_list);
+  j->cmd_list = NULL;
+  j->task_list = NULL;
+  return output;
+}
+
+/*
+  Execute the json command vector "in" with "slot_cnt" slots and "thread_cnt" threads 
+  and write the result to "out".
+  returns 0 for memory error
+*/
+int bc_ExecuteVector(cco in, int slot_cnt, int thread_cnt, FILE *out)
+{
+  co output;
+  bcj j = bc_NewBCJ(slot_cnt);
+  if ( j == NULL )
+    return 0;
+  output = bc_ExecuteBCJ(j, in, thread_cnt);
+  bc_DeleteBCJ(j);
+  if ( output == NULL )
+    return 0;
+  coWriteJSON(output, 0, 1, out); // isUTF8 is 0, then output char codes >=128 via \u 
+  coDelete(output);
   return 1;
 }
 
-int bc_ExecuteJSON(FILE *fp)
+int bc_ExecuteJSON(FILE *fp, int slot_cnt, int thread_cnt)
 {
   co in = coReadJSONByFP(fp);
   if ( in == NULL )
     return puts("JSON read errror"), 0;
-  bc_ExecuteVector(in);
+  bc_ExecuteVector(in, slot_cnt, thread_cnt, stdout);
   coDelete(in);
   return 1;
 }
-
@@ -0,0 +1,226 @@
+/*
+
+  bclbinary.c
+
+  binary file format for a bcl, which can be mapped into memory without parsing
+
+  layout of the file (native byte order):
+    struct bcl_binary_header
+    name_cnt variable names, each terminated by '\0', name i is the name of variable i
+    cnt cubes with blk_cnt blocks each, the first cube starts at header_size, which is a multiple of 64
+
+  A list, which is loaded with bcp_NewBCLByBinaryFile(), uses the cubes of the file directly.
+  The file is mapped copy on write, so the list can be modified like any other list, the file
+  itself is never changed. The mapping is released by bcp_DeleteBCL() or as soon as the list
+  has to grow (the cubes are copied to the heap in this case).
+
+*/
+
+#include "bc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define BCL_BINARY_MAGIC "BCLBIN1"
+#define BCL_BINARY_BYTE_ORDER 0x01020304
+#define BCL_BINARY_ALIGN 64
+
+struct bcl_binary_header
+{
+  char magic[8];                // BCL_BINARY_MAGIC
+  uint32_t byte_order;          // BCL_BINARY_BYTE_ORDER
+  uint32_t header_size;         // offset of the first cube, includes the variable names
+  int32_t var_cnt;
+  int32_t blk_cnt;              // blocks per cube, might differ from the blk_cnt of the loading problem
+  int32_t name_cnt;             // number of variable names, between 0 and var_cnt
+  uint32_t name_size;           // number of bytes of all names including the '\0' chars
+  uint64_t cnt;                 // number of cubes
+};
+
+/* returns the variable name for position "i" or NULL */
+static const char *bcp_GetBinaryVarName(bcp p, int i)
+{
+  cco s;
+  if ( p->var_list == NULL || i >= coVectorSize(p->var_list) )
+    return NULL;
+  s = coVectorGet(p->var_list, i);
+  if ( s == NULL )
+    return NULL;
+  return coStrGet(s);
+}
+
+/* write the valid cubes of "l" and the variable names of "p" into file "name", returns 0 for error */
+int bcp_SaveBCLBinaryFile(bcp p, bcl l, const char *name)
+{
+  struct bcl_binary_header h;
+  static const char zero[BCL_BINARY_ALIGN] = { 0 };
+  const char *s;
+  size_t pos;
+  int i;
+  FILE *fp;
+
+  if ( p->var_map != NULL && p->var_list == NULL )
+    if ( bcp_BuildVarList(p) == 0 )
+      return 0;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, BCL_BINARY_MAGIC, sizeof(BCL_BINARY_MAGIC));
+  h.byte_order = BCL_BINARY_BYTE_ORDER;
+  h.var_cnt = p->var_cnt;
+  h.blk_cnt = p->blk_cnt;
+  h.name_cnt = p->var_map == NULL ? 0 : p->x_var_cnt;
+  if ( h.name_cnt > p->var_cnt )
+    h.name_cnt = p->var_cnt;
+  for( i = 0; i < h.name_cnt; i++ )
+  {
+    s = bcp_GetBinaryVarName(p, i);
+    h.name_size += strlen(s == NULL ? "" : s) + 1;
+  }
+  pos = sizeof(h) + h.name_size;
+  h.header_size = (pos + BCL_BINARY_ALIGN - 1) / BCL_BINARY_ALIGN * BCL_BINARY_ALIGN;
+  for( i = 0; i < l->cnt; i++ )
+    if ( (l->flags[i] & 1) == 0 )
+      h.cnt++;
+
+  fp = fopen(name, "wb");
+  if ( fp == NULL )
+    return 0;
+  if ( fwrite(&h, sizeof(h), 1, fp) != 1 )
+    return fclose(fp), 0;
+  for( i = 0; i < h.name_cnt; i++ )
+  {
+    s = bcp_GetBinaryVarName(p, i);
+    if ( s == NULL )
+      s = "";
+    if ( fwrite(s, strlen(s) + 1, 1, fp) != 1 )
+      return fclose(fp), 0;
+  }
+  if ( h.header_size > pos && fwrite(zero, h.header_size - pos, 1, fp) != 1 )
+    return fclose(fp), 0;
+  for( i = 0; i < l->cnt; i++ )
+    if ( (l->flags[i] & 1) == 0 )
+      if ( fwrite(bcp_GetBCLCube(p, l, i), p->bytes_per_cube_cnt, 1, fp) != 1 )
+        return fclose(fp), 0;
+  if ( fclose(fp) != 0 )
+    return 0;
+  return 1;
+}
+
+/*
+  map file "name" copy on write into memory and check the header
+  returns the header (which is also the start of the mapping) or NULL
+*/
+static struct bcl_binary_header *bcp_MapBinaryFile(const char *name, size_t *map_size)
+{
+  struct stat st;
+  struct bcl_binary_header *h;
+  void *m;
+  int fd = open(name, O_RDONLY);
+  if ( fd < 0 )
+    return NULL;
+  if ( fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct bcl_binary_header) )
+    return close(fd), NULL;
+  m = mmap(NULL, (size_t)st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);            // the mapping is still valid
+  if ( m == MAP_FAILED )
+    return NULL;
+  *map_size = (size_t)st.st_size;
+
+  h = (struct bcl_binary_header *)m;
+  if ( memcmp(h->magic, BCL_BINARY_MAGIC, sizeof(BCL_BINARY_MAGIC)) != 0
+    || h->byte_order != BCL_BINARY_BYTE_ORDER
+    || h->var_cnt < 0 || h->blk_cnt <= 0 || h->var_cnt > h->blk_cnt*64
+    || h->name_cnt < 0 || h->name_cnt > h->var_cnt
+    || h->header_size % BCL_BINARY_ALIGN != 0
+    || h->header_size < sizeof(struct bcl_binary_header) + h->name_size
+    || h->header_size > *map_size
+    || h->cnt > INT_MAX
+    || h->cnt > (*map_size - h->header_size) / ((size_t)h->blk_cnt*sizeof(__m128i)) )
+    return munmap(m, *map_size), NULL;
+  if ( h->name_size > 0 && ((const char *)m)[sizeof(struct bcl_binary_header) + h->name_size - 1] != '\0' )
+    return munmap(m, *map_size), NULL;
+  return h;
+}
+
+/* new problem with the number of variables and the variable names from the file, returns NULL for error */
+bcp bcp_NewByBinaryFile(const char *name)
+{
+  size_t map_size;
+  const char *s, *e;
+  int i;
+  bcp p;
+  struct bcl_binary_header *h = bcp_MapBinaryFile(name, &map_size);
+  if ( h == NULL )
+    return NULL;
+  p = bcp_New(h->var_cnt);
+  if ( p == NULL )
+    return munmap(h, map_size), NULL;
+  s = (const char *)(h + 1);
+  e = s + h->name_size;
+  for( i = 0; i < h->name_cnt; i++ )
+  {
+    if ( s >= e || bcp_AddVar(p, s) == 0 )
+      return bcp_Delete(p), munmap(h, map_size), NULL;
+    s += strlen(s) + 1;
+  }
+  munmap(h, map_size);
+  return p;
+}
+
+/*
+  create a new list with the cubes of file "name", the number of variables must be the same for the file and "p"
+  The cubes are not copied if the list is created outside of an arena frame and the file has the same blk_cnt as "p".
+  returns NULL for memory error or an invalid file
+*/
+bcl bcp_NewBCLByBinaryFile(bcp p, const char *name)
+{
+  size_t map_size;
+  bcl l;
+  int i, pos, cnt, blk_cnt;
+  struct bcl_binary_header *h = bcp_MapBinaryFile(name, &map_size);
+  __m128i *list;
+  bc c;
+  if ( h == NULL )
+    return NULL;
+  if ( h->var_cnt != p->var_cnt )
+    return munmap(h, map_size), NULL;
+  cnt = (int)h->cnt;
+  list = (__m128i *)((uint8_t *)h + h->header_size);
+  l = bcp_NewBCL(p);
+  if ( l == NULL )
+    return munmap(h, map_size), NULL;
+
+  if ( l->is_arena == 0 && h->blk_cnt == p->blk_cnt && cnt > 0 )
+  {
+    l->flags = (uint8_t *)calloc(cnt, sizeof(uint8_t));
+    l->sig = (uint64_t *)malloc(cnt*sizeof(uint64_t));
+    if ( l->flags == NULL || l->sig == NULL )
+      return bcp_DeleteBCL(p, l), munmap(h, map_size), NULL;
+    l->list = list;
+    l->map_addr = h;
+    l->map_size = map_size;
+    l->cnt = cnt;
+    l->max = cnt;
+    return l;
+  }
+
+  /* different simd level or arena list: copy the cubes, additional blocks contain only don't cares */
+  blk_cnt = h->blk_cnt < p->blk_cnt ? h->blk_cnt : p->blk_cnt;
+  if ( bcp_ReserveBCL(p, l, cnt) == 0 )
+    return bcp_DeleteBCL(p, l), munmap(h, map_size), NULL;
+  for( i = 0; i < cnt; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    c = bcp_GetBCLCube(p, l, pos);
+    memset(c, 0xff, p->bytes_per_cube_cnt);
+    memcpy(c, list + (size_t)i*h->blk_cnt, blk_cnt*sizeof(__m128i));
+  }
+  munmap(h, map_size);
+  return l;
+}
@@ -4,19 +4,23 @@
   
   boolean cube list: complement calculation
 
-  There are two ways to calculate the complement
+  There are three ways to calculate the complement
     1) Via substract from the tautology cube
     2) Via recursiv split
+    3) Via unate recursive paradigm (URP, as in espresso)
     
-  This code defines both algorithms, but at the moment the substract from the
-  tautology cube seems to be faster.
+  For unate lists, the substract from the tautology cube is faster and will
+  generate all prime cubes of the complement. For binate lists the intermediate
+  results of the subtract become very large, so the URP algorithm is used.
   
   This code defines also 
     bcl bcp_NewBCLComplement(bcp p, bcl l)
-  which just calles "bcp_NewBCLComplementWithSubtract"
+  which selects one of the algorithms
   
 */
 #include "bc.h"
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 /*
@@ -25,13 +29,18 @@
 bcl bcp_NewBCLComplementWithSubtract(bcp p, bcl l)
 {
     bcl result = bcp_NewBCL(p);
+    bct t;
     int is_mcc = 1;
     if ( result == NULL )
       return NULL;
+    t = bcp_NewBCT(p);
+    if ( t == NULL )
+      return bcp_DeleteBCL(p, result), NULL;
   
-    bcp_CalcBCLBinateSplitVariableTable(p, l);
-    if ( bcp_IsBCLUnate(p) )
+    bcp_CalcBCLBinateSplitVariableTable(p, t, l);
+    if ( bcp_IsBCLUnate(p, t) )
       is_mcc = 0;
+    bcp_DeleteBCT(p, t);
     if ( bcp_AddBCLCubeByCube(p, result, bcp_GetGlobalCube(p, 3)) < 0)  // 3: universal cube
       return bcp_DeleteBCL(p, result), NULL;
     bcp_SubtractBCL(p, result, l, is_mcc);             // "result" contains the negation of "l"
@@ -39,13 +48,40 @@ bcl bcp_NewBCLComplementWithSubtract(bcp p, bcl l)
     // do a small minimization step
     bcp_DoBCLExpandWithOffSet(p, result, l);   // not sure whether this will help, cubes might be already max due to the sharp operation
     bcp_DoBCLMultiCubeContainment(p, result);
+    bcp_ShrinkBCL(p, result);
 
     return result;
 }
 
+/*
+  returns the complement of "l" or NULL for memory error
+  
+  bcl arena: The complement may be called inside a bcl arena frame (bcp_DoBCLReduce()), then the 
+  result and all intermediate lists are allocated from this frame and the result must not be used 
+  after the frame has been closed. This is safe, because the complement itself does not open a 
+  frame while it grows one of its lists: The frames of bcp_IsBCLCubeCovered(), bcp_IsBCLCubeRedundant()
+  (bclcontainment.c) and of the tautology test (bcltautology.c) are closed, before the calling 
+  function adds cubes to its lists again. bcp_ResizeBCL() asserts this for all arena lists.
+  Outside of a frame, all lists are malloc'ed as before.
+*/
 bcl bcp_NewBCLComplement(bcp p, bcl l)
 {
-  return bcp_NewBCLComplementWithSubtract(p, l);
+  bct t;
+  bcl result;
+  int is_unate;
+  bcp_StartStatOp(p, BCP_STAT_OP_COMPLEMENT);
+  t = bcp_NewBCT(p);
+  if ( t == NULL )
+    return bcp_EndStatOp(p, BCP_STAT_OP_COMPLEMENT), NULL;
+  bcp_CalcBCLBinateSplitVariableTable(p, t, l);
+  is_unate = bcp_IsBCLUnate(p, t);
+  bcp_DeleteBCT(p, t);
+  if ( is_unate )
+    result = bcp_NewBCLComplementWithSubtract(p, l);
+  else
+    result = bcp_NewBCLComplementWithURP(p, l);
+  bcp_EndStatOp(p, BCP_STAT_OP_COMPLEMENT);
+  return result;
 }
 
 
@@ -61,6 +97,7 @@ bcl bcp_NewBCLComplementWithCofactorSub(bcp p, bcl l)
   bcl f2;
   bcl cf1;
   bcl cf2;
+  bct t;
  
   /*
   if ( l->cnt <= 14 )
@@ -70,8 +107,12 @@ bcl bcp_NewBCLComplementWithCofactorSub(bcp p, bcl l)
   */
     
   
-  bcp_CalcBCLBinateSplitVariableTable(p, l);
-  var_pos = bcp_GetBCLMaxBinateSplitVariable(p, l);
+  t = bcp_NewBCT(p);
+  if ( t == NULL )
+    return NULL;
+  bcp_CalcBCLBinateSplitVariableTable(p, t, l);
+  var_pos = bcp_GetBCLMaxBinateSplitVariable(p, t, l);
+  bcp_DeleteBCT(p, t);
   if ( var_pos < 0 )
   {
     bcl result = bcp_NewBCL(p);
@@ -99,12 +140,14 @@ bcl bcp_NewBCLComplementWithCofactorSub(bcp p, bcl l)
   for( i = 0; i < cf1->cnt; i++ )
     if ( cf1->flags[i] == 0 )
       bcp_SetCubeVar(p, bcp_GetBCLCube(p, cf1, i), var_pos, 2);  
+  bcp_InvalidateBCLSlice(p, cf1);       // cubes of cf1 had been modified directly
   //bcp_DoBCLSimpleExpand(p, cf1);
   bcp_DoBCLSingleCubeContainment(p, cf1);
 
   for( i = 0; i < cf2->cnt; i++ )
     if ( cf2->flags[i] == 0 )
       bcp_SetCubeVar(p, bcp_GetBCLCube(p, cf2, i), var_pos, 1);  
+  bcp_InvalidateBCLSlice(p, cf2);
   //bcp_DoBCLSimpleExpand(p, cf2);
   bcp_DoBCLSingleCubeContainment(p, cf2);
 
@@ -135,6 +178,7 @@ bcl bcp_NewBCLComplementWithCofactorSub(bcp p, bcl l)
       bcp_SetCubeVar(p, c, var_pos, 1);  // undo the change in the cube from cf2
     }
   }
+  bcp_InvalidateBCLSlice(p, cf1);       // cubes of cf1 had been modified directly
 
   bcp_DeleteBCL(p, f1);
   bcp_DeleteBCL(p, f2);
@@ -161,4 +205,347 @@ bcl bcp_NewBCLComplementWithCofactor(bcp p, bcl l)
   return n;
 }
 
+/*============================================================*/
+/* unate recursive paradigm */
+
+/* 
+  append the complement of cube "c" to "r" (De Morgan): one cube for each literal of "c" 
+  returns 0 for memory error
+*/
+static int bcp_AddBCLComplementOfCube(bcp p, bcl r, bc c)
+{
+  int i, pos;
+  unsigned v;
+  for( i = 0; i < p->var_cnt; i++ )
+  {
+    v = bcp_GetCubeVar(p, c, i);
+    if ( v == 1 || v == 2 )
+    {
+      pos = bcp_AddBCLCubeByCube(p, r, bcp_GetGlobalCube(p, 3));
+      if ( pos < 0 )
+        return 0;
+      bcp_SetCubeVar(p, bcp_GetBCLCube(p, r, pos), i, v ^ 3);
+      bcp_UpdateBCLSignature(p, r, pos);
+    }
+  }
+  return 1;
+}
 
+/* 
+  Shannon cofactor of "l" for the variable at "var_pos": keep all cubes, which contain "value" (1 or 2)
+  at "var_pos" and set the variable to don't care. Cubes with the other value are not copied.
+*/
+static bcl bcp_NewBCLShannonCofactor(bcp p, bcl l, int var_pos, unsigned value)
+{
+  int i, pos;
+  unsigned v;
+  bcl n = bcp_NewBCL(p);
+  if ( n == NULL )
+    return NULL;
+  if ( bcp_ReserveBCL(p, n, l->cnt) == 0 )
+    return bcp_DeleteBCL(p, n), NULL;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    v = bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, i), var_pos);
+    if ( (v & value) != 0 )
+    {
+      pos = bcp_AddBCLCubeByCube(p, n, bcp_GetBCLCube(p, l, i));
+      bcp_SetCubeVar(p, bcp_GetBCLCube(p, n, pos), var_pos, 3);
+      bcp_UpdateBCLSignature(p, n, pos);
+    }
+  }
+  return n;
+}
+
+/* 
+  append the product of the cubes of "a" and "b" to "r". If "a" and "b" do not have any common variable,
+  this is the intersection of "a" and "b", because two cubes without common variable will always intersect
+  returns 0 for memory error
+*/
+static int bcp_AddBCLProduct(bcp p, bcl r, bcl a, bcl b)
+{
+  int i, j;
+  bc c;
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  if ( bcp_ReserveBCL(p, r, r->cnt + a->cnt*b->cnt) == 0 )
+    return bcp_EndCubeStackFrame(p), 0;
+  for( i = 0; i < a->cnt; i++ )
+    for( j = 0; j < b->cnt; j++ )
+      if ( bcp_IntersectionCube(p, c, bcp_GetBCLCube(p, a, i), bcp_GetBCLCube(p, b, j)) )
+        if ( bcp_AddBCLCubeByCube(p, r, c) < 0 )
+          return bcp_EndCubeStackFrame(p), 0;
+  bcp_EndCubeStackFrame(p);
+  return 1;
+}
+
+/*
+  set a bit in "lift" for each cube of "a", which is a subset of any cube in "b"
+  "lift" and "mask" must have bcp_GetBCLSlice(p, a)->word_cnt entries
+  returns 0 for memory error
+*/
+static int bcp_GetBCLSubsetOfAnyMask(bcp p, bcl a, bcl b, uint64_t *lift, uint64_t *mask)
+{
+  bcs s = bcp_GetBCLSlice(p, a);
+  int i, w;
+  if ( s == NULL )
+    return 0;
+  memset(lift, 0, s->word_cnt*sizeof(uint64_t));
+  for( i = 0; i < b->cnt; i++ )
+    if ( bcp_GetBCLSliceSubsetMask(p, a, bcp_GetBCLCube(p, b, i), mask) )
+      for( w = 0; w < s->word_cnt; w++ )
+        lift[w] |= mask[w];
+  return 1;
+}
+
+/*
+  "cf1" and "cf2" are the complements of the cofactors for zero and one at "var_pos":
+  The cubes of "cf1" get the zero literal, the cubes of "cf2" get the one literal, then both lists are added to "r".
+  A cube, which is a subset of a cube in the other list, does not need the literal (cube merging step of espresso).
+  Identical cubes will become identical and are removed by SCC.
+  The subset checks are done with the bit sliced view of "cf1" and "cf2".
+  "cf1" and "cf2" are modified. returns 0 for memory error
+*/
+static int bcp_AddBCLMergedCofactorComplements(bcp p, bcl r, bcl cf1, bcl cf2, int var_pos)
+{
+  int i;
+  int word_cnt = ((cf1->cnt > cf2->cnt ? cf1->cnt : cf2->cnt) + 127) / 128 * 2 + 2;
+  uint64_t *lift1 = (uint64_t *)malloc(word_cnt*sizeof(uint64_t));
+  uint64_t *lift2 = (uint64_t *)malloc(word_cnt*sizeof(uint64_t));
+  uint64_t *mask = (uint64_t *)malloc(word_cnt*sizeof(uint64_t));
+  int is_ok = 0;
+  
+  if ( lift1 != NULL && lift2 != NULL && mask != NULL )
+    if ( bcp_GetBCLSubsetOfAnyMask(p, cf1, cf2, lift1, mask) && bcp_GetBCLSubsetOfAnyMask(p, cf2, cf1, lift2, mask) )
+      is_ok = 1;
+  free(mask);
+  if ( is_ok )
+  {
+    for( i = 0; i < cf1->cnt; i++ )
+      if ( ((lift1[i/64] >> (i&63)) & 1) == 0 )
+        bcp_SetCubeVar(p, bcp_GetBCLCube(p, cf1, i), var_pos, 1);
+    for( i = 0; i < cf2->cnt; i++ )
+      if ( ((lift2[i/64] >> (i&63)) & 1) == 0 )
+        bcp_SetCubeVar(p, bcp_GetBCLCube(p, cf2, i), var_pos, 2);
+    bcp_InvalidateBCLSlice(p, cf1);       // cubes of cf1 and cf2 had been modified directly
+    bcp_InvalidateBCLSlice(p, cf2);
+  }
+  free(lift1);
+  free(lift2);
+  if ( is_ok == 0 )
+    return 0;
+  if ( bcp_AddBCLCubesByBCL(p, r, cf1) == 0 || bcp_AddBCLCubesByBCL(p, r, cf2) == 0 )
+    return 0;
+  bcp_DoBCLSingleCubeContainment(p, r);
+  return 1;
+}
+
+static bcl bcp_NewBCLComplementWithURPSub(bcp p, bcl l);
+
+/*
+  Calculate the complement of "f1" and "f2" and combine them into "r". "f1" and "f2" are deleted.
+  "f1" and "f2" are the cofactors for zero and one at "var_pos"
+  Returns "r" or NULL for memory error ("r" is deleted in this case).
+*/
+static bcl bcp_NewBCLComplementWithURPMerge(bcp p, bcl r, bcl f1, bcl f2, int var_pos)
+{
+  bcl cf1 = NULL;
+  bcl cf2 = NULL;
+  int is_ok = 0;
+  
+  if ( f1 != NULL && f2 != NULL )
+  {
+    cf1 = bcp_NewBCLComplementWithURPSub(p, f1);
+    if ( cf1 != NULL )
+      cf2 = bcp_NewBCLComplementWithURPSub(p, f2);
+  }
+  if ( f1 != NULL )
+    bcp_DeleteBCL(p, f1);
+  if ( f2 != NULL )
+    bcp_DeleteBCL(p, f2);
+  if ( cf1 != NULL && cf2 != NULL )
+    is_ok = bcp_AddBCLMergedCofactorComplements(p, r, cf1, cf2, var_pos);
+  if ( cf1 != NULL )
+    bcp_DeleteBCL(p, cf1);
+  if ( cf2 != NULL )
+    bcp_DeleteBCL(p, cf2);
+  if ( is_ok == 0 )
+    return bcp_DeleteBCL(p, r), NULL;
+  return r;
+}
+
+/*
+  "g" has "k" independent partitions, marked in the flags by bcp_GetBCLPartition().
+  The complement is the product of the complements of the partitions: !(g1 | g2 | ...) = !g1 & !g2 & ...
+  The result is stored in "r". "g" is deleted. Returns "r" or NULL for memory error ("r" is deleted in this case).
+*/
+static bcl bcp_NewBCLComplementWithURPPartition(bcp p, bcl r, bcl g, int k)
+{
+  int i, is_ok;
+  bcl acc = NULL;
+  bcl c, n;
+  bcl *f = (bcl *)malloc(k*sizeof(bcl));
+  
+  is_ok = f != NULL && bcp_NewBCLsByPartition(p, g, k, f) != 0;
+  bcp_DeleteBCL(p, g);
+  if ( is_ok == 0 )
+    return free(f), bcp_DeleteBCL(p, r), NULL;
+  for( i = 0; i < k && is_ok; i++ )
+  {
+    c = bcp_NewBCLComplementWithURPSub(p, f[i]);
+    if ( c == NULL )
+      is_ok = 0;
+    else if ( acc == NULL )
+      acc = c;
+    else
+    {
+      n = bcp_NewBCL(p);
+      if ( n == NULL || bcp_AddBCLProduct(p, n, acc, c) == 0 )
+        is_ok = 0;
+      bcp_DeleteBCL(p, acc);
+      bcp_DeleteBCL(p, c);
+      acc = n;
+    }
+    if ( acc != NULL && acc->cnt == 0 )
+      break;            // empty product, one partition is a tautology
+  }
+  for( i = 0; i < k; i++ )
+    bcp_DeleteBCL(p, f[i]);
+  free(f);
+  if ( is_ok && bcp_MoveBCL(p, r, acc) != 0 )
+    return bcp_DeleteBCL(p, acc), r;
+  if ( acc != NULL )
+    bcp_DeleteBCL(p, acc);
+  return bcp_DeleteBCL(p, r), NULL;
+}
+
+/*
+  "l" must not contain deleted cubes. "l" is not modified.
+  Steps:
+    0. Lists with up to BCP_TRUTH_TABLE_MAX_VAR_CNT active variables are complemented with a truth table
+    1. Shortcuts: empty list, list with the universal cube and list with one cube 
+    2. All cubes have some literals in common (cube "c"): l = c & l' --> !l = !c | !l'
+    3. Unate list: subtract from the universal cube, which generates the exact prime complement
+    4. Partition into k lists with disjoint variables: !(l1 | l2 | ...) = !l1 & !l2 & ... (product of the cubes)
+    5. Split with the most binate variable x: !l = !x & !l(x=0) | x & !l(x=1), 
+        cubes, which are part of both results, will not get the x literal
+*/
+static bcl bcp_NewBCLComplementWithURPSub(bcp p, bcl l)
+{
+  int i, j, var_pos;
+  bcl r;
+  bcl f1, f2;
+  bcl cf1;
+  bct t;
+  bc c;
+  
+  /* 0. only a few active variables: use a truth table */
+  r = bcp_NewBCLComplementWithTruthTable(p, l);
+  if ( r != NULL )
+    return r;
+  
+  r = bcp_NewBCL(p);
+  if ( r == NULL )
+    return NULL;
+  
+  /* 1. shortcuts */
+  if ( l->cnt == 0 )
+  {
+    if ( bcp_AddBCLCubeByCube(p, r, bcp_GetGlobalCube(p, 3)) < 0 )
+      return bcp_DeleteBCL(p, r), NULL;
+    return r;
+  }
+  for( i = 0; i < l->cnt; i++ )
+    if ( bcp_IsTautologyCube(p, bcp_GetBCLCube(p, l, i)) )
+      return r;         // complement of the universal cube is empty
+  if ( l->cnt == 1 )
+  {
+    if ( bcp_AddBCLComplementOfCube(p, r, bcp_GetBCLCube(p, l, 0)) == 0 )
+      return bcp_DeleteBCL(p, r), NULL;
+    return r;
+  }
+  
+  /* 2. common literals: a variable is a literal of c, if all cubes have the same literal */
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  bcp_CopyCube(p, c, bcp_GetBCLCube(p, l, 0));
+  for( i = 1; i < l->cnt; i++ )
+    for( j = 0; j < p->blk_cnt; j++ )
+      _mm_storeu_si128(c+j, _mm_or_si128(_mm_loadu_si128(c+j), _mm_loadu_si128(bcp_GetBCLCube(p, l, i)+j)));
+  if ( bcp_IsTautologyCube(p, c) == 0 )
+  {
+    f1 = bcp_NewBCLByBCL(p, l);
+    if ( f1 == NULL )
+      return bcp_EndCubeStackFrame(p), bcp_DeleteBCL(p, r), NULL;
+    /* l' = l without the literals of c: 01|10 and 10|01 will become don't care */
+    for( i = 0; i < f1->cnt; i++ )
+      for( j = 0; j < p->blk_cnt; j++ )
+        _mm_storeu_si128(bcp_GetBCLCube(p, f1, i)+j, 
+          _mm_or_si128(_mm_loadu_si128(bcp_GetBCLCube(p, f1, i)+j), _mm_andnot_si128(_mm_loadu_si128(c+j), _mm_set1_epi8(0xff))));
+    bcp_InvalidateBCLSlice(p, f1);      // cubes of f1 had been modified directly
+    cf1 = bcp_NewBCLComplementWithURPSub(p, f1);
+    bcp_DeleteBCL(p, f1);
+    if ( cf1 == NULL || bcp_AddBCLComplementOfCube(p, r, c) == 0 || bcp_AddBCLCubesByBCL(p, r, cf1) == 0 )
+    {
+      if ( cf1 != NULL )
+        bcp_DeleteBCL(p, cf1);
+      return bcp_EndCubeStackFrame(p), bcp_DeleteBCL(p, r), NULL;
+    }
+    bcp_DeleteBCL(p, cf1);
+    /* no SCC required: the cubes of !l' are don't care for the literals of c */
+    return bcp_EndCubeStackFrame(p), r;
+  }
+  bcp_EndCubeStackFrame(p);
+  
+  t = bcp_NewBCT(p);
+  if ( t == NULL )
+    return bcp_DeleteBCL(p, r), NULL;
+  bcp_CalcBCLBinateSplitVariableTable(p, t, l);
+  
+  /* 3. unate leaf */
+  if ( bcp_IsBCLUnate(p, t) )
+  {
+    bcp_DeleteBCT(p, t);
+    if ( bcp_AddBCLCubeByCube(p, r, bcp_GetGlobalCube(p, 3)) < 0 || bcp_SubtractBCL(p, r, l, 0) == 0 )
+      return bcp_DeleteBCL(p, r), NULL;
+    return r;
+  }
+  
+  /* 4. partition, bcp_GetBCLPartition() uses the flags, so this is done with a copy of "l" */
+  f1 = bcp_NewBCLByBCL(p, l);
+  if ( f1 == NULL )
+    return bcp_DeleteBCT(p, t), bcp_DeleteBCL(p, r), NULL;
+  i = bcp_GetBCLPartition(p, f1);
+  if ( i > 1 )
+  {
+    bcp_DeleteBCT(p, t);
+    return bcp_NewBCLComplementWithURPPartition(p, r, f1, i);
+  }
+  bcp_DeleteBCL(p, f1);
+  
+  /* 5. binate split */
+  var_pos = bcp_GetBCLMaxBinateSplitVariable(p, t, l);
+  bcp_DeleteBCT(p, t);
+  assert( var_pos >= 0 );
+  f1 = bcp_NewBCLShannonCofactor(p, l, var_pos, 1);
+  f2 = bcp_NewBCLShannonCofactor(p, l, var_pos, 2);
+  return bcp_NewBCLComplementWithURPMerge(p, r, f1, f2, var_pos);
+}
+
+/*
+  calculate the complement of "l", "l" is not modified
+*/
+bcl bcp_NewBCLComplementWithURP(bcp p, bcl l)
+{
+  bcl n;
+  bcl r;
+  if ( bcp_IsPurgeUsefull(p, l) == 0 )
+    return bcp_NewBCLComplementWithURPSub(p, l);
+  n = bcp_NewBCLByBCL(p, l);
+  if ( n == NULL )
+    return NULL;
+  bcp_PurgeBCL(p, n);
+  r = bcp_NewBCLComplementWithURPSub(p, n);
+  bcp_DeleteBCL(p, n);
+  return r;
+}
@@ -11,29 +11,28 @@
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <pthread.h>
 
 /*============================================================*/
 /* simple single covered procedure */
 
 /*
-  In the given BCL, ensure, that no cube is part of any other cube
-  This will call bcp_PurgeBCL()
+  lists with less cubes are checked by comparing all pairs of cubes, 
+  for larger lists, the bit sliced view is used
 */
-void bcp_DoBCLSingleCubeContainment(bcp p, bcl l)
+#define BCP_SCC_SLICE_MIN_CNT 64
+
+/*
+  compare each cube with each other cube, most pairs are rejected by the cube signatures
+*/
+static void bcp_DoBCLSingleCubeContainmentPairwise(bcp p, bcl l, int *vcl)
 {
   int i, j;
   int cnt = l->cnt;
   bc c;
   int vc;
-  
-  /*
-    calculate the number of 01 and 10 codes for each of the cubes in "l"
-    idea is to reduce the number of "subset" tests, because for a cube with n variables,
-    can be a subset of another cube only if this other cube has lesser variables.
-    however: also the requal case is checked, to check wether two cubes are identical
-  */
-  int *vcl = bcp_GetBCLVarCntList(p, l);
-
+  uint64_t *sig = bcp_GetBCLSignature(p, l);
+  uint64_t s;
   
   for( i = 0; i < cnt; i++ )
   {
@@ -41,6 +40,7 @@ void bcp_DoBCLSingleCubeContainment(bcp p, bcl l)
     {
       c = bcp_GetBCLCube(p, l, i);
       vc = vcl[i];
+      s = sig[i];
       for( j = 0; j < cnt; j++ )
       {
         if ( l->flags[j] == 0 )
@@ -54,7 +54,7 @@ void bcp_DoBCLSingleCubeContainment(bcp p, bcl l)
                 0: no, "b" is not a subset of "a"
               A mandatory condition for this is, that b has more variables than a
             */
-            if ( vcl[j] >= vc )
+            if ( vcl[j] >= vc && bcp_IsSignatureSubsetPossible(s, sig[j]) )
             {
               if ( bcp_IsSubsetCube(p, c, bcp_GetBCLCube(p, l, j)) != 0 )
               {
@@ -66,7 +66,105 @@ void bcp_DoBCLSingleCubeContainment(bcp p, bcl l)
       } // j loop
     } // i cube not deleted
   } // i loop
+}
+
+/*
+  Use the bit sliced view of "l" to find all subsets of a cube: Only the planes of the literals
+  of the cube are visited and each plane operation handles 128 cubes. A mask of the remaining
+  cubes is maintained, so that deleted cubes are never tested again.
+  The cubes are visited with increasing number of literals (bucket sort by "vcl"), so that
+  the largest cubes, which will remove most of the other cubes, are processed first.
+  Identical cubes are visited in the order of the list, so that always the first cube is kept.
+  returns 0 for memory error, in this case "l" is not modified
+*/
+static int bcp_DoBCLSingleCubeContainmentSlice(bcp p, bcl l, int *vcl)
+{
+  int i, k, w, vc;
+  int cnt = l->cnt;
+  bcs s;
+  int *order;
+  int *start;
+  uint64_t *live;
+  uint64_t *mask;
+  uint64_t m;
+
+  s = bcp_GetBCLSlice(p, l);
+  if ( s == NULL )
+    return 0;
+  order = (int *)malloc(sizeof(int)*cnt);
+  start = (int *)calloc(p->var_cnt+2, sizeof(int));
+  live = (uint64_t *)malloc(s->word_cnt*sizeof(uint64_t));
+  mask = (uint64_t *)malloc(s->word_cnt*sizeof(uint64_t));
+  if ( order == NULL || start == NULL || live == NULL || mask == NULL )
+  {
+    free(order); free(start); free(live); free(mask);
+    return 0;
+  }
+
+  /* bucket sort the cubes by the number of literals */
+  memset(live, 0, s->word_cnt*sizeof(uint64_t));
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( l->flags[i] == 0 )
+    {
+      start[vcl[i]+1]++;
+      live[i/64] |= ((uint64_t)1) << (i & 63);
+    }
+  }
+  for( vc = 0; vc <= p->var_cnt; vc++ )
+    start[vc+1] += start[vc];
+  for( i = 0; i < cnt; i++ )
+    if ( l->flags[i] == 0 )
+      order[start[vcl[i]]++] = i;
+  k = start[p->var_cnt];        // number of cubes, which are not deleted
+
+  for( vc = 0; vc < k; vc++ )
+  {
+    i = order[vc];
+    if ( (live[i/64] & (((uint64_t)1) << (i & 63))) == 0 )
+      continue;
+    memcpy(mask, live, s->word_cnt*sizeof(uint64_t));
+    mask[i/64] &= ~(((uint64_t)1) << (i & 63));  // a cube is not tested against itself
+    if ( bcp_AndBCLSliceSubsetMask(p, s, bcp_GetBCLCube(p, l, i), mask) != 0 )
+    {
+      for( w = 0; w < s->word_cnt; w++ )
+      {
+        m = mask[w];
+        if ( m == 0 )
+          continue;
+        live[w] &= ~m;
+        while( m != 0 )
+        {
+          l->flags[w*64 + __builtin_ctzll(m)] = 1;      // mark the cube as deleted
+          m &= m - 1;
+        }
+      }
+    }
+  }
+  
+  free(order); free(start); free(live); free(mask);
+  return 1;
+}
+
+/*
+  In the given BCL, ensure, that no cube is part of any other cube
+  This will call bcp_PurgeBCL()
+*/
+void bcp_DoBCLSingleCubeContainment(bcp p, bcl l)
+{
+  /*
+    calculate the number of 01 and 10 codes for each of the cubes in "l"
+    idea is to reduce the number of "subset" tests, because for a cube with n variables,
+    can be a subset of another cube only if this other cube has lesser variables.
+    however: also the requal case is checked, to check wether two cubes are identical
+  */
+  int *vcl = bcp_GetBCLVarCntList(p, l);
+  int cnt = l->cnt;
+
+  if ( l->cnt < BCP_SCC_SLICE_MIN_CNT || bcp_DoBCLSingleCubeContainmentSlice(p, l, vcl) == 0 )
+    bcp_DoBCLSingleCubeContainmentPairwise(p, l, vcl);
   bcp_PurgeBCL(p, l);
+  bcp_AddStat(p, BCP_STAT_SCC_REMOVED, cnt - l->cnt);
   free(vcl);
 }
 
@@ -81,9 +179,13 @@ void bcp_DoBCLSingleCubeContainment(bcp p, bcl l)
 */
 int bcp_IsBCLCubeCovered(bcp p, bcl l, bc c)
 {
-  bcl n = bcp_NewBCLCofactorByCube(p, l, c, -1);
-  int result = bcp_IsBCLTautology(p, n);
+  bcl n;
+  int result;
+  bcp_StartBCLArenaFrame(p);
+  n = bcp_NewBCLCofactorByCube(p, l, c, -1);
+  result = bcp_IsBCLTautologySub(p, n, NULL, 0, 0);   // "n" is a private list, no need to create another copy
   bcp_DeleteBCL(p, n);
+  bcp_EndBCLArenaFrame(p);
   return result;
 }
 
@@ -92,9 +194,13 @@ int bcp_IsBCLCubeCovered(bcp p, bcl l, bc c)
 */
 int bcp_IsBCLCubeRedundant(bcp p, bcl l, int pos)
 {
-  bcl n = bcp_NewBCLCofactorByCube(p, l, bcp_GetBCLCube(p, l, pos), pos);
-  int result = bcp_IsBCLTautology(p, n);
+  bcl n;
+  int result;
+  bcp_StartBCLArenaFrame(p);
+  n = bcp_NewBCLCofactorByCube(p, l, bcp_GetBCLCube(p, l, pos), pos);
+  result = bcp_IsBCLTautologySub(p, n, NULL, 0, 0);
   bcp_DeleteBCL(p, n);
+  bcp_EndBCLArenaFrame(p);
   return result;
 }
 
@@ -135,6 +241,7 @@ void bcp_DoBCLMultiCubeContainment(bcp p, bcl l)
         if ( bcp_IsBCLCubeRedundant(p, l, i) )
         {
           l->flags[i] = 1;
+          bcp_IncStat(p, BCP_STAT_MCC_REMOVED);
         }
         
       } // i cube not deleted
@@ -144,3 +251,158 @@ void bcp_DoBCLMultiCubeContainment(bcp p, bcl l)
   bcp_PurgeBCL(p, l);
 }
 
+/*============================================================*/
+/* multi threaded IRREDUNDANT */
+
+/* buckets with less cubes are checked by the calling thread only */
+#define BCP_MCC_MT_MIN_CNT 8
+#define BCP_MCC_MT_MAX_THREADS 256
+
+struct bcp_mcc_worker_struct
+{
+  bcp p;                // context of the worker
+  bcl l;                // shared list, not modified during the speculative check
+  int *cand;            // positions of the cubes in the current bucket
+  int cand_cnt;
+  int *next;            // next index into "cand", shared by all workers
+  uint8_t *is_redundant;        // result for each entry in "cand"
+};
+
+static void *bcp_MCCWorkerThread(void *arg)
+{
+  struct bcp_mcc_worker_struct *w = (struct bcp_mcc_worker_struct *)arg;
+  int k;
+  for(;;)
+  {
+    k = __atomic_fetch_add(w->next, 1, __ATOMIC_RELAXED);
+    if ( k >= w->cand_cnt )
+      break;
+    w->is_redundant[k] = bcp_IsBCLCubeRedundant(w->p, w->l, w->cand[k]);
+  }
+  return NULL;
+}
+
+/*
+  Same as bcp_DoBCLMultiCubeContainment(), but use "thread_cnt" threads (including the calling thread).
+  The result is identical to bcp_DoBCLMultiCubeContainment().
+
+  The cubes of one variable count bucket are checked in parallel against the list at the start of the bucket.
+  A cube, which is not redundant against this list, is also not redundant against the reduced list.
+  A cube, which is redundant, must be checked again, if any cube, which was removed before within the same bucket,
+  intersects with the cube: Only intersecting cubes can contribute to the cover of the cube.
+  This conflict resolution is done in the order of the serial algorithm.
+*/
+void bcp_DoBCLMultiCubeContainmentParallel(bcp p, bcl l, int thread_cnt)
+{
+  struct bcp_mcc_worker_struct w[BCP_MCC_MT_MAX_THREADS];
+  pthread_t thread[BCP_MCC_MT_MAX_THREADS];
+  int i, j, k;
+  int *vcl;
+  int *cand;
+  int *removed;
+  int removed_cnt;
+  uint8_t *is_redundant;
+  uint64_t *sig;
+  int cand_cnt;
+  int next;
+  int min = p->var_cnt;
+  int max = 0;
+  int vc;
+  int thread_start_cnt;
+
+  if ( thread_cnt > BCP_MCC_MT_MAX_THREADS )
+    thread_cnt = BCP_MCC_MT_MAX_THREADS;
+  if ( thread_cnt <= 1 || l->cnt < BCP_MCC_MT_MIN_CNT )
+  {
+    bcp_DoBCLMultiCubeContainment(p, l);
+    return;
+  }
+
+  vcl = bcp_GetBCLVarCntList(p, l);
+  cand = (int *)malloc(sizeof(int)*l->cnt);
+  removed = (int *)malloc(sizeof(int)*l->cnt);
+  is_redundant = (uint8_t *)malloc(l->cnt);
+  if ( vcl == NULL || cand == NULL || removed == NULL || is_redundant == NULL )
+  {
+    free(vcl); free(cand); free(removed); free(is_redundant);
+    bcp_DoBCLMultiCubeContainment(p, l);         // fallback for memory error
+    return;
+  }
+  sig = bcp_GetBCLSignature(p, l);     // calculated before the worker threads read "l"
+
+  w[0].p = p;
+  for( i = 1; i < thread_cnt; i++ )
+  {
+    w[i].p = bcp_NewContext(p);
+    if ( w[i].p == NULL )
+      break;
+  }
+  thread_cnt = i;         // in case of memory error, continue with less threads
+
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] == 0 )
+    {
+      if ( min > vcl[i] )
+        min = vcl[i];
+      if ( max < vcl[i] )
+        max = vcl[i];
+    }
+  }
+
+  for( vc = max; vc >= min; vc-- )      // same order as bcp_DoBCLMultiCubeContainment()
+  {
+    cand_cnt = 0;
+    for( i = 0; i < l->cnt; i++ )
+      if ( l->flags[i] == 0 && vcl[i] == vc )
+        cand[cand_cnt++] = i;
+    if ( cand_cnt == 0 )
+      continue;
+
+    /* speculative check against the list at the start of the bucket */
+    next = 0;
+    thread_start_cnt = 1;
+    for( i = 0; i < thread_cnt; i++ )
+    {
+      w[i].l = l;
+      w[i].cand = cand;
+      w[i].cand_cnt = cand_cnt;
+      w[i].next = &next;
+      w[i].is_redundant = is_redundant;
+    }
+    if ( cand_cnt >= BCP_MCC_MT_MIN_CNT )
+      for( ; thread_start_cnt < thread_cnt; thread_start_cnt++ )
+        if ( pthread_create(thread+thread_start_cnt, NULL, bcp_MCCWorkerThread, w+thread_start_cnt) != 0 )
+          break;
+    bcp_MCCWorkerThread(w);
+    for( i = 1; i < thread_start_cnt; i++ )
+      pthread_join(thread[i], NULL);
+
+    /* conflict resolution in the order of the serial algorithm */
+    removed_cnt = 0;
+    for( k = 0; k < cand_cnt; k++ )
+    {
+      if ( is_redundant[k] == 0 )
+        continue;
+      i = cand[k];
+      for( j = 0; j < removed_cnt; j++ )
+        if ( bcp_IsSignatureIntersectionSure(sig[i], sig[removed[j]]) 
+          || bcp_IsIntersectionCube(p, bcp_GetBCLCube(p, l, i), bcp_GetBCLCube(p, l, removed[j])) )
+          break;
+      if ( j < removed_cnt )
+        if ( bcp_IsBCLCubeRedundant(p, l, i) == 0 )
+          continue;
+      l->flags[i] = 1;
+      removed[removed_cnt++] = i;
+      bcp_IncStat(p, BCP_STAT_MCC_REMOVED);
+    }
+  } // vc loop
+
+  for( i = 1; i < thread_cnt; i++ )
+    bcp_Delete(w[i].p);
+  free(vcl);
+  free(cand);
+  free(removed);
+  free(is_redundant);
+  bcp_PurgeBCL(p, l);
+}
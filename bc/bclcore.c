@@ -11,10 +11,109 @@
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <sys/mman.h>
+
+/*
+  Lists, which are created inside a bcl arena frame (see bcp_StartBCLArenaFrame()), 
+  are allocated from the arena: struct, cubes, signatures and flags.
+  The cubes, the signatures and the flags are stored in one arena area in this order.
+*/
+#define bcp_GetArenaBCLSize(p, max) ((size_t)(max)*((p)->bytes_per_cube_cnt+sizeof(uint64_t)+1))
+
+/*
+  release the cube memory of a non-arena list: the cubes of a list from bcp_NewBCLByBinaryFile()
+  are part of a file mapping
+*/
+static void bcp_FreeBCLList(bcl l)
+{
+  if ( l->map_addr != NULL )
+    munmap(l->map_addr, l->map_size);
+  else if ( l->list != NULL )
+    free(l->list);
+  l->map_addr = NULL;
+  l->list = NULL;
+}
+
+/*
+  change the size of the list, so that it can store "max" cubes, the existing cubes and flags are kept
+  "max" must not be smaller than l->cnt, arena lists can only grow.
+  returns 0 for memory error
+*/
+static int bcp_ResizeBCL(bcp p, bcl l, int max)
+{
+  __m128i *list;
+  uint8_t *flags;
+  uint64_t *sig;
+  
+  assert( max >= l->cnt );
+  if ( l->is_arena )
+  {
+    if ( max <= l->max )
+      return 1;
+    assert( l->arena_depth == p->arena_depth );         // the new memory would be released with an inner frame
+
+    uint8_t *m = (uint8_t *)bcp_ResizeBCLArenaMemory(p, l->list, bcp_GetArenaBCLSize(p, l->max), bcp_GetArenaBCLSize(p, max));
+    if ( m == NULL )
+      return 0;
+    /* "m" starts with the old layout, move the flags and then the signatures behind the new cube area */
+    memmove(m + (size_t)max*(p->bytes_per_cube_cnt+sizeof(uint64_t)), m + (size_t)l->max*(p->bytes_per_cube_cnt+sizeof(uint64_t)), l->cnt*sizeof(uint8_t));
+    memmove(m + (size_t)max*p->bytes_per_cube_cnt, m + (size_t)l->max*p->bytes_per_cube_cnt, l->cnt*sizeof(uint64_t));
+    l->list = (__m128i *)m;
+    l->sig = (uint64_t *)(m + (size_t)max*p->bytes_per_cube_cnt);
+    l->flags = m + (size_t)max*(p->bytes_per_cube_cnt+sizeof(uint64_t));
+    l->max = max;
+    return 1;
+  }
+  
+  if ( l->map_addr != NULL )
+  {
+    /* the cubes are part of a file mapping, move them to the heap */
+    list = (__m128i *)malloc(max*p->bytes_per_cube_cnt);
+    if ( list == NULL )
+      return 0;
+    memcpy(list, l->list, l->cnt*p->bytes_per_cube_cnt);
+    bcp_FreeBCLList(l);
+  }
+  else if ( l->list == NULL )
+    list = (__m128i *)malloc(max*p->bytes_per_cube_cnt);
+  else
+    list = (__m128i *)realloc(l->list, max*p->bytes_per_cube_cnt);
+  if ( list == NULL )
+    return 0;
+  l->list = list;
+  if ( l->flags == NULL )
+    flags = (uint8_t *)malloc(max*sizeof(uint8_t));
+  else
+    flags = (uint8_t *)realloc(l->flags, max*sizeof(uint8_t));
+  if ( flags == 0 )
+  {
+    if ( max < l->max )
+      l->max = max;     // "list" has been reduced already
+    return 0;
+  }
+  l->flags = flags;
+  if ( l->sig == NULL )
+    sig = (uint64_t *)malloc(max*sizeof(uint64_t));
+  else
+    sig = (uint64_t *)realloc(l->sig, max*sizeof(uint64_t));
+  if ( sig == NULL )
+  {
+    if ( max < l->max )
+      l->max = max;
+    return 0;
+  }
+  l->sig = sig;
+  l->max = max;
+  return 1;
+}
 
 bcl bcp_NewBCL(bcp p)
 {
-  bcl l = (bcl)malloc(sizeof(struct bcl_struct));
+  bcl l;
+  if ( p->arena_depth > 0 )
+    l = (bcl)bcp_ResizeBCLArenaMemory(p, NULL, 0, sizeof(struct bcl_struct));
+  else
+    l = (bcl)malloc(sizeof(struct bcl_struct));
   if ( l != NULL )
   {
     l->cnt = 0;
@@ -22,6 +121,14 @@ bcl bcp_NewBCL(bcp p)
     l->last_deleted = -1;
     l->list = NULL;
     l->flags = NULL;
+    l->sig = NULL;
+    l->slice = NULL;
+    l->mod_cnt = 0;
+    l->map_addr = NULL;
+    l->map_size = 0;
+    l->is_arena = p->arena_depth > 0;
+    l->arena_depth = p->arena_depth;
+    l->is_sig = 0;
     return l;
   }
   return NULL;
@@ -32,21 +139,19 @@ bcl bcp_NewBCLByBCL(bcp p, bcl l)
   bcl n = bcp_NewBCL(p);
   if ( n != NULL )
   {
-    n->list = (__m128i *)malloc(l->cnt*p->bytes_per_cube_cnt);
-    if ( n->list != NULL )
+    if ( bcp_ResizeBCL(p, n, l->cnt) != 0 )
     {
-      n->flags = (uint8_t *)malloc(l->cnt*sizeof(uint8_t));
-      if ( n->flags != NULL )
+      n->cnt = l->cnt;
+      memcpy(n->list, l->list, l->cnt*p->bytes_per_cube_cnt);
+      memcpy(n->flags, l->flags, l->cnt*sizeof(uint8_t));
+      if ( l->is_sig )
       {
-        n->cnt = l->cnt;
-        n->max = l->cnt;
-        memcpy(n->list, l->list, l->cnt*p->bytes_per_cube_cnt);
-        memcpy(n->flags, l->flags, l->cnt*sizeof(uint8_t));
-        return n;
+        memcpy(n->sig, l->sig, l->cnt*sizeof(uint64_t));
+        n->is_sig = 1;
       }
-      free(n->list);
+      return n;
     }
-    free(n);
+    bcp_DeleteBCL(p, n);
   }
   return NULL;
 }
@@ -74,69 +179,140 @@ bcl bcp_NewBCLWithCube(bcp p, int global_cube_pos)
 /* let a be a copy of b: copy content from bcl b into bcl a */
 int bcp_CopyBCL(bcp p, bcl a, bcl b)
 {
+  bcp_InvalidateBCLSlice(p, a);
   if ( a->max < b->cnt )
   {
-    __m128i *list;
-    uint8_t *flags;
-    if ( a->list == NULL )
-      list = (__m128i *)malloc(b->cnt*p->bytes_per_cube_cnt);
-    else
-      list = (__m128i *)realloc(a->list, b->cnt*p->bytes_per_cube_cnt);
-    if ( list == NULL )
+    a->cnt = 0;          // nothing needs to be kept
+    if ( bcp_ResizeBCL(p, a, b->cnt) == 0 )
       return 0;
-    a->list = list;
-    if ( a->flags == NULL )
-      flags = (uint8_t *)malloc(b->cnt*sizeof(uint8_t));
-    else
-      flags = (uint8_t *)realloc(a->flags, b->cnt*sizeof(uint8_t));
-    if ( flags == 0 )
-      return 0;
-    a->flags = flags;
-    a->max = b->cnt;
   }
   a->cnt = b->cnt;
   memcpy(a->list, b->list, a->cnt*p->bytes_per_cube_cnt);
   memcpy(a->flags, b->flags, a->cnt*sizeof(uint8_t));
+  if ( b->is_sig )
+  {
+    memcpy(a->sig, b->sig, a->cnt*sizeof(uint64_t));
+    a->is_sig = 1;
+  }
+  return 1;
+}
+
+/*
+  Lists from the arena must not exchange their memory with other lists, because the memory of 
+  the lists might belong to different arena frames. In this case a copy is done.
+*/
+
+/* 
+  let a be the content of b and clear b, the memory of b is transfered to a without copy 
+  returns 0 for memory error
+*/
+int bcp_MoveBCL(bcp p, bcl a, bcl b)
+{
+  if ( a == b )
+    return 1;
+  if ( a->is_arena || b->is_arena )
+  {
+    if ( bcp_CopyBCL(p, a, b) == 0 )
+      return 0;
+    bcp_ClearBCL(p, b);
+    return 1;
+  }
+  bcp_InvalidateBCLSlice(p, a);
+  bcp_FreeBCLList(a);
+  if ( a->flags != NULL )
+    free(a->flags);
+  if ( a->sig != NULL )
+    free(a->sig);
+  *a = *b;
+  b->cnt = 0;
+  b->max = 0;
+  b->last_deleted = -1;
+  b->list = NULL;
+  b->flags = NULL;
+  b->sig = NULL;
+  b->is_sig = 0;
+  b->slice = NULL;
+  b->map_addr = NULL;
+  return 1;
+}
+
+/* 
+  exchange the content of a and b, for lists created outside arena frames, the cubes are not copied
+  returns 0 for memory error
+*/
+int bcp_SwapBCL(bcp p, bcl a, bcl b)
+{
+  struct bcl_struct tmp;
+  if ( a->is_arena || b->is_arena )
+  {
+    bcl t = bcp_NewBCLByBCL(p, a);
+    if ( t == NULL )
+      return 0;
+    if ( bcp_CopyBCL(p, a, b) == 0 || bcp_CopyBCL(p, b, t) == 0 )
+      return bcp_DeleteBCL(p, t), 0;
+    bcp_DeleteBCL(p, t);
+    return 1;
+  }
+  tmp = *a;
+  *a = *b;
+  *b = tmp;
   return 1;
 }
 
 void bcp_ClearBCL(bcp p, bcl l)
 {
+  bcp_InvalidateBCLSlice(p, l);
   l->cnt = 0;
 }
 
 
+/* for lists from the arena, only the bit sliced view is deleted, the memory is released with bcp_EndBCLArenaFrame() */
 void bcp_DeleteBCL(bcp p, bcl l)
 {
-  if ( l->list != NULL )
-    free(l->list);
+  bcp_InvalidateBCLSlice(p, l);
+  if ( l->is_arena )
+    return;
+  bcp_FreeBCLList(l);
   if ( l->flags != NULL )
     free(l->flags);
+  if ( l->sig != NULL )
+    free(l->sig);
   free(l);
 }
 
+/*
+  The list grows by half of its current size (but at least BCL_EXTEND cubes), 
+  so that appending n cubes only requires O(log n) realloc calls.
+*/
 #define BCL_EXTEND 32
 int bcp_ExtendBCL(bcp p, bcl l)
 {
-  __m128i *list;
-  uint8_t *flags;
-  if ( l->list == NULL )
-    list = (__m128i *)malloc(BCL_EXTEND*p->bytes_per_cube_cnt);
-  else
-    list = (__m128i *)realloc(l->list, (BCL_EXTEND+l->max)*p->bytes_per_cube_cnt);
-  if ( list == NULL )
-    return 0;
-  l->list = list;
-  if ( l->flags == NULL )
-    flags = (uint8_t *)malloc(BCL_EXTEND*sizeof(uint8_t));
-  else
-    flags = (uint8_t *)realloc(l->flags, (BCL_EXTEND+l->max)*sizeof(uint8_t));
-  if ( flags == 0 )
-    return 0;
-  l->flags = flags;
-  
-  l->max += BCL_EXTEND;
-  return 1;
+  int extend = l->max / 2;
+  if ( extend < BCL_EXTEND )
+    extend = BCL_EXTEND;
+  return bcp_ResizeBCL(p, l, l->max + extend);
+}
+
+/*
+  ensure, that "l" can store at least "cnt" cubes without further memory allocation.
+  returns 0 for memory error
+*/
+int bcp_ReserveBCL(bcp p, bcl l, int cnt)
+{
+  if ( l->max >= cnt )
+    return 1;
+  return bcp_ResizeBCL(p, l, cnt);
+}
+
+/*
+  release the unused memory of "l", useful for lists, which are kept for a longer time.
+  Arena lists are not changed. returns 0 for memory error (the list is still valid in this case)
+*/
+int bcp_ShrinkBCL(bcp p, bcl l)
+{
+  if ( l->is_arena || l->max == l->cnt || l->cnt == 0 )
+    return 1;
+  return bcp_ResizeBCL(p, l, l->cnt);
 }
 
 #ifndef bcp_GetBCLCube
@@ -213,7 +389,9 @@ void bcp_PurgeBCL(bcp p, bcl l)
   int i = 0;
   int j = 0;
   int cnt = l->cnt;
+  int is_sig = l->is_sig;
   
+  bcp_InvalidateBCLSlice(p, l);
   while( i < cnt )
   {
     if ( l->flags[i] != 0 )
@@ -233,11 +411,13 @@ void bcp_PurgeBCL(bcp p, bcl l)
     if ( i >= cnt )
       break;
     memcpy((void *)bcp_GetBCLCube(p, l, j), (void *)bcp_GetBCLCube(p, l, i), p->bytes_per_cube_cnt);
+    l->sig[j] = l->sig[i];      // the signatures are moved together with the cubes (even if not valid)
     j++;
     i++;
   }
   l->cnt = j;  
   memset(l->flags, 0, l->cnt);
+  l->is_sig = is_sig;
 }
 
 
@@ -251,26 +431,72 @@ int bcp_AddBCLCube(bcp p, bcl l)
       return -1;
   assert( l->list != NULL );
   assert( l->max > l->cnt );
+  bcp_InvalidateBCLSlice(p, l);
   l->cnt++;
   bcp_ClrCube(p, bcp_GetBCLCube(p, l, l->cnt-1));
   l->flags[l->cnt-1] = 0;
   return l->cnt-1;
 }
 
-/* add a cube and return its position */
+/* add a cube and return its position, "c" may be a cube of "l" */
 int bcp_AddBCLCubeByCube(bcp p, bcl l, bc c)
 {
+  int is_sig;
+  if ( l->max <= l->cnt && l->list != NULL && (uint8_t *)c >= (uint8_t *)l->list && (uint8_t *)c < (uint8_t *)l->list + l->cnt*p->bytes_per_cube_cnt )
+  {
+    /* "c" is part of "l", so the address of "c" will change with the realloc in bcp_ExtendBCL() */
+    size_t offset = (uint8_t *)c - (uint8_t *)l->list;
+    while ( l->max <= l->cnt )
+      if ( bcp_ExtendBCL(p, l) == 0 )
+        return -1;
+    c = (bc)((uint8_t *)l->list + offset);
+  }
   while ( l->max <= l->cnt )
     if ( bcp_ExtendBCL(p, l) == 0 )
       return -1;
   assert( l->list != NULL );
   assert( l->max > l->cnt );
+  is_sig = l->is_sig;
+  bcp_InvalidateBCLSlice(p, l);
   l->cnt++;
   bcp_CopyCube(p, bcp_GetBCLCube(p, l, l->cnt-1), c);  
   l->flags[l->cnt-1] = 0;
+  if ( is_sig )
+  {
+    l->sig[l->cnt-1] = bcp_GetCubeSignature(p, c);
+    l->is_sig = 1;
+  }
   return l->cnt-1;
 }
 
+/*
+  return the signatures of the cubes of "l", the signatures are calculated if required.
+  The signatures are kept by bcp_AddBCLCubeByCube(), bcp_PurgeBCL() and the copy functions.
+  Like the bit sliced view, they are invalidated by bcp_InvalidateBCLSlice() and all 
+  other functions, which modify "l". A function, which modifies a cube of "l" directly,
+  may call bcp_UpdateBCLSignature() instead of bcp_InvalidateBCLSlice() to keep the signatures.
+  bcp_UpdateBCLSignature() will still outdate the bit sliced view (see bcp_GetBCLSlice()).
+  Only the owner of "l" may call this function.
+*/
+uint64_t *bcp_GetBCLSignature(bcp p, bcl l)
+{
+  int i;
+  if ( l->is_sig == 0 )
+  {
+    for( i = 0; i < l->cnt; i++ )
+      l->sig[i] = bcp_GetCubeSignature(p, bcp_GetBCLCube(p, l, i));
+    l->is_sig = 1;
+  }
+  return l->sig;
+}
+
+void bcp_UpdateBCLSignature(bcp p, bcl l, int pos)
+{
+  l->mod_cnt++;         // the cube has been modified, so an existing bit sliced view is outdated
+  if ( l->is_sig )
+    l->sig[pos] = bcp_GetCubeSignature(p, bcp_GetBCLCube(p, l, pos));
+}
+
 
 /*
   Adds the cubes from b to list a.
@@ -299,6 +525,7 @@ int bcp_AddBCLCubesByBCL(bcp p, bcl a, bcl b)
 int bcp_AddBCLCubesByString(bcp p, bcl l, const char *s)
 {
   int cube_pos;
+  const char *end = s + strlen(s);
   for(;;)
   {
     for(;;)
@@ -312,7 +539,7 @@ int bcp_AddBCLCubesByString(bcp p, bcl l, const char *s)
     cube_pos = bcp_AddBCLCube(p, l);
     if ( cube_pos < 0 )
       break;
-    bcp_SetCubeByStringPointer(p, bcp_GetBCLCube(p, l, cube_pos),  &s);
+    bcp_SetCubeByStringRange(p, bcp_GetBCLCube(p, l, cube_pos), &s, end);
   }
   return 0;     // memory error
 }
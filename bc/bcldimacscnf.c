@@ -1,227 +1,329 @@
 /*
 
   bcldimacscnf.c
-  
+
   Support for the dimacs cnf file format
 
+  The input is read by a bcd object (see struct bcd_struct in bc.h). A regular file is
+  memory mapped, all other inputs (stdin, pipes, e.g. from "zcat file.cnf.gz") are
+  read in large blocks without any seek operation. The parser does not have any global state,
+  so different threads may read different files at the same time.
+
 */
 
 #include "bc.h"
 #include <stdio.h>
-#include <ctype.h>
-#include <strings.h>
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
-int fp_current_char = '\0';
+/* refill the buffer, returns the next char or -1 at the end of the input */
+static int bcd_fill(bcd d)
+{
+  if ( d->is_mmap || d->fp == NULL )
+    return -1;
+  d->pos = 0;
+  d->len = fread(d->buffer, 1, d->buffer_size, d->fp);
+  if ( d->len == 0 )
+    return -1;
+  return (unsigned char)d->data[0];
+}
 
-void fp_skip_space(FILE *fp)
+static inline int bcd_peek(bcd d)
 {
+  if ( d->pos < d->len )
+    return (unsigned char)d->data[d->pos];
+  return bcd_fill(d);
+}
+
+/* skip white space, returns the next char or -1 */
+static int bcd_skip_space(bcd d)
+{
+  int c;
   for(;;)
   {
-    if ( fp_current_char < 0 )
-      break;
-    if ( fp_current_char > 32 )
-      break;
-    fp_current_char = fgetc(fp);
+    c = bcd_peek(d);
+    if ( c < 0 || c > 32 )
+      return c;
+    d->pos++;
   }
 }
 
-const char *fp_get_identifier(FILE *fp)
+/* skip the rest of the line including the line end, returns the first char of the next line or -1 */
+static int bcd_skip_line(bcd d)
 {
-  static char identifier[1024];
-  int i = 0;
-  identifier[0] = '\0';
-  if ( isalpha(fp_current_char) || fp_current_char == '_' )
+  const char *e;
+  for(;;)
   {
-    for(;;)
+    if ( bcd_peek(d) < 0 )
+      return -1;
+    e = (const char *)memchr(d->data + d->pos, '\n', d->len - d->pos);
+    if ( e != NULL )
     {
-      if ( fp_current_char < 0 )
-        break;
-      if ( isalnum(fp_current_char) || fp_current_char == '_' )
-      {
-        if ( i+1 < 1024 )
-          identifier[i++] = fp_current_char;
-        fp_current_char = fgetc(fp);
-      }
-      else
-      {
-        break;
-      }
+      d->pos = e - d->data + 1;
+      return bcd_peek(d);
     }
+    d->pos = d->len;
   }
-  identifier[i] = '\0';
-  fp_skip_space(fp);
-  return identifier;
 }
 
-
-
-int fp_get_value(FILE *fp)
+/*
+  read a (signed) decimal value with max 9 digits, no locale and no ctype
+  returns 0 if there is no number at the current position
+*/
+static int bcd_get_value(bcd d, int *value)
 {
-  int v = 0;
+  int c = bcd_peek(d);
   int is_minus = 0;
-  if ( fp_current_char == '-' )
+  int v = 0;
+  int digit_cnt = 0;
+  if ( c == '-' )
   {
     is_minus = 1;
-    fp_current_char = fgetc(fp);
-    fp_skip_space(fp);
+    d->pos++;
+    c = bcd_peek(d);
   }
-  if ( isdigit(fp_current_char) )
+  while ( (unsigned)(c - '0') < 10 )
   {
-    for(;;)
-    {
-      if ( fp_current_char < 0 )
-        break;
-      if ( isdigit(fp_current_char) )
-      {
-        v = (v*10) + (fp_current_char) - '0';
-        fp_current_char = fgetc(fp);
-      }
-      else
-      {
-        break;
-      }
-    } // for
+    if ( digit_cnt >= 9 )
+      return 0;         // overflow
+    v = v*10 + (c - '0');
+    digit_cnt++;
+    d->pos++;
+    c = bcd_peek(d);
   }
-  fp_skip_space(fp);
-  if ( is_minus )
-    return -v;
-  return v;
+  if ( digit_cnt == 0 )
+    return 0;
+  *value = is_minus ? -v : v;
+  return 1;
 }
 
-
-int bcp_GetVarCntFromDIMACSCNF(FILE *fp, int *var_cnt, int *clause_cnt)
+/* read the "p cnf <var_cnt> <clause_cnt>" line, comments before this line are skipped */
+static int bcd_read_header(bcd d)
 {
-  const char *subformat;
-  fseek(fp, 0, SEEK_SET);
-  fp_current_char = fgetc(fp);
-  fp_skip_space(fp);
-  
+  int c = bcd_skip_space(d);
   for(;;)
   {
-    if ( fp_current_char == 'c' ||   fp_current_char == 'C' )
+    if ( c == 'c' || c == 'C' )
     {
-      for(;;)
-      {
-        fp_current_char = fgetc(fp);
-        if ( fp_current_char < 0 )
-          return 0;
-        if ( fp_current_char == '\r' || fp_current_char == '\n' )
-          break;
-      }
-      fp_skip_space(fp);
+      bcd_skip_line(d);
+      c = bcd_skip_space(d);
     }
-    else if ( fp_current_char == 'p' || fp_current_char == 'P' )
+    else if ( c == 'p' || c == 'P' )
     {
       // p cnf 60 160
-      
-      fp_current_char = fgetc(fp);
-      fp_skip_space(fp);
-      subformat = fp_get_identifier(fp);
-      if ( strcasecmp(subformat, "cnf") != 0 )
+      d->pos++;
+      c = bcd_skip_space(d);
+      if ( c != 'c' && c != 'C' )
+        return 0;
+      d->pos++;
+      c = bcd_peek(d);
+      if ( c != 'n' && c != 'N' )
+        return 0;
+      d->pos++;
+      c = bcd_peek(d);
+      if ( c != 'f' && c != 'F' )
+        return 0;
+      d->pos++;
+      c = bcd_peek(d);
+      if ( c > 32 )
         return 0;       // only "cnf" is supported
-      *var_cnt = fp_get_value(fp);
-      *clause_cnt = fp_get_value(fp);
+      bcd_skip_space(d);
+      if ( bcd_get_value(d, &d->var_cnt) == 0 || d->var_cnt < 0 )
+        return 0;
+      bcd_skip_space(d);
+      if ( bcd_get_value(d, &d->clause_cnt) == 0 || d->clause_cnt < 0 )
+        return 0;
+      bcd_skip_line(d);
       return 1;
     }
     else
-      fp_current_char = fgetc(fp);
+      return 0;         // header is missing
   }
-  
 }
 
-
-int bcp_AddBCLCubesByDIMACSCNF(bcp p, bcl l, FILE *fp)
+/*
+  create a reader for the DIMACS CNF data from the current position of "fp" and read the "p cnf" header
+  buffer_size: 0 to map a regular file into memory (or to use a default buffer size for other inputs),
+    any other value will force buffered reading with the given buffer size.
+  "fp" is not closed by bcp_DeleteBCD()
+  returns NULL for memory error or if the header is invalid
+*/
+bcd bcp_NewBCD(FILE *fp, size_t buffer_size)
 {
-  fseek(fp, 0, SEEK_SET);
-  fp_current_char = fgetc(fp);
-  fp_skip_space(fp);
-  
-  for(;;)
+  struct stat st;
+  long offset;
+  void *m;
+  bcd d = (bcd)malloc(sizeof(struct bcd_struct));
+  if ( d == NULL )
+    return NULL;
+  d->fp = fp;
+  d->is_fp_owner = 0;
+  d->is_mmap = 0;
+  d->buffer = NULL;
+  d->buffer_size = 0;
+  d->data = NULL;
+  d->len = 0;
+  d->pos = 0;
+  d->var_cnt = 0;
+  d->clause_cnt = 0;
+
+  if ( buffer_size == 0 )
   {
-    if ( fp_current_char < 0 )
-        return 1;
-    if ( fp_current_char == 'c' ||   fp_current_char == 'C' || fp_current_char == 'p' || fp_current_char == 'P')
+    offset = ftell(fp);
+    if ( offset >= 0 && fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && (off_t)offset <= st.st_size )
     {
-      for(;;)
+      m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+      if ( m != MAP_FAILED )
       {
-        fp_current_char = fgetc(fp);
-        if ( fp_current_char < 0 )
-          return 1;
-        if ( fp_current_char == '\r' || fp_current_char == '\n' )
-          break;
+        d->is_mmap = 1;
+        d->data = (const char *)m;
+        d->len = (size_t)st.st_size;
+        d->pos = (size_t)offset;
       }
-      fp_skip_space(fp);
     }
-    else
-    {
-      if ( isdigit( fp_current_char ) || fp_current_char == '-' )
-      {
-        int pos = bcp_AddBCLCube(p, l); // add empty cube to list l, returns the position of the new cube or -1 in case of error
-        if ( pos < 0 )
-        {
-          return 0;
-        }
-        else
-        {
-          int var = 0;
-          bc c = bcp_GetBCLCube(p, l, pos);
-          
-          for(;;)
-          {
-            var = fp_get_value(fp);
-            if ( var == 0 )     // the value 0 terminates the clause
-              break;
-            if ( var < 0 )
-            {
-              bcp_SetCubeVar(p, c, -var-1, 2);     // invert the minterm and assign "one" 
-            }
-            else
-            {
-              bcp_SetCubeVar(p, c, var-1, 1);     // assign zero
-            }           
-            if ( fp_current_char < 0 )
-              return 1;
-            
-          } // for(;;)
-        } // add cube        
-      } // isdigit
-      else
-      {
-        fp_current_char = fgetc(fp);
-        fp_skip_space(fp);
-        
-      }
-    }
-  } // for(;;)
-}
+    buffer_size = BCD_DEFAULT_BUFFER_SIZE;
+  }
+
+  if ( d->is_mmap == 0 )
+  {
+    d->buffer = (char *)malloc(buffer_size);
+    if ( d->buffer == NULL )
+      return free(d), NULL;
+    d->buffer_size = buffer_size;
+    d->data = d->buffer;
+  }
 
+  if ( bcd_read_header(d) == 0 )
+    return bcp_DeleteBCD(d), NULL;
+  return d;
+}
 
-bcp bcp_NewByDIMACSCNF(FILE *fp)
+/* "-" will read from stdin, returns NULL if the file can't be opened, for memory error or if the header is invalid */
+bcd bcp_NewBCDByName(const char *name)
 {
-  int var_cnt = 0;
-  int clause_cnt = 0;
-  if ( bcp_GetVarCntFromDIMACSCNF(fp, &var_cnt, &clause_cnt) == 0 )
+  FILE *fp;
+  bcd d;
+  if ( strcmp(name, "-") == 0 )
+    return bcp_NewBCD(stdin, 0);
+  fp = fopen(name, "rb");
+  if ( fp == NULL )
     return NULL;
-  
-  return bcp_New(var_cnt);
+  d = bcp_NewBCD(fp, 0);
+  if ( d == NULL )
+    return fclose(fp), NULL;
+  d->is_fp_owner = 1;
+  return d;
 }
 
-bcl bcp_NewBCLByDIMACSCNF(bcp p, FILE *fp)   // create a bcl from a DIMACS CNF
+void bcp_DeleteBCD(bcd d)
+{
+  if ( d->is_mmap )
+    munmap((void *)d->data, d->len);
+  free(d->buffer);
+  if ( d->is_fp_owner )
+    fclose(d->fp);
+  free(d);
+}
+
+/* create a new problem with the number of variables from the header */
+bcp bcp_NewByBCD(bcd d)
+{
+  return bcp_New(d->var_cnt);
+}
+
+/*
+  read all clauses into "l", each clause becomes one cube with inverted literals
+  returns 0 for memory error, for a variable which is not part of "p" or for any other syntax error
+*/
+int bcp_AddBCLCubesByBCD(bcp p, bcl l, bcd d)
+{
+  int c, var;
+  int pos = -1;         // position of the current clause cube, -1 if there is no clause
+  for(;;)
+  {
+    c = bcd_skip_space(d);
+    if ( c < 0 || c == '%' )    // "%" is the end marker of the SATLIB files
+      return 1;
+    if ( c == 'c' || c == 'C' || c == 'p' || c == 'P' )
+    {
+      bcd_skip_line(d);
+      continue;
+    }
+    if ( bcd_get_value(d, &var) == 0 )
+      return 0;
+    if ( pos < 0 )
+    {
+      pos = bcp_AddBCLCube(p, l); // add empty cube to list l, returns the position of the new cube or -1 in case of error
+      if ( pos < 0 )
+        return 0;
+    }
+    if ( var == 0 )     // the value 0 terminates the clause
+    {
+      pos = -1;
+    }
+    else if ( var < 0 )
+    {
+      if ( -var > p->var_cnt )
+        return 0;
+      bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), -var-1, 2);     // invert the minterm and assign "one"
+    }
+    else
+    {
+      if ( var > p->var_cnt )
+        return 0;
+      bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), var-1, 1);     // assign zero
+    }
+  }
+}
+
+/* create a bcl from the remaining clauses of the reader, the list is pre-sized by the clause count of the header */
+bcl bcp_NewBCLByBCD(bcp p, bcd d)
 {
-  int var_cnt = 0;
-  int clause_cnt = 0;
   bcl l = bcp_NewBCL(p);
   if ( l == NULL )
     return NULL;
-  if ( bcp_GetVarCntFromDIMACSCNF(fp, &var_cnt, &clause_cnt) == 0 )
+  if ( d->clause_cnt > 0 && bcp_ReserveBCL(p, l, d->clause_cnt) == 0 )        // the header tells the number of cubes
     return bcp_DeleteBCL(p, l), NULL;
-  assert( p->var_cnt == var_cnt);
-  if ( bcp_AddBCLCubesByDIMACSCNF(p, l, fp) == 0 )
+  if ( bcp_AddBCLCubesByBCD(p, l, d) == 0 )
     return bcp_DeleteBCL(p, l), NULL;
-  assert( l->cnt == clause_cnt );
+  bcp_ShrinkBCL(p, l);
   return l;
 }
 
+/*
+  The two functions below read the same file twice, so "fp" must be seekable.
+  Use the bcd functions for stdin or pipes.
+*/
 
+bcp bcp_NewByDIMACSCNF(FILE *fp)
+{
+  bcp p;
+  bcd d;
+  rewind(fp);
+  d = bcp_NewBCD(fp, 0);
+  if ( d == NULL )
+    return NULL;
+  p = bcp_NewByBCD(d);
+  bcp_DeleteBCD(d);
+  return p;
+}
+
+bcl bcp_NewBCLByDIMACSCNF(bcp p, FILE *fp)   // create a bcl from a DIMACS CNF
+{
+  bcl l;
+  bcd d;
+  rewind(fp);
+  d = bcp_NewBCD(fp, 0);
+  if ( d == NULL )
+    return NULL;
+  assert( p->var_cnt >= d->var_cnt );
+  l = bcp_NewBCLByBCD(p, d);
+  bcp_DeleteBCD(d);
+  return l;
+}
 
@@ -6,11 +6,14 @@
 
 */
 #include "bc.h"
+#include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 /*
   try to expand cubes into another cube
   includes bcp_DoBCLSingleCubeContainment
+  Pairs with delta 0 are skipped with the cube signatures.
 */
 void bcp_DoBCLSimpleExpand(bcp p, bcl l)
 {
@@ -20,6 +23,10 @@ void bcp_DoBCLSimpleExpand(bcp p, bcl l)
   int delta;
   int cval, dval;
   bc c, d;
+  uint64_t *sig;
+  
+  bcp_InvalidateBCLSlice(p, l);       // cubes of "l" are modified directly
+  sig = bcp_GetBCLSignature(p, l);    // kept up to date with bcp_UpdateBCLSignature()
   for( i = 0; i < cnt; i++ )
   {
     if ( l->flags[i] == 0 )
@@ -27,7 +34,7 @@ void bcp_DoBCLSimpleExpand(bcp p, bcl l)
       c = bcp_GetBCLCube(p, l, i);
       for( j = i+1; j < cnt; j++ )
       {
-        if ( l->flags[j] == 0 )
+        if ( l->flags[j] == 0 && bcp_IsSignatureIntersectionSure(sig[i], sig[j]) == 0 )
         {
           //if ( i != j )
           {
@@ -61,12 +68,13 @@ void bcp_DoBCLSimpleExpand(bcp p, bcl l)
                 {
                   // great, expand would be successful
                   bcp_SetCubeVar(p, c, v, 3);  // expand the cube, by adding don't care to that variable
+                  bcp_UpdateBCLSignature(p, l, i);
                   //printf("v=%d success c\n", v);
 
                   /* check whether other cubes are covered by the new cube */
                   for( k = 0; k < cnt; k++ )
                   {
-                    if ( k != j && k != i && l->flags[k] == 0)
+                    if ( k != j && k != i && l->flags[k] == 0 && bcp_IsSignatureSubsetPossible(sig[i], sig[k]) )
                     {
                       if ( bcp_IsSubsetCube(p, c, bcp_GetBCLCube(p, l, k)) != 0 )
                       {
@@ -83,10 +91,11 @@ void bcp_DoBCLSimpleExpand(bcp p, bcl l)
                   {
                     // expand of d would be successful
                     bcp_SetCubeVar(p, d, v, 3);  // expand the d cube, by adding don't care to that variable
+                    bcp_UpdateBCLSignature(p, l, j);
                     //printf("v=%d success d\n", v);
                     for( k = 0; k < cnt; k++ )
                     {
-                      if ( k != j && k != i && l->flags[k] == 0)
+                      if ( k != j && k != i && l->flags[k] == 0 && bcp_IsSignatureSubsetPossible(sig[j], sig[k]) )
                       {
                         if ( bcp_IsSubsetCube(p, d, bcp_GetBCLCube(p, l, k)) != 0 )
                         {
@@ -116,6 +125,7 @@ void bcp_DoBCLExpandWithOffSet2(bcp p, bcl l, bcl off)
   int i, j, v;
   bc c;
   int cval;
+  bcp_InvalidateBCLSlice(p, l);       // cubes of "l" are modified directly
   for( i = 0; i < l->cnt; i++ )
   {
     if ( l->flags[i] == 0 )
@@ -145,60 +155,235 @@ void bcp_DoBCLExpandWithOffSet2(bcp p, bcl l, bcl off)
 }
 
 
-void bcp_DoBCLExpandWithOffSet(bcp p, bcl l, bcl off)
+/*
+  Expand with the blocking matrix (Espresso style)
+
+  For an on-set cube c and the off-set, the blocking matrix has one row for each off-set cube
+  and one column for each literal of c. The entry is 1 if the off-set cube has the opposite 
+  literal. The expanded cube does not intersect with an off-set cube as long as at least one
+  literal of the row is kept in c. The columns are the complements of the bitplanes of the bit sliced 
+  view of the off-set, so the matrix is not stored at all.
+
+  The greedy loop:
+    1. A literal is kept (lowered), if it is the last free literal of any row. All rows with 
+       this literal are then blocked forever and are removed from "row".
+    2. Of the remaining free literals, the literal with the lowest column count is raised.
+  The result is a prime cube, because each kept literal has a row, which is blocked only by this literal.
+*/
+#define BCL_EXPAND_FREE 0
+#define BCL_EXPAND_LOWERED 1
+#define BCL_EXPAND_RAISED 2
+
+struct bcl_expand_struct
 {
-  int i, j, v;
-  bc c;
-  int cval;
-  int is_expanded;      // set to 1 if the cube c had been successfully expanded
+  bcs s;                // bit sliced view of the off-set
+  int word_cnt;
+  uint64_t *all_row;    // valid and not deleted off-set cubes
+  uint64_t *row;        // rows of the blocking matrix, which are not blocked by a lowered literal
+  uint64_t *ones;       // rows with at least one free literal
+  uint64_t *twos;       // rows with at least two free literals
+  int *lit_var;
+  int *lit_state;
+  const uint64_t **lit_plane;   // the column of the literal is ~lit_plane[]
+};
 
-  bcp_StartCubeStackFrame(p);
-  c = bcp_GetTempCube(p);
+/* returns 1 if "c" has been expanded */
+static int bcp_ExpandCubeWithBlockingMatrix(bcp p, struct bcl_expand_struct *e, bc c)
+{
+  const uint64_t *cw = (const uint64_t *)c;
+  const uint64_t *col;
+  uint64_t literals, x, single_any;
+  int w, k, bit, code, var_pos, word_cnt = e->word_cnt;
+  int lit_cnt = 0, free_cnt, raised_cnt = 0;
+  int min_k, min_cnt, cnt;
   
-  for( i = 0; i < l->cnt; i++ ) // l->cnt may grow so new cubes are also analysed
+  for( w = 0; w < p->blk_cnt*2; w++ )
   {
-    if ( l->flags[i] == 0 )
+    literals = ~(cw[w] & (cw[w] >> 1)) & 0x5555555555555555ULL;
+    while( literals != 0 )
     {
-      // c = bcp_GetBCLCube(p, l, i);
-      bcp_CopyCube(p, c, bcp_GetBCLCube(p, l, i));
-      is_expanded = 0;
-      for( v = 0; v < p->var_cnt; v++ )
+      bit = __builtin_ctzll(literals);
+      literals &= literals - 1;
+      var_pos = w*32 + bit/2;
+      if ( var_pos >= p->var_cnt )
+        break;
+      code = (cw[w] >> bit) & 3;
+      if ( code == 0 )
+        return 0;       // illegal cube
+      e->lit_var[lit_cnt] = var_pos;
+      e->lit_state[lit_cnt] = BCL_EXPAND_FREE;
+      e->lit_plane[lit_cnt] = e->s->plane + (size_t)(code == 1 ? 2*var_pos : 2*var_pos+1)*word_cnt;
+      lit_cnt++;
+    }
+  }
+  if ( lit_cnt == 0 )
+    return 0;
+  memcpy(e->row, e->all_row, word_cnt*sizeof(uint64_t));
+  free_cnt = lit_cnt;
+  
+  while( free_cnt > 0 )
+  {
+    /* count the free literals of each row: 0, 1 or more */
+    memset(e->ones, 0, word_cnt*sizeof(uint64_t));
+    memset(e->twos, 0, word_cnt*sizeof(uint64_t));
+    for( k = 0; k < lit_cnt; k++ )
+      if ( e->lit_state[k] == BCL_EXPAND_FREE )
       {
-        cval = bcp_GetCubeVar(p, c, v);
-        
-        if ( cval != 3 )
+        col = e->lit_plane[k];
+        for( w = 0; w < word_cnt; w++ )
         {
-          bcp_SetCubeVar(p, c, v, 3);  // for testing, set the variable to don't care
-          for( j = 0; j < off->cnt; j++ )       // check whether there is any intersection with the off-set 
-          {
-            if ( off->flags[j] == 0 )
-            {
-              if ( bcp_IsIntersectionCube(p, c, bcp_GetBCLCube(p, off, j)) != 0 )
-              {
-                break;  // intersection found
-              }
-            }
-          } // off-set test
-          if ( j >= off->cnt )  // no intersection found, so this cube was successful expanded
+          x = e->row[w] & ~col[w];
+          e->twos[w] |= e->ones[w] & x;
+          e->ones[w] |= x;
+        }
+      }
+      
+    /* rows without free literal: "c" intersects with the off-set (only possible before the first raise) */
+    x = 0;
+    single_any = 0;
+    for( w = 0; w < word_cnt; w++ )
+    {
+      x |= e->row[w] & ~e->ones[w];
+      e->ones[w] &= ~e->twos[w];       // rows with exactly one free literal
+      single_any |= e->ones[w];
+    }
+    if ( x != 0 )
+      return 0;
+    
+    /* keep the last free literal of a row and remove the rows, which are blocked by this literal */
+    if ( single_any != 0 )
+    {
+      for( k = 0; k < lit_cnt; k++ )
+        if ( e->lit_state[k] == BCL_EXPAND_FREE )
+        {
+          col = e->lit_plane[k];
+          for( w = 0; w < word_cnt; w++ )
+            if ( (e->ones[w] & ~col[w]) != 0 )
+              break;
+          if ( w < word_cnt )
           {
-            is_expanded = 1;
-            bcp_AddBCLCubeByCube(p, l, c);
-            // c = bcp_GetBCLCube(p, l, i);        // this is tricky: the address of c might have changed due to realloc of the cube list, so re-read c here
+            e->lit_state[k] = BCL_EXPAND_LOWERED;
+            free_cnt--;
+            for( w = 0; w < word_cnt; w++ )
+              e->row[w] &= col[w];
           }
-          bcp_SetCubeVar(p, c, v, cval);    // undo the change for the next test
-        } // dc?
-        
-        
-      } // with all variables in c
-      if ( is_expanded )
+        }
+    }
+    
+    /* raise all literals without any row and the free literal with the lowest column count */
+    min_k = -1;
+    min_cnt = 0;
+    for( k = 0; k < lit_cnt; k++ )
+      if ( e->lit_state[k] == BCL_EXPAND_FREE )
       {
-        // c was expanded, so remove that cube from the list
-        l->flags[i] = 1;
-      }        
-    } // not deleted in l
+        col = e->lit_plane[k];
+        cnt = 0;
+        for( w = 0; w < word_cnt; w++ )
+          cnt += __builtin_popcountll(e->row[w] & ~col[w]);
+        if ( cnt == 0 )
+        {
+          e->lit_state[k] = BCL_EXPAND_RAISED;
+          free_cnt--;
+          raised_cnt++;
+        }
+        else if ( min_k < 0 || cnt < min_cnt )
+        {
+          min_k = k;
+          min_cnt = cnt;
+        }
+      }
+    if ( min_k >= 0 )
+    {
+      e->lit_state[min_k] = BCL_EXPAND_RAISED;
+      free_cnt--;
+      raised_cnt++;
+    }
   }
-  bcp_PurgeBCL(p, l);  // remove all deleted cubes from "l"
-  bcp_EndCubeStackFrame(p);  
+  
+  for( k = 0; k < lit_cnt; k++ )
+    if ( e->lit_state[k] == BCL_EXPAND_RAISED )
+      bcp_SetCubeVar(p, c, e->lit_var[k], 3);
+  return raised_cnt > 0;
+}
+
+struct bcl_expand_order_struct
+{
+  int lit_cnt;
+  int pos;
+};
+
+static int bcl_expand_order_compare(const void *a, const void *b)
+{
+  const struct bcl_expand_order_struct *x = (const struct bcl_expand_order_struct *)a;
+  const struct bcl_expand_order_struct *y = (const struct bcl_expand_order_struct *)b;
+  if ( x->lit_cnt != y->lit_cnt )
+    return x->lit_cnt - y->lit_cnt;
+  return x->pos - y->pos;
+}
+
+/*
+  expand each cube of "l" into a prime cube, which does not intersect with "off", see above.
+  The largest cubes are expanded first, cubes which are covered by an expanded cube are removed.
+  For memory errors, "l" is not changed.
+*/
+void bcp_DoBCLExpandWithOffSet(bcp p, bcl l, bcl off)
+{
+  struct bcl_expand_struct e;
+  struct bcl_expand_order_struct *order;
+  int i, j, k;
+  uint64_t *sig;
+  bc c;
+  
+  e.s = bcp_GetBCLSlice(p, off);
+  if ( e.s == NULL )
+    return;
+  e.word_cnt = e.s->word_cnt;
+  e.all_row = (uint64_t *)calloc((size_t)e.word_cnt*4, sizeof(uint64_t));
+  e.lit_var = (int *)malloc(p->var_cnt*sizeof(int)*2);
+  e.lit_plane = (const uint64_t **)malloc(p->var_cnt*sizeof(const uint64_t *));
+  order = (struct bcl_expand_order_struct *)malloc((l->cnt+1)*sizeof(struct bcl_expand_order_struct));
+  if ( e.all_row != NULL && e.lit_var != NULL && e.lit_plane != NULL && order != NULL )
+  {
+    e.row = e.all_row + e.word_cnt;
+    e.ones = e.row + e.word_cnt;
+    e.twos = e.ones + e.word_cnt;
+    e.lit_state = e.lit_var + p->var_cnt;
+    for( j = 0; j < off->cnt; j++ )
+      if ( off->flags[j] == 0 )
+        e.all_row[j/64] |= ((uint64_t)1) << (j & 63);
+    for( j = 0; j < e.word_cnt; j++ )
+      e.all_row[j] &= e.s->valid[j];
+      
+    for( i = 0; i < l->cnt; i++ )
+    {
+      order[i].lit_cnt = bcp_GetCubeVariableCount(p, bcp_GetBCLCube(p, l, i));
+      order[i].pos = i;
+    }
+    qsort(order, l->cnt, sizeof(struct bcl_expand_order_struct), bcl_expand_order_compare);
+    
+    bcp_InvalidateBCLSlice(p, l);       // cubes of "l" are modified directly
+    sig = bcp_GetBCLSignature(p, l);    // kept up to date with bcp_UpdateBCLSignature()
+    for( k = 0; k < l->cnt; k++ )
+    {
+      i = order[k].pos;
+      if ( l->flags[i] != 0 )
+        continue;
+      c = bcp_GetBCLCube(p, l, i);
+      if ( bcp_ExpandCubeWithBlockingMatrix(p, &e, c) )
+      {
+        bcp_UpdateBCLSignature(p, l, i);
+        for( j = 0; j < l->cnt; j++ )
+          if ( j != i && l->flags[j] == 0 && bcp_IsSignatureSubsetPossible(sig[i], sig[j]) )
+            if ( bcp_IsSubsetCube(p, c, bcp_GetBCLCube(p, l, j)) )
+              l->flags[j] = 1;
+      }
+    }
+    bcp_PurgeBCL(p, l);  // remove all deleted cubes from "l"
+  }
+  free(order);
+  free(e.lit_plane);
+  free(e.lit_var);
+  free(e.all_row);
 }
 
 
@@ -6,40 +6,100 @@
 
 */
 #include "bc.h"
+#include <stdlib.h>
 #include <assert.h>
 
+/*
+  Large results are reduced with SCC whenever they have grown by a factor of four
+  since the last SCC, so that memory is not wasted for contained cubes until the end.
+*/
+#define BCL_INTERSECTION_SCC_MIN_CNT 65536
+
 /*
   calculates the intersection of a and b and stores the result into "result"
+  The larger list is indexed with the bit sliced view: For each cube of the smaller list 
+  only those cubes are visited, which do intersect with the cube. 
   this will apply SCC
+  returns 0 for memory error
 */
 int bcp_IntersectionBCLs(bcp p, bcl result, bcl a, bcl b)
 {
-  int i, j;
-  bc tmp;
-  
-  bcp_StartCubeStackFrame(p);
-  tmp = bcp_GetTempCube(p);
+  int i, j, k, w;
+  int row_pos;
+  int scc_cnt = BCL_INTERSECTION_SCC_MIN_CNT;
+  bcl t;
+  bcs s;
+  bc tmp, c;
+  uint64_t *mask = NULL;
+  uint64_t m;
   
   assert(result != a);
   assert(result != b);
   
+  if ( a->cnt < b->cnt )
+  {
+    t = a; a = b; b = t;        // "a" is the larger list, which is indexed
+  }
+  
+  bcp_StartStatOp(p, BCP_STAT_OP_INTERSECTION);
   bcp_ClearBCL(p, result);
+  s = bcp_GetBCLSlice(p, a);
+  if ( s != NULL )
+    mask = (uint64_t *)malloc(s->word_cnt*sizeof(uint64_t));
+  
+  bcp_StartCubeStackFrame(p);
+  tmp = bcp_GetTempCube(p);
   for( i = 0; i < b->cnt; i++ )
   {
-    bcp_ClearBCL(p, result);
-    for( j = 0; j < a->cnt; j++ )
+    if ( b->flags[i] != 0 )
+      continue;
+    c = bcp_GetBCLCube(p, b, i);
+    row_pos = result->cnt;
+    if ( mask != NULL )
     {
-      if ( bcp_IntersectionCube(p, tmp, bcp_GetBCLCube(p, a, j), bcp_GetBCLCube(p, b, i)) )
+      if ( bcp_GetBCLSliceIntersectionMask(p, a, c, mask) == 0 )
+        continue;
+      for( w = 0; w < s->word_cnt; w++ )
       {
-        if ( bcp_AddBCLCubeByCube(p, result, tmp) < 0 )
-          return bcp_EndCubeStackFrame(p), 0;
+        for( m = mask[w]; m != 0; m &= m - 1 )
+        {
+          j = w*64 + __builtin_ctzll(m);
+          if ( bcp_IsSubsetCube(p, bcp_GetBCLCube(p, a, j), c) )
+            break;
+          bcp_IntersectionCube(p, tmp, bcp_GetBCLCube(p, a, j), c);
+          if ( bcp_AddBCLCubeByCube(p, result, tmp) < 0 )
+            return bcp_EndCubeStackFrame(p), free(mask), bcp_EndStatOp(p, BCP_STAT_OP_INTERSECTION), 0;
+        }
+        if ( m != 0 )
+        {
+          /* "c" is a subset of a cube in "a": all other intersections of this row are subsets of "c" */
+          for( k = row_pos; k < result->cnt; k++ )
+            result->flags[k] = 1;
+          if ( bcp_AddBCLCubeByCube(p, result, c) < 0 )
+            return bcp_EndCubeStackFrame(p), free(mask), bcp_EndStatOp(p, BCP_STAT_OP_INTERSECTION), 0;
+          break;
+        }
       }
     }
+    else
+    {
+      /* no memory for the bit sliced view: test all pairs */
+      for( j = 0; j < a->cnt; j++ )
+        if ( a->flags[j] == 0 && bcp_IntersectionCube(p, tmp, bcp_GetBCLCube(p, a, j), c) )
+          if ( bcp_AddBCLCubeByCube(p, result, tmp) < 0 )
+            return bcp_EndCubeStackFrame(p), bcp_EndStatOp(p, BCP_STAT_OP_INTERSECTION), 0;
+    }
+    if ( result->cnt >= scc_cnt )
+    {
+      bcp_DoBCLSingleCubeContainment(p, result);
+      if ( scc_cnt < 4*result->cnt )
+        scc_cnt = 4*result->cnt;
+    }
   }
-  
-  bcp_DoBCLSingleCubeContainment(p, result);
-
   bcp_EndCubeStackFrame(p);  
+  free(mask);
+  bcp_DoBCLSingleCubeContainment(p, result);
+  bcp_EndStatOp(p, BCP_STAT_OP_INTERSECTION);
   return 1;
 }
 
@@ -51,7 +111,8 @@ int bcp_IntersectionBCL(bcp p, bcl a, bcl b)
   if ( bcp_IntersectionBCLs(p, result, a, b) == 0 )
     return bcp_DeleteBCL(p, result), 0;
   
-  bcp_CopyBCL(p, a, result);
+  if ( bcp_MoveBCL(p, a, result) == 0 )
+    return bcp_DeleteBCL(p, result), 0;
   bcp_DeleteBCL(p, result);
   return 1;
 }
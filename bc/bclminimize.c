@@ -8,9 +8,13 @@
 */
 
 #include "bc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <assert.h>
 
 /*
+  single pass minimization, bcp_MinimizeBCL() uses bcp_MinimizeBCLWithBudget()
   try to reduce the total number of element in "l" via some heuristics.
   The reduction is done by:
     - Widen the existing cubes
@@ -42,14 +46,239 @@ void bcp_MinimizeBCLWithSubtract(bcp p, bcl l)
 {
   bcl off_set = bcp_NewBCLComplementWithSubtract(p, l); // includes bcp_DoBCLMultiCubeContainment
   bcl result = bcp_NewBCLComplementWithSubtract(p, off_set); // includes bcp_DoBCLMultiCubeContainment
-  bcp_CopyBCL(p, l, result);
+  bcp_MoveBCL(p, l, result);
   bcp_DeleteBCL(p, off_set);
   bcp_DeleteBCL(p, result);
 }
 
+/*============================================================*/
+
+struct bcl_reduce_order_struct
+{
+  int lit_cnt;
+  int pos;
+};
+
+static int bcl_reduce_order_compare(const void *a, const void *b)
+{
+  const struct bcl_reduce_order_struct *x = (const struct bcl_reduce_order_struct *)a;
+  const struct bcl_reduce_order_struct *y = (const struct bcl_reduce_order_struct *)b;
+  if ( x->lit_cnt != y->lit_cnt )
+    return x->lit_cnt - y->lit_cnt;
+  return x->pos - y->pos;
+}
+
+/*
+  REDUCE
+
+  Replace each cube c of "l" by the smallest cube, which still contains all minterms of c, 
+  which are not covered by the other cubes of "l":
+    c := c & supercube(complement((l without c) cofactor c))
+  The cubes are reduced one after the other (largest cube first), so that "l" always covers 
+  the same function. Cubes which are covered by the other cubes are removed.
+  returns 0 for memory error, "l" is still a cover of the same function in this case
+*/
+int bcp_DoBCLReduce(bcp p, bcl l)
+{
+  struct bcl_reduce_order_struct *order;
+  bcl cf, cc;
+  bc c, sc, t;
+  int i, j, k, b, is_empty;
+  int is_ok = 1;
+  
+  order = (struct bcl_reduce_order_struct *)malloc((l->cnt+1)*sizeof(struct bcl_reduce_order_struct));
+  if ( order == NULL )
+    return 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    order[i].lit_cnt = bcp_GetCubeVariableCount(p, bcp_GetBCLCube(p, l, i));
+    order[i].pos = i;
+  }
+  qsort(order, l->cnt, sizeof(struct bcl_reduce_order_struct), bcl_reduce_order_compare);
+  
+  bcp_InvalidateBCLSlice(p, l);       // cubes of "l" are modified directly
+  bcp_StartCubeStackFrame(p);
+  sc = bcp_GetTempCube(p);
+  t = bcp_GetTempCube(p);
+  for( k = 0; k < l->cnt; k++ )
+  {
+    i = order[k].pos;
+    if ( l->flags[i] != 0 )
+      continue;
+    c = bcp_GetBCLCube(p, l, i);
+    bcp_StartBCLArenaFrame(p);        // cofactor and complement are allocated from the arena, see bcp_NewBCLComplement()
+    cf = bcp_NewBCLCofactorByCube(p, l, c, i);
+    cc = cf == NULL ? NULL : bcp_NewBCLComplement(p, cf);
+    if ( cc != NULL )
+    {
+      /* 
+        supercube of the complement inside "c": the variables of "c" are don't care in the cofactor, 
+        so the complement may also have minterms outside of "c"
+      */
+      is_empty = 1;
+      memset(sc, 0, p->bytes_per_cube_cnt);
+      for( j = 0; j < cc->cnt; j++ )
+        if ( cc->flags[j] == 0 && bcp_IntersectionCube(p, t, bcp_GetBCLCube(p, cc, j), c) != 0 )
+        {
+          is_empty = 0;
+          for( b = 0; b < p->blk_cnt; b++ )
+            _mm_storeu_si128(sc+b, _mm_or_si128(_mm_loadu_si128(sc+b), _mm_loadu_si128(t+b)));
+        }
+      if ( is_empty )
+        l->flags[i] = 1;        // "c" is covered by the other cubes
+      else
+      {
+        bcp_CopyCube(p, c, sc);
+        bcp_UpdateBCLSignature(p, l, i);
+      }
+    }
+    else
+      is_ok = 0;
+    if ( cc != NULL )
+      bcp_DeleteBCL(p, cc);
+    if ( cf != NULL )
+      bcp_DeleteBCL(p, cf);
+    bcp_EndBCLArenaFrame(p);
+    if ( is_ok == 0 )
+      break;
+  }
+  bcp_EndCubeStackFrame(p);
+  free(order);
+  bcp_PurgeBCL(p, l);
+  return is_ok;
+}
+
+static int bcp_GetBCLLiteralCnt(bcp p, bcl l)
+{
+  int i, cnt = 0;
+  for( i = 0; i < l->cnt; i++ )
+    if ( l->flags[i] == 0 )
+      cnt += bcp_GetCubeVariableCount(p, bcp_GetBCLCube(p, l, i));
+  return cnt;
+}
+
+/*
+  Espresso style minimization with a given off-set:
+    l := irredundant(expand(l, off))
+    repeat: l := irredundant(expand(reduce(l), off)) as long as the number of cubes or literals decreases
+  "off" must not intersect with "l". Points which are neither part of "l" nor of "off" are don't cares
+  for the expand step, so "l" may include an additional don't care set.
+  max_loop_cnt: max number of reduce/expand/irredundant loops, 0 for no limit
+  max_msec: no further loop is started after this CPU time (in milliseconds), 0 for no limit
+  returns 0 for memory error, "l" is still a cover of the same function in this case
+*/
+int bcp_MinimizeBCLWithOffSetBudget(bcp p, bcl l, bcl off, int max_loop_cnt, long max_msec)
+{
+  clock_t start = clock();
+  bcl best;
+  int loop, cube_cnt, lit_cnt, best_cube_cnt, best_lit_cnt;
+  int is_ok = 1;
+  
+  bcp_DoBCLExpandWithOffSet(p, l, off);
+  bcp_DoBCLSingleCubeContainment(p, l);
+  bcp_DoBCLMultiCubeContainment(p, l);
+  
+  best = bcp_NewBCLByBCL(p, l);
+  if ( best == NULL )
+    return 0;
+  best_cube_cnt = l->cnt;
+  best_lit_cnt = bcp_GetBCLLiteralCnt(p, l);
+  for( loop = 0; max_loop_cnt <= 0 || loop < max_loop_cnt; loop++ )
+  {
+    if ( max_msec > 0 && (clock() - start)*1000/CLOCKS_PER_SEC >= max_msec )
+      break;
+    if ( bcp_DoBCLReduce(p, l) == 0 )
+    {
+      is_ok = 0;
+      break;
+    }
+    bcp_DoBCLExpandWithOffSet(p, l, off);
+    bcp_DoBCLSingleCubeContainment(p, l);
+    bcp_DoBCLMultiCubeContainment(p, l);
+    
+    cube_cnt = l->cnt;
+    lit_cnt = bcp_GetBCLLiteralCnt(p, l);
+    if ( cube_cnt > best_cube_cnt || (cube_cnt == best_cube_cnt && lit_cnt >= best_lit_cnt) )
+      break;            // no improvement
+    best_cube_cnt = cube_cnt;
+    best_lit_cnt = lit_cnt;
+    if ( bcp_CopyBCL(p, best, l) == 0 )
+    {
+      is_ok = 0;
+      break;
+    }
+  }
+  /* the last loop might have been worse than the best result */
+  if ( l->cnt != best_cube_cnt || bcp_GetBCLLiteralCnt(p, l) != best_lit_cnt )
+    bcp_MoveBCL(p, l, best);
+  bcp_DeleteBCL(p, best);
+  return is_ok;
+}
+
+/*
+  Espresso style minimization:
+    off := complement(l)
+    continue with bcp_MinimizeBCLWithOffSetBudget()
+  The off-set is calculated only once, because the function of "l" does not change.
+  returns 0 for memory error, "l" is still a cover of the same function in this case
+*/
+int bcp_MinimizeBCLWithBudget(bcp p, bcl l, int max_loop_cnt, long max_msec)
+{
+  bcl off;
+  int is_ok;
+  
+  bcp_StartStatOp(p, BCP_STAT_OP_MINIMIZE);
+  bcp_DoBCLSingleCubeContainment(p, l);
+  off = bcp_NewBCLComplement(p, l);
+  if ( off == NULL )
+    return bcp_EndStatOp(p, BCP_STAT_OP_MINIMIZE), 0;
+  is_ok = bcp_MinimizeBCLWithOffSetBudget(p, l, off, max_loop_cnt, max_msec);
+  bcp_DeleteBCL(p, off);
+  bcp_EndStatOp(p, BCP_STAT_OP_MINIMIZE);
+  return is_ok;
+}
+
+/*
+  minimize "l" with the don't care set "dc"
+  "off" is the off-set, which must not intersect with "l" and "dc", if "off" is NULL, then
+  the off-set is calculated as complement of "l" and "dc".
+  After the minimization all cubes, which only cover don't cares, are removed from "l".
+  returns 0 for memory error, "l" is still a cover of the function, but may include don't cares in this case
+*/
+int bcp_MinimizeBCLWithDC(bcp p, bcl l, bcl dc, bcl off)
+{
+  bcl o = off;
+  int i;
+  int is_ok;
+  
+  bcp_StartStatOp(p, BCP_STAT_OP_MINIMIZE);
+  if ( bcp_AddBCLCubesByBCL(p, l, dc) == 0 )
+    return bcp_EndStatOp(p, BCP_STAT_OP_MINIMIZE), 0;
+  bcp_DoBCLSingleCubeContainment(p, l);
+  if ( o == NULL )
+  {
+    o = bcp_NewBCLComplement(p, l);
+    if ( o == NULL )
+      return bcp_EndStatOp(p, BCP_STAT_OP_MINIMIZE), 0;
+  }
+  is_ok = bcp_MinimizeBCLWithOffSetBudget(p, l, o, BCL_MINIMIZE_DEFAULT_LOOP_CNT, 0);
+  if ( o != off )
+    bcp_DeleteBCL(p, o);
+  if ( dc->cnt > 0 )
+  {
+    for( i = 0; i < l->cnt; i++ )
+      if ( l->flags[i] == 0 && bcp_IsBCLCubeCovered(p, dc, bcp_GetBCLCube(p, l, i)) )
+        l->flags[i] = 1;      // the cube does not cover any point of the on-set
+    bcp_PurgeBCL(p, l);
+  }
+  bcp_EndStatOp(p, BCP_STAT_OP_MINIMIZE);
+  return is_ok;
+}
+
 void bcp_MinimizeBCL(bcp p, bcl l)
 {
-  bcp_MinimizeBCLWithOffSet(p, l);
+  bcp_MinimizeBCLWithBudget(p, l, BCL_MINIMIZE_DEFAULT_LOOP_CNT, 0);
+  //bcp_MinimizeBCLWithOffSet(p, l);
   //bcp_MinimizeBCLWithSubtract(p, l);
 }
 
@@ -0,0 +1,521 @@
+/*
+
+  bclpla.c
+
+  Support for the Berkeley PLA file format (Espresso)
+
+    .i <in_cnt>
+    .o <out_cnt>                optional, default is 1
+    .ilb <input names>          optional
+    .ob <output names>          optional
+    .p <number of cubes>        optional, only used to reserve memory
+    .type f|fd|fr|fdr           optional, default is fd
+    <input part> <output part>  one line per cube, e.g. "1-0 10"
+    .e                          optional end marker
+
+  Input part: "0", "1", "-" or "2" (don't care)
+  Output part: "1" or "4" (on-set), "0" (off-set), "-" or "2" (don't care), "~" (not specified)
+  Which of the output values are used, depends on the type: "f" only uses the on-set, "fd" also the
+  don't care set, "fr" the on-set and the off-set and "fdr" all three sets.
+
+  All outputs are stored in one problem with in_cnt+out_cnt variables, the output variables
+  follow the input variables. A cube, which belongs to the set S of outputs, gets "-" for each output
+  in S and "0" for all other outputs. Such a cube covers the point, where output k is "1" and all
+  other outputs are "0", exactly if k is part of S. All points which do not have exactly one "1" in
+  the output variables are don't cares (see bcp_NewBCLDCByBCF()).
+  Adding an output to S is the expand of the output variable from "0" to "-", so one minimization
+  with one off-set for all outputs (see bcp_MinimizeBCF()) will share cubes between the outputs.
+  This is the binary version of the multiple valued output variable of Espresso.
+
+  The input is read line by line, so stdin and pipes can be used.
+
+*/
+
+#include "bc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static char *bcf_skip_space(char *s)
+{
+  while( *s != '\0' && (unsigned char)*s <= 32 )
+    s++;
+  return s;
+}
+
+/* compare the keyword at "s" with "key", returns the position after the keyword or NULL */
+static char *bcf_get_keyword(char *s, const char *key)
+{
+  size_t len = strlen(key);
+  if ( strncmp(s, key, len) != 0 )
+    return NULL;
+  if ( (unsigned char)s[len] > 32 )
+    return NULL;
+  return s + len;
+}
+
+/* read a non negative decimal value, returns 0 if there is no such value */
+static int bcf_get_value(char *s, int *value)
+{
+  char *e;
+  long v = strtol(s, &e, 10);
+  if ( e == s || v < 0 || v > 1000000000L )
+    return 0;
+  if ( *bcf_skip_space(e) != '\0' )
+    return 0;
+  *value = (int)v;
+  return 1;
+}
+
+/* create a vector with all names of the line, returns NULL for memory error */
+static co bcf_NewNameVector(char *s)
+{
+  char *e;
+  char c;
+  co v = coNewVector(CO_FREE_VALS);
+  if ( v == NULL )
+    return NULL;
+  for(;;)
+  {
+    s = bcf_skip_space(s);
+    if ( *s == '\0' )
+      return v;
+    e = s;
+    while( (unsigned char)*e > 32 )
+      e++;
+    c = *e;
+    *e = '\0';
+    if ( coVectorAdd(v, coNewStr(CO_STRDUP, s)) < 0 )
+      return *e = c, coDelete(v), NULL;
+    *e = c;
+    s = e;
+  }
+}
+
+/* create the problem and the lists, called with the first cube or at the end of the input */
+static int bcf_Init(bcf f, int cube_cnt)
+{
+  if ( f->p != NULL )
+    return 1;
+  if ( f->in_cnt < 0 )
+    return 0;           // ".i" is missing
+  f->p = bcp_New(f->in_cnt + f->out_cnt);
+  if ( f->p == NULL )
+    return 0;
+  f->on = bcp_NewBCL(f->p);
+  f->dc = bcp_NewBCL(f->p);
+  f->out_part = (char *)malloc(f->out_cnt + 1);
+  if ( f->on == NULL || f->dc == NULL || f->out_part == NULL )
+    return 0;
+  if ( f->type & BCF_TYPE_OFF )
+  {
+    f->off = bcp_NewBCL(f->p);
+    if ( f->off == NULL )
+      return 0;
+  }
+  if ( cube_cnt > 0 && bcp_ReserveBCL(f->p, f->on, cube_cnt) == 0 )
+    return 0;
+  return 1;
+}
+
+/* add the cube "x" with the given output value to "l", all other outputs get "0" */
+static int bcf_AddOutputCube(bcf f, bcl l, bc x, const char *value)
+{
+  bcp p = f->p;
+  bc c;
+  int k;
+  int pos = bcp_AddBCLCubeByCube(p, l, x);
+  if ( pos < 0 )
+    return 0;
+  c = bcp_GetBCLCube(p, l, pos);
+  for( k = 0; k < f->out_cnt; k++ )
+    if ( strchr(value, f->out_part[k]) == NULL )
+      bcp_SetCubeVar(p, c, f->in_cnt + k, 1);
+  bcp_UpdateBCLSignature(p, l, pos);
+  return 1;
+}
+
+/* parse one cube line, returns 0 for memory or syntax error */
+static int bcf_AddCubesByLine(bcf f, char *s)
+{
+  bcp p = f->p;
+  bc x;
+  bc c;
+  int i, k, pos;
+  int is_on = 0, is_dc = 0, is_ok = 1;
+
+  bcp_StartCubeStackFrame(p);
+  x = bcp_GetTempCube(p);
+  bcp_ClrCube(p, x);
+  for( i = 0; i < f->in_cnt && is_ok; i++ )
+  {
+    while( *s == ' ' || *s == '\t' || *s == '|' )
+      s++;
+    if ( *s == '0' )
+      bcp_SetCubeVar(p, x, i, 1);
+    else if ( *s == '1' )
+      bcp_SetCubeVar(p, x, i, 2);
+    else if ( *s != '-' && *s != '2' )
+      is_ok = 0;
+    s++;
+  }
+  for( k = 0; k < f->out_cnt && is_ok; k++ )
+  {
+    while( *s == ' ' || *s == '\t' || *s == '|' )
+      s++;
+    if ( *s == '4' )
+      f->out_part[k] = '1';
+    else if ( *s == '2' )
+      f->out_part[k] = '-';
+    else if ( *s == '1' || *s == '0' || *s == '-' || *s == '~' )
+      f->out_part[k] = *s;
+    else
+      is_ok = 0;
+    if ( f->out_part[k] == '1' )
+      is_on = 1;
+    if ( f->out_part[k] == '-' )
+      is_dc = 1;
+    s++;
+  }
+  if ( is_ok && *bcf_skip_space(s) != '\0' )
+    is_ok = 0;          // too many chars
+
+  if ( is_ok && is_on )
+    is_ok = bcf_AddOutputCube(f, f->on, x, "1");
+  if ( is_ok && is_dc && (f->type & BCF_TYPE_DC) )
+    is_ok = bcf_AddOutputCube(f, f->dc, x, "-");
+  if ( f->type & BCF_TYPE_OFF )
+  {
+    /* each off-set cube belongs to exactly one output, so that it does not intersect with any on-set cube */
+    for( k = 0; k < f->out_cnt && is_ok; k++ )
+    {
+      if ( f->out_part[k] == '0' )
+      {
+        pos = bcp_AddBCLCubeByCube(p, f->off, x);
+        if ( pos < 0 )
+        {
+          is_ok = 0;
+          break;
+        }
+        c = bcp_GetBCLCube(p, f->off, pos);
+        for( i = 0; i < f->out_cnt; i++ )
+          bcp_SetCubeVar(p, c, f->in_cnt + i, i == k ? 2 : 1);
+        bcp_UpdateBCLSignature(p, f->off, pos);
+      }
+    }
+  }
+  bcp_EndCubeStackFrame(p);
+  return is_ok;
+}
+
+/* parse one keyword line, returns 0 for memory or syntax error, 2 for the end marker */
+static int bcf_ParseKeyword(bcf f, char *s, int *cube_cnt)
+{
+  char *t;
+  if ( (t = bcf_get_keyword(s, ".i")) != NULL )
+    return f->p == NULL && bcf_get_value(t, &f->in_cnt);
+  if ( (t = bcf_get_keyword(s, ".o")) != NULL )
+    return f->p == NULL && bcf_get_value(t, &f->out_cnt) && f->out_cnt > 0;
+  if ( (t = bcf_get_keyword(s, ".p")) != NULL )
+    return bcf_get_value(t, cube_cnt);
+  if ( (t = bcf_get_keyword(s, ".ilb")) != NULL )
+  {
+    if ( f->in_name != NULL )
+      coDelete(f->in_name);
+    f->in_name = bcf_NewNameVector(t);
+    return f->in_name != NULL;
+  }
+  if ( (t = bcf_get_keyword(s, ".ob")) != NULL )
+  {
+    if ( f->out_name != NULL )
+      coDelete(f->out_name);
+    f->out_name = bcf_NewNameVector(t);
+    return f->out_name != NULL;
+  }
+  if ( (t = bcf_get_keyword(s, ".type")) != NULL )
+  {
+    if ( f->p != NULL )
+      return 0;         // the type must be known before the first cube
+    t = bcf_skip_space(t);
+    if ( bcf_get_keyword(t, "f") != NULL )
+      f->type = BCF_TYPE_ON;
+    else if ( bcf_get_keyword(t, "fd") != NULL )
+      f->type = BCF_TYPE_ON | BCF_TYPE_DC;
+    else if ( bcf_get_keyword(t, "fr") != NULL )
+      f->type = BCF_TYPE_ON | BCF_TYPE_OFF;
+    else if ( bcf_get_keyword(t, "fdr") != NULL )
+      f->type = BCF_TYPE_ON | BCF_TYPE_DC | BCF_TYPE_OFF;
+    else
+      return 0;
+    return 1;
+  }
+  if ( bcf_get_keyword(s, ".e") != NULL || bcf_get_keyword(s, ".end") != NULL )
+    return 2;
+  return 0;     // all other keywords (.mv, .kiss, .phase, ...) are not supported
+}
+
+/*
+  read a PLA from the current position of "fp"
+  "fp" is not closed by this function
+  returns NULL for memory error or for any syntax error
+*/
+bcf bcp_NewBCFByPLA(FILE *fp)
+{
+  char *line = NULL;
+  size_t line_size = 0;
+  char *s;
+  int r = 1;
+  int cube_cnt = 0;
+  bcf f = (bcf)malloc(sizeof(struct bcf_struct));
+  if ( f == NULL )
+    return NULL;
+  f->in_cnt = -1;
+  f->out_cnt = 1;
+  f->type = BCF_TYPE_ON | BCF_TYPE_DC;
+  f->p = NULL;
+  f->on = NULL;
+  f->dc = NULL;
+  f->off = NULL;
+  f->in_name = NULL;
+  f->out_name = NULL;
+  f->out_part = NULL;
+
+  while( r == 1 && getline(&line, &line_size, fp) >= 0 )
+  {
+    s = bcf_skip_space(line);
+    if ( *s == '\0' || *s == '#' )
+      continue;
+    if ( *s == '.' )
+      r = bcf_ParseKeyword(f, s, &cube_cnt);
+    else if ( bcf_Init(f, cube_cnt) == 0 )
+      r = 0;
+    else
+      r = bcf_AddCubesByLine(f, s);
+  }
+  free(line);
+  if ( r == 0 || bcf_Init(f, 0) == 0 )
+    return bcp_DeleteBCF(f), NULL;
+  if ( f->in_name != NULL && coVectorSize(f->in_name) != (size_t)f->in_cnt )
+    return bcp_DeleteBCF(f), NULL;
+  if ( f->out_name != NULL && coVectorSize(f->out_name) != (size_t)f->out_cnt )
+    return bcp_DeleteBCF(f), NULL;
+  bcp_ShrinkBCL(f->p, f->on);
+  return f;
+}
+
+/* "-" will read from stdin, returns NULL if the file can't be opened, for memory error or for any syntax error */
+bcf bcp_NewBCFByPLAName(const char *name)
+{
+  FILE *fp;
+  bcf f;
+  if ( strcmp(name, "-") == 0 )
+    return bcp_NewBCFByPLA(stdin);
+  fp = fopen(name, "r");
+  if ( fp == NULL )
+    return NULL;
+  f = bcp_NewBCFByPLA(fp);
+  fclose(fp);
+  return f;
+}
+
+void bcp_DeleteBCF(bcf f)
+{
+  if ( f->p != NULL )
+  {
+    if ( f->on != NULL )
+      bcp_DeleteBCL(f->p, f->on);
+    if ( f->dc != NULL )
+      bcp_DeleteBCL(f->p, f->dc);
+    if ( f->off != NULL )
+      bcp_DeleteBCL(f->p, f->off);
+    bcp_Delete(f->p);
+  }
+  if ( f->in_name != NULL )
+    coDelete(f->in_name);
+  if ( f->out_name != NULL )
+    coDelete(f->out_name);
+  free(f->out_part);
+  free(f);
+}
+
+/* returns 1, if the cube "c" covers the output "out": the output variable is not "0" and no other output variable is "1" */
+int bcp_IsBCFCubeOutput(bcf f, bc c, int out)
+{
+  int k;
+  for( k = 0; k < f->out_cnt; k++ )
+  {
+    if ( k == out )
+    {
+      if ( bcp_GetCubeVar(f->p, c, f->in_cnt + k) == 1 )
+        return 0;
+    }
+    else
+    {
+      if ( bcp_GetCubeVar(f->p, c, f->in_cnt + k) == 2 )
+        return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+  create the don't care set of all outputs: the explicit don't cares plus all points, where
+  not exactly one output variable is "1" (one cube with all outputs "0" and one cube for each pair of outputs)
+  returns NULL for memory error
+*/
+bcl bcp_NewBCLDCByBCF(bcf f)
+{
+  bcp p = f->p;
+  bc c;
+  int i, j, k, pos;
+  bcl l = bcp_NewBCLByBCL(p, f->dc);
+  if ( l == NULL )
+    return NULL;
+  pos = bcp_AddBCLCube(p, l);
+  if ( pos < 0 )
+    return bcp_DeleteBCL(p, l), NULL;
+  c = bcp_GetBCLCube(p, l, pos);
+  for( k = 0; k < f->out_cnt; k++ )
+    bcp_SetCubeVar(p, c, f->in_cnt + k, 1);
+  for( i = 0; i < f->out_cnt; i++ )
+  {
+    for( j = i+1; j < f->out_cnt; j++ )
+    {
+      pos = bcp_AddBCLCube(p, l);
+      if ( pos < 0 )
+        return bcp_DeleteBCL(p, l), NULL;
+      c = bcp_GetBCLCube(p, l, pos);
+      bcp_SetCubeVar(p, c, f->in_cnt + i, 2);
+      bcp_SetCubeVar(p, c, f->in_cnt + j, 2);
+    }
+  }
+  return l;
+}
+
+/*
+  minimize all outputs together, the result replaces the on-set
+  The off-set is calculated once for all outputs (or taken from the PLA for the types "fr" and "fdr").
+  returns 0 for memory error
+*/
+int bcp_MinimizeBCF(bcf f)
+{
+  int is_ok;
+  bcl dc = bcp_NewBCLDCByBCF(f);
+  if ( dc == NULL )
+    return 0;
+  is_ok = bcp_MinimizeBCLWithDC(f->p, f->on, dc, f->off);
+  bcp_DeleteBCL(f->p, dc);
+  return is_ok;
+}
+
+/*
+  create a list with all cubes of "l", which cover output "out", the output variables of the new list are "-"
+  "l" is f->on, f->dc or f->off, the new list belongs to f->p. Returns NULL for memory error.
+*/
+bcl bcp_NewBCLByBCFOutput(bcf f, bcl l, int out)
+{
+  bcp p = f->p;
+  bc c;
+  int i, k, pos;
+  bcl r = bcp_NewBCL(p);
+  if ( r == NULL )
+    return NULL;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] == 0 && bcp_IsBCFCubeOutput(f, bcp_GetBCLCube(p, l, i), out) )
+    {
+      pos = bcp_AddBCLCubeByCube(p, r, bcp_GetBCLCube(p, l, i));
+      if ( pos < 0 )
+        return bcp_DeleteBCL(p, r), NULL;
+      c = bcp_GetBCLCube(p, r, pos);
+      for( k = 0; k < f->out_cnt; k++ )
+        bcp_SetCubeVar(p, c, f->in_cnt + k, 3);
+      bcp_UpdateBCLSignature(p, r, pos);
+    }
+  }
+  return r;
+}
+
+static void bcf_WriteNames(cco v, const char *key, FILE *fp)
+{
+  size_t i;
+  if ( v == NULL )
+    return;
+  fputs(key, fp);
+  for( i = 0; i < coVectorSize(v); i++ )
+    fprintf(fp, " %s", coStrGet(coVectorGet(v, i)));
+  fputc('\n', fp);
+}
+
+/* write the cubes of "l", which cover at least one output, "value" is the output char for a covered output */
+static void bcf_WriteCubes(bcf f, bcl l, char value, FILE *fp)
+{
+  bcp p = f->p;
+  bc c;
+  int i, k, is_out;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] != 0 )
+      continue;
+    c = bcp_GetBCLCube(p, l, i);
+    is_out = 0;
+    for( k = 0; k < f->out_cnt; k++ )
+    {
+      f->out_part[k] = bcp_IsBCFCubeOutput(f, c, k) ? value : '0';
+      if ( f->out_part[k] == value )
+        is_out = 1;
+    }
+    f->out_part[f->out_cnt] = '\0';
+    if ( is_out )
+      fprintf(fp, "%.*s %s\n", f->in_cnt, bcp_GetStringFromCube(p, c), f->out_part);
+  }
+}
+
+static int bcf_GetOutputCubeCnt(bcf f, bcl l)
+{
+  int i, k;
+  int cnt = 0;
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( l->flags[i] != 0 )
+      continue;
+    for( k = 0; k < f->out_cnt; k++ )
+      if ( bcp_IsBCFCubeOutput(f, bcp_GetBCLCube(f->p, l, i), k) )
+        break;
+    if ( k < f->out_cnt )
+      cnt++;
+  }
+  return cnt;
+}
+
+/*
+  write the on-set and the explicit don't care set of "f" as PLA with the default type "fd"
+  The off-set of the types "fr" and "fdr" is not written.
+  returns 0 for write error
+*/
+int bcp_WriteBCFPLA(bcf f, FILE *fp)
+{
+  fprintf(fp, ".i %d\n.o %d\n", f->in_cnt, f->out_cnt);
+  bcf_WriteNames(f->in_name, ".ilb", fp);
+  bcf_WriteNames(f->out_name, ".ob", fp);
+  fprintf(fp, ".p %d\n", bcf_GetOutputCubeCnt(f, f->on) + bcf_GetOutputCubeCnt(f, f->dc));
+  bcf_WriteCubes(f, f->on, '1', fp);
+  bcf_WriteCubes(f, f->dc, '-', fp);
+  fprintf(fp, ".e\n");
+  return ferror(fp) == 0;
+}
+
+/* write "l" as PLA with all variables of "p" as inputs and one output, returns 0 for write error */
+int bcp_WriteBCLPLA(bcp p, bcl l, FILE *fp)
+{
+  int i, cnt = 0;
+  for( i = 0; i < l->cnt; i++ )
+    if ( l->flags[i] == 0 )
+      cnt++;
+  fprintf(fp, ".i %d\n.o 1\n.p %d\n", p->var_cnt, cnt);
+  for( i = 0; i < l->cnt; i++ )
+    if ( l->flags[i] == 0 )
+      fprintf(fp, "%s 1\n", bcp_GetStringFromCube(p, bcp_GetBCLCube(p, l, i)));
+  fprintf(fp, ".e\n");
+  return ferror(fp) == 0;
+}
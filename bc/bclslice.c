@@ -0,0 +1,283 @@
+/*
+
+  bclslice.c
+
+  boolean cube list: bit sliced view
+
+  The bit sliced view stores the cube list transposed: For each variable
+  and each of the two bits of the variable code there is one bitplane with
+  one bit per cube. A query against a single cube then only needs to
+  visit the planes of the literals of that cube (instead of all cubes of
+  the list) and will process 128 cubes with one SIMD operation.
+
+  The view is created on request by bcp_GetBCLSlice() and deleted by any
+  of the bcl functions, which change the list. Functions, which modify
+  the cubes of a list directly, must call bcp_InvalidateBCLSlice() or 
+  bcp_UpdateBCLSignature() for the modified cube. Both functions increment 
+  the modification counter of the list: The view remembers the counter and 
+  bcp_GetBCLSlice() will recreate the view, if the list has been modified 
+  after the view was created (the number of cubes alone will not change 
+  with an in-place modification).
+  bcp_GetBCLSlice() can be called by several threads for the same list.
+  
+  bcp_InvalidateBCLSlice() also clears the cube signatures of the list (see bcp_GetBCLSignature()).
+
+*/
+
+#include "bc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+static void bcp_DeleteBCS(bcs s)
+{
+  if ( s->plane != NULL )
+    free(s->plane);
+  free(s);
+}
+
+void bcp_InvalidateBCLSlice(bcp p, bcl l)
+{
+  if ( l->slice != NULL )
+    bcp_DeleteBCS(l->slice);
+  l->slice = NULL;
+  l->is_sig = 0;
+  l->mod_cnt++;
+}
+
+static bcs bcp_NewBCSByBCL(bcp p, bcl l)
+{
+  bcs s;
+  int i, w, var_pos, bit;
+  uint64_t *cw;
+  uint64_t literals;
+  uint64_t cube_bit;
+  size_t plane_size;
+
+  s = (bcs)malloc(sizeof(struct bcs_struct));
+  if ( s == NULL )
+    return NULL;
+  s->cnt = l->cnt;
+  s->mod_cnt = l->mod_cnt;
+  s->word_cnt = ((l->cnt + 127) / 128) * 2;
+  if ( s->word_cnt == 0 )
+    s->word_cnt = 2;
+  plane_size = (size_t)s->word_cnt * sizeof(uint64_t);
+  s->plane = (uint64_t *)malloc(plane_size * (2 * p->var_cnt + 1));
+  if ( s->plane == NULL )
+    return free(s), NULL;
+  s->valid = s->plane + (size_t)(2 * p->var_cnt) * s->word_cnt;
+
+  /* all planes start with 1 (don't care), only the literals are cleared */
+  memset(s->plane, 0xff, plane_size * (2 * p->var_cnt + 1));
+
+  for( i = 0; i < l->cnt; i++ )
+  {
+    cw = (uint64_t *)bcp_GetBCLCube(p, l, i);
+    cube_bit = ((uint64_t)1) << (i & 63);
+    for( w = 0; w < p->blk_cnt*2; w++ )
+    {
+      /* one bit for each variable, which is not don't care */
+      literals = ~(cw[w] & (cw[w] >> 1)) & 0x5555555555555555ULL;
+      while( literals != 0 )
+      {
+        bit = __builtin_ctzll(literals);
+        literals &= literals - 1;
+        var_pos = w*32 + bit/2;
+        if ( var_pos >= p->var_cnt )
+          break;
+        /* code 01 (zero) clears bit 1, code 10 (one) clears bit 0, code 00 clears both planes */
+        if ( (cw[w] & (((uint64_t)2) << bit)) == 0 )
+          s->plane[(size_t)(2*var_pos+1)*s->word_cnt + i/64] &= ~cube_bit;
+        if ( (cw[w] & (((uint64_t)1) << bit)) == 0 )
+          s->plane[(size_t)(2*var_pos)*s->word_cnt + i/64] &= ~cube_bit;
+        if ( ((cw[w] >> bit) & 3) == 0 )
+          s->valid[i/64] &= ~cube_bit;
+      }
+    }
+  }
+  return s;
+}
+
+/*
+  The view is installed with an atomic compare and exchange, so several threads may request the view
+  of the same (unmodified) list at the same time. If another thread was faster, the own view is discarded.
+*/
+bcs bcp_GetBCLSlice(bcp p, bcl l)
+{
+  bcs s = __atomic_load_n(&(l->slice), __ATOMIC_ACQUIRE);
+  bcs expected = NULL;
+  if ( s != NULL )
+  {
+    if ( s->cnt == l->cnt && s->mod_cnt == l->mod_cnt )
+      return s;
+    /* the list has been modified, this is only allowed for the owner of the list */
+    bcp_DeleteBCS(l->slice);
+    l->slice = NULL;
+  }
+  s = bcp_NewBCSByBCL(p, l);
+  if ( s == NULL )
+    return NULL;
+  if ( __atomic_compare_exchange_n(&(l->slice), &expected, s, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == 0 )
+  {
+    bcp_DeleteBCS(s);
+    s = expected;
+  }
+  return s;
+}
+
+/* set one bit in "mask" for each cube of "l", which is not deleted */
+static void bcp_SetBCLSliceFlagMask(bcp p, bcl l, bcs s, uint64_t *mask)
+{
+  int i;
+  memset(mask, 0, s->word_cnt*sizeof(uint64_t));
+  for( i = 0; i < l->cnt; i++ )
+    if ( l->flags[i] == 0 )
+      mask[i/64] |= ((uint64_t)1) << (i & 63);
+}
+
+/* mask := mask & plane, returns 0 if mask is empty */
+static int bcp_AndBCSPlane(bcs s, uint64_t *mask, const uint64_t *plane)
+{
+  int i;
+  __m128i m;
+  __m128i r = _mm_setzero_si128();
+  for( i = 0; i < s->word_cnt; i += 2 )
+  {
+    m = _mm_and_si128(_mm_loadu_si128((__m128i *)(mask+i)), _mm_loadu_si128((__m128i *)(plane+i)));
+    _mm_storeu_si128((__m128i *)(mask+i), m);
+    r = _mm_or_si128(r, m);
+  }
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(r, _mm_setzero_si128())) != 0xffff;
+}
+
+/* mask := mask & ~plane, returns 0 if mask is empty */
+static int bcp_AndNotBCSPlane(bcs s, uint64_t *mask, const uint64_t *plane)
+{
+  int i;
+  __m128i m;
+  __m128i r = _mm_setzero_si128();
+  for( i = 0; i < s->word_cnt; i += 2 )
+  {
+    m = _mm_andnot_si128(_mm_loadu_si128((__m128i *)(plane+i)), _mm_loadu_si128((__m128i *)(mask+i)));
+    _mm_storeu_si128((__m128i *)(mask+i), m);
+    r = _mm_or_si128(r, m);
+  }
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(r, _mm_setzero_si128())) != 0xffff;
+}
+
+/*
+  Calculate a mask with one bit for each cube of "l", which has an intersection with "c".
+  Deleted cubes are not part of the mask.
+  "mask" must have bcp_GetBCLSlice(p, l)->word_cnt entries.
+  returns:
+    0: there is no intersection (also returned for memory error)
+    1: at least one cube in "l" has an intersection with "c"
+*/
+int bcp_GetBCLSliceIntersectionMask(bcp p, bcl l, bc c, uint64_t *mask)
+{
+  bcs s = bcp_GetBCLSlice(p, l);
+  uint64_t *cw = (uint64_t *)c;
+  uint64_t literals;
+  int w, bit, var_pos;
+
+  if ( s == NULL )
+    return 0;
+  bcp_IncStat(p, BCP_STAT_SLICE_QUERY);
+  bcp_SetBCLSliceFlagMask(p, l, s, mask);
+  if ( bcp_AndBCSPlane(s, mask, s->valid) == 0 )  // cubes with illegal variables never intersect
+    return 0;
+  for( w = 0; w < p->blk_cnt*2; w++ )
+  {
+    literals = ~(cw[w] & (cw[w] >> 1)) & 0x5555555555555555ULL;
+    while( literals != 0 )
+    {
+      bit = __builtin_ctzll(literals);
+      literals &= literals - 1;
+      var_pos = w*32 + bit/2;
+      if ( var_pos >= p->var_cnt )
+        break;
+      switch( (cw[w] >> bit) & 3 )
+      {
+        case 0: // illegal variable in c
+          memset(mask, 0, s->word_cnt*sizeof(uint64_t));
+          return 0;
+        case 1: // zero in c: the cube in l must have bit 0 set
+          if ( bcp_AndBCSPlane(s, mask, s->plane + (size_t)(2*var_pos)*s->word_cnt) == 0 )
+            return 0;
+          break;
+        case 2: // one in c: the cube in l must have bit 1 set
+          if ( bcp_AndBCSPlane(s, mask, s->plane + (size_t)(2*var_pos+1)*s->word_cnt) == 0 )
+            return 0;
+          break;
+      }
+    }
+  }
+  return 1;
+}
+
+/*
+  Remove all cubes from "mask", which are not a subset of "c".
+  This is the core of bcp_GetBCLSliceSubsetMask(), but the mask is provided by the caller,
+  so that repeated queries can reuse a mask of the cubes, which are still of interest.
+  "s" is the view returned by bcp_GetBCLSlice().
+  returns:
+    0: mask is empty
+    1: at least one bit is left in "mask"
+*/
+int bcp_AndBCLSliceSubsetMask(bcp p, bcs s, bc c, uint64_t *mask)
+{
+  uint64_t *cw = (uint64_t *)c;
+  uint64_t literals;
+  int w, bit, var_pos;
+
+  bcp_IncStat(p, BCP_STAT_SLICE_QUERY);
+  for( w = 0; w < p->blk_cnt*2; w++ )
+  {
+    literals = ~(cw[w] & (cw[w] >> 1)) & 0x5555555555555555ULL;
+    while( literals != 0 )
+    {
+      bit = __builtin_ctzll(literals);
+      literals &= literals - 1;
+      var_pos = w*32 + bit/2;
+      if ( var_pos >= p->var_cnt )
+        break;
+      switch( (cw[w] >> bit) & 3 )
+      {
+        case 0: // illegal variable in c: the cube in l must also be illegal in this variable
+          if ( bcp_AndNotBCSPlane(s, mask, s->plane + (size_t)(2*var_pos)*s->word_cnt) == 0 )
+            return 0;
+          if ( bcp_AndNotBCSPlane(s, mask, s->plane + (size_t)(2*var_pos+1)*s->word_cnt) == 0 )
+            return 0;
+          break;
+        case 1: // zero in c: the cube in l must not have bit 1 set
+          if ( bcp_AndNotBCSPlane(s, mask, s->plane + (size_t)(2*var_pos+1)*s->word_cnt) == 0 )
+            return 0;
+          break;
+        case 2: // one in c: the cube in l must not have bit 0 set
+          if ( bcp_AndNotBCSPlane(s, mask, s->plane + (size_t)(2*var_pos)*s->word_cnt) == 0 )
+            return 0;
+          break;
+      }
+    }
+  }
+  return 1;
+}
+
+/*
+  Calculate a mask with one bit for each cube of "l", which is a subset of "c".
+  Deleted cubes are not part of the mask.
+  "mask" must have bcp_GetBCLSlice(p, l)->word_cnt entries.
+  returns:
+    0: no cube of "l" is a subset of "c" (also returned for memory error)
+    1: at least one cube in "l" is a subset of "c"
+*/
+int bcp_GetBCLSliceSubsetMask(bcp p, bcl l, bc c, uint64_t *mask)
+{
+  bcs s = bcp_GetBCLSlice(p, l);
+
+  if ( s == NULL )
+    return 0;
+  bcp_SetBCLSliceFlagMask(p, l, s, mask);
+  return bcp_AndBCLSliceSubsetMask(p, s, c, mask);
+}
@@ -14,7 +14,8 @@
   
   This code defines also 
     int bcp_IsBCLSubset(bcp p, bcl a, bcl b)
-  which just calles "bcp_IsBCLSubsetWithCofactor"
+  which calles "bcp_IsBCLSubsetWithTruthTable" for lists with only a few active variables
+  and "bcp_IsBCLSubsetWithCofactor" otherwise
   
 */
 #include "bc.h"
@@ -42,7 +43,13 @@ int bcp_IsBCLSubsetWithCofactor(bcp p, bcl a, bcl b)
 
 int bcp_IsBCLSubset(bcp p, bcl a, bcl b)
 {
-  return bcp_IsBCLSubsetWithCofactor(p, a, b);
+  int result;
+  bcp_StartStatOp(p, BCP_STAT_OP_SUBSET);
+  result = bcp_IsBCLSubsetWithTruthTable(p, a, b);        // only possible with a few active variables
+  if ( result < 0 )
+    result = bcp_IsBCLSubsetWithCofactor(p, a, b);
+  bcp_EndStatOp(p, BCP_STAT_OP_SUBSET);
+  return result;
 }
 
 /*
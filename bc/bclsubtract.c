@@ -24,32 +24,44 @@
 #include <assert.h>
 
 /*
-  Subtract cube b from a: a#b. All cubes resulting from this operation are appended to l if
-    - the new cube is valid
-    - the new cube is not covered by any other cube in l
-  After adding a cube, existing cubes are checked to be a subset of the newly added cube and marked for deletion if so
+  Subtract cube b from a: a#b. All cubes resulting from this operation are appended to l.
+  For each variable, which is not don't care in b, one cube is generated: The copy of "a", where
+  the variable is restricted to the values, which are not part of "b" (if this is possible).
+  Only the variables of "b" are visited: The literal mask of "b" is calculated for 64 bit words
+  (32 variables) and the set bits are located with ctz.
+  If "a" and "b" do not intersect, then a#b = a and only "a" is added.
+  The resulting cubes might be subsets of each other, use SCC to remove them.
 */
 static int bcp_DoBCLSharpOperation(bcp p, bcl l, bc a, bc b)
 {
-  int i;
-  unsigned bb;
-  unsigned orig_aa;
-  unsigned new_aa;
-  //int pos;
+  uint64_t *aw = (uint64_t *)a;
+  uint64_t *bw = (uint64_t *)b;
+  uint64_t *rw;
+  uint64_t literals;
+  uint64_t new_aa;
+  int w, bit, pos;
 
-  for( i = 0; i < p->var_cnt; i++ )
+  if ( bcp_IsIntersectionCube(p, a, b) == 0 )
+    return bcp_AddBCLCubeByCube(p, l, a) >= 0;
+  
+  for( w = 0; w < p->blk_cnt*2; w++ )
   {
-    bb = bcp_GetCubeVar(p, b, i);
-    if ( bb != 3 )
+    literals = ~(bw[w] & (bw[w] >> 1)) & 0x5555555555555555ULL;       // one bit for each variable of b, which is not don't care
+    while( literals != 0 )
     {
-      orig_aa = bcp_GetCubeVar(p, a, i); 
-      new_aa = orig_aa & (bb^3);
+      bit = __builtin_ctzll(literals);
+      literals &= literals - 1;
+      if ( w*32 + bit/2 >= p->var_cnt )
+        break;
+      new_aa = (aw[w] >> bit) & ~(bw[w] >> bit) & 3;
       if ( new_aa != 0 )
       {
-        bcp_SetCubeVar(p, a, i, new_aa);        // modify a 
-        if ( bcp_AddBCLCubeByCube(p, l, a) < 0 ) // if a is not subcube of any existing cube, then add the modified a cube to the list
+        pos = bcp_AddBCLCubeByCube(p, l, a);
+        if ( pos < 0 )
           return 0;  // memory error
-        bcp_SetCubeVar(p, a, i, orig_aa);        // undo the modification
+        rw = (uint64_t *)bcp_GetBCLCube(p, l, pos);
+        rw[w] = (rw[w] & ~(((uint64_t)3) << bit)) | (new_aa << bit);    // modify the copy of a 
+        bcp_UpdateBCLSignature(p, l, pos);
       }
     }
   }
@@ -65,24 +77,29 @@ static int bcp_DoBCLSharpOperation(bcp p, bcl l, bc a, bc b)
 int bcp_SubtractBCL(bcp p, bcl a, bcl b, int is_mcc)
 {
   int i, j;
-  bcl result = bcp_NewBCL(p);
+  bcl result;
+  bcp_StartStatOp(p, BCP_STAT_OP_SUBTRACT);
+  result = bcp_NewBCL(p);
   if ( result == NULL )
-    return 0;
+    return bcp_EndStatOp(p, BCP_STAT_OP_SUBTRACT), 0;
+  if ( bcp_ReserveBCL(p, result, a->cnt) == 0 )     // the result is usually at least as large as "a"
+    return bcp_DeleteBCL(p, result), bcp_EndStatOp(p, BCP_STAT_OP_SUBTRACT), 0;
   for( i = 0; i < b->cnt; i++ )
   {
     bcp_ClearBCL(p, result);
     for( j = 0; j < a->cnt; j++ )
     {
       if ( bcp_DoBCLSharpOperation(p, result, bcp_GetBCLCube(p, a, j), bcp_GetBCLCube(p, b, i)) == 0 )
-        return bcp_DeleteBCL(p, result), 0;
+        return bcp_DeleteBCL(p, result), bcp_EndStatOp(p, BCP_STAT_OP_SUBTRACT), 0;
     }
-    if ( bcp_CopyBCL(p, a, result) == 0 )
-        return bcp_DeleteBCL(p, result), 0;
+    if ( bcp_SwapBCL(p, a, result) == 0 )     // "result" gets the old content of "a", which is cleared in the next iteration
+        return bcp_DeleteBCL(p, result), bcp_EndStatOp(p, BCP_STAT_OP_SUBTRACT), 0;
     bcp_DoBCLSingleCubeContainment(p, a);
     if ( is_mcc )
       bcp_DoBCLMultiCubeContainment(p, a);
   }
   bcp_DeleteBCL(p, result);
+  bcp_EndStatOp(p, BCP_STAT_OP_SUBTRACT);
   return 1; // success
 }
 
@@ -62,83 +62,157 @@ int bc_is_2nd[1000];
 #endif // BC_TAUT_DEBUG
 
 
+static int bcp_uf_find(int *parent, int v)
+{
+  while( parent[v] != v )
+  {
+    parent[v] = parent[parent[v]];      // path halving
+    v = parent[v];
+  }
+  return v;
+}
+
+/* return the position of the first variable with a literal or -1 for the universal cube */
+static int bcp_GetCubeFirstLiteral(bcp p, bc c)
+{
+  int i;
+  uint64_t w, lit;
+  for( i = 0; i < p->blk_cnt*2; i++ )
+  {
+    w = ((uint64_t *)c)[i];
+    lit = ~(w & (w>>1)) & 0x5555555555555555ULL;
+    if ( lit != 0 )
+      return i*32 + __builtin_ctzll(lit)/2;
+  }
+  return -1;
+}
+
 /*
-  try to find independent partitions in BCL, for example
+  find the independent partitions of "l": cubes of different partitions do not have common variables, for example
   0---
   11--
   --01
   would contain two idependent problems: 11--/0--- and on the other side --01.
-  the partition will be written into the flags array, which means, that the flags array must be all 0 entries
+  The variables are grouped with a union find in one pass over the literals of all cubes.
+  The partition index (0..k-1) of each cube is written into the flags array, which means, that the flags array must be 
+  all 0 entries. If there are more than BCP_MAX_PARTITION_CNT partitions, then the remaining partitions are merged 
+  into the last one. The universal cube (no variables) is a partition of its own.
+  returns the number of partitions k (1 if there is no partition, 0 for an empty list)
 */
-int bcp_is_bcl_partition(bcp p, bcl l)
+int bcp_GetBCLPartition(bcp p, bcl l)
 {
+  int *parent = p->partition_var;
+  int *stamp = p->partition_var + p->var_cnt;
+  int *part = p->partition_var + 2*p->var_cnt;
   int cnt = l->cnt;
-  int i;
-  int other_partition_cnt = 0;
-  bc mask; // the current parition cube
-  bc mask2; // the other parition cube
-  unsigned bitcnt; // == variable count
-  unsigned nbitcnt; // == variable count
-  int is_changed;
-  if ( cnt <= 1 )
-    return 0;           // no partition if   there is only one entry
-  assert(l->flags[0] == 0);
-  bcp_StartCubeStackFrame(p);  
-  mask = bcp_GetTempCube(p);
-  mask2 = bcp_GetTempCube(p);
-  
-  // take the first cube in the list as a starting point
+  int i, j, b, v, r, first, gen, k = 0, universal = -1;
+  uint64_t w, lit;
   
-  bcp_GetVariableMask(p, mask, bcp_GetBCLCube(p, l, 0));
-  bitcnt = bcp_OrBitCnt(p, mask, mask, mask);
-  
-  // in the first step, try to see, how much variables are reached
+  if ( cnt <= 1 )
+    return cnt;
+  if ( p->partition_stamp >= 0x7ffffff0 )
+  {
+    memset(stamp, 0, p->var_cnt*sizeof(int));
+    p->partition_stamp = 0;
+  }
+  p->partition_stamp += 2;
+  gen = p->partition_stamp;     // stamp[v] == gen: parent[v] is valid, stamp[v] == gen+1: also part[v] is valid
   
-  do
+  for( i = 0; i < cnt; i++ )
   {
-    // printf("mask = %s\n", bcp_GetStringFromCube(p, mask));
-    // printf("bitcnt = %u\n", bitcnt);
-    is_changed = 0;
-    for( i = 1; i < cnt; i++ )
+    assert(l->flags[i] == 0);
+    first = -1;
+    for( j = 0; j < p->blk_cnt*2; j++ )
     {
-      bcp_GetVariableMask(p, mask2, bcp_GetBCLCube(p, l, i));
-      if ( bcp_IsAndZero(p, mask, mask2) == 0 )  // only if there is a connection between the variables
+      w = ((uint64_t *)bcp_GetBCLCube(p, l, i))[j];
+      lit = ~(w & (w>>1)) & 0x5555555555555555ULL;
+      while( lit != 0 )
       {
-        nbitcnt = bcp_OrBitCnt(p, mask, mask, mask2);
-        if ( bitcnt < nbitcnt  )
+        b = __builtin_ctzll(lit);
+        lit &= lit-1;
+        v = j*32 + b/2;
+        if ( stamp[v] != gen )
+        {
+          stamp[v] = gen;
+          parent[v] = v;
+        }
+        if ( first < 0 )
+          first = bcp_uf_find(parent, v);
+        else
         {
-          bitcnt = nbitcnt;
-          is_changed = 1;
+          r = bcp_uf_find(parent, v);
+          if ( r != first )
+            parent[r] = first;
         }
       }
     }
-  } while( is_changed != 0 );
-  
-  // now mask contains a bit for each variable which is connected with each other. Try find two partitions with this
+  }
   
-  for( i = 1; i < cnt; i++ )
+  for( i = 0; i < cnt; i++ )
   {
-    assert(l->flags[i] == 0);           // we need to assume here, that the flag is unussed so far, because it will be used to mark the partion
-    bcp_GetVariableMask(p, mask2, bcp_GetBCLCube(p, l, i));
-    if ( bcp_IsAndZero(p, mask, mask2) )
+    v = bcp_GetCubeFirstLiteral(p, bcp_GetBCLCube(p, l, i));
+    if ( v < 0 )
     {
-      other_partition_cnt++;            // partition found
-      l->flags[i] = 1;
+      if ( universal < 0 )
+        universal = k < BCP_MAX_PARTITION_CNT ? k++ : k-1;
+      l->flags[i] = universal;
+      continue;
     }
+    r = bcp_uf_find(parent, v);
+    if ( stamp[r] == gen )
+    {
+      stamp[r] = gen+1;
+      part[r] = k < BCP_MAX_PARTITION_CNT ? k++ : k-1;
+    }
+    l->flags[i] = part[r];
   }
-  
-  if ( other_partition_cnt == 0 )
-    return bcp_EndCubeStackFrame(p), 0;         // no partition found
-  
-  // at this point the two partions marked in the flag
-  // for one partion all flags are zero, for the other parition the flags are 1
+  if ( k == 1 )
+    memset(l->flags, 0, cnt);
+  return k;
+}
 
-  bcp_EndCubeStackFrame(p);  
-  //printf("Partition %d/%d\n", other_partition_cnt, l->cnt);
-  //bcp_ShowBCL(p, l);
+/*
+  two way partition: the first partition of bcp_GetBCLPartition() gets flag 0, all other partitions get flag 1
+  the flags array must be all 0 entries
+  returns 1 if there is a partition
+*/
+int bcp_is_bcl_partition(bcp p, bcl l)
+{
+  int i, cnt = l->cnt;
+  if ( bcp_GetBCLPartition(p, l) <= 1 )
+    return 0;
+  for( i = 0; i < cnt; i++ )
+    if ( l->flags[i] != 0 )
+      l->flags[i] = 1;
   return 1;
 }
 
+/*
+  create one list for each of the "k" partitions, found by bcp_GetBCLPartition(), and clear the flags of "l"
+  "f" must have "k" entries. returns 0 for memory error
+*/
+int bcp_NewBCLsByPartition(bcp p, bcl l, int k, bcl *f)
+{
+  int i, cnt = l->cnt, is_ok = 1;
+  for( i = 0; i < k; i++ )
+  {
+    f[i] = bcp_NewBCL(p);
+    if ( f[i] == NULL )
+      is_ok = 0;
+  }
+  for( i = 0; i < cnt && is_ok; i++ )
+    if ( bcp_AddBCLCubeByCube(p, f[l->flags[i]], bcp_GetBCLCube(p, l, i)) < 0 )
+      is_ok = 0;
+  for( i = 0; i < cnt; i++ )
+    l->flags[i] = 0;
+  if ( is_ok )
+    return 1;
+  for( i = 0; i < k; i++ )
+    if ( f[i] != NULL )
+      bcp_DeleteBCL(p, f[i]);
+  return 0;
+}
+
 bcl bcp_NewBCLByFlag(bcp p, bcl l, uint8_t flag)
 {
   int cnt = l->cnt;
@@ -160,11 +234,26 @@ bcl bcp_NewBCLByFlag(bcp p, bcl l, uint8_t flag)
 // then both calculations have to be done
 // so the unate precheck does not improve performance soo much (maybe 5%)
 //#define BCL_TAUTOLOGY_WITH_UNATE_PRECHECK
-int bcp_IsBCLTautologySub(bcp p, bcl l, int depth, int is_2nd)
+
+/*
+  "t" is the binate split table for "l" or NULL. 
+  If "t" is NULL, then the table is calculated from "l".
+  The tables for the sub problems are derived from "t" (see bcp_NewBCLCofacterByVariableWithBCT()),
+  so that the full count of all cubes is only done at the top level.
+  "t" is not modified.
+  The sub problems are checked with bcp_IsBCLTautologySub(), so that they can be found in the tautology cache.
+  For the multi threaded check (see bcltautologymt.c), each partition is checked in its own scope and
+  the binate split of larger lists is done by bcp_IsBCLTautologyCofactorMT().
+*/
+int bcp_IsBCLTautologyRecursion(bcp p, bcl l, bct t, int depth, int is_2nd)
 {
   int var_pos;
+  int result;
+  int k;
   bcl f1;
   bcl f2;
+  bct ct;
+  struct bcp_taut_scope_struct scope;
   
 #ifdef BCL_TAUTOLOGY_WITH_UNATE_PRECHECK  
   int is_unate;
@@ -185,38 +274,82 @@ int bcp_IsBCLTautologySub(bcp p, bcl l, int depth, int is_2nd)
   if ( l->cnt > 1 )
   {
     
-    if ( bcp_is_bcl_partition(p, l) != 0 )
+    k = bcp_GetBCLPartition(p, l);
+    if ( k > 1 )
     {
-      f1 = bcp_NewBCLByFlag(p, l, 0);
-      f2 = bcp_NewBCLByFlag(p, l, 1);
-      assert( f1 != NULL );
-      assert( f2 != NULL );
-      assert( f1->cnt < l->cnt);
-      assert( f2->cnt < l->cnt);
-      memset(l->flags, 0, l->cnt);      // clear all flags which had been set by the partition finder
+      bcp_AddStat(p, BCP_STAT_PARTITION, k);
+      bcl *f;
+      bct acc = NULL;   // table of the largest partition: "t" minus the tables of all other partitions
+      int i, largest = 0;
+      
+      bcp_StartBCLArenaFrame(p);        // the partitions and all lists of the sub problems are released with bcp_EndBCLArenaFrame()
+      f = (bcl *)bcp_ResizeBCLArenaMemory(p, NULL, 0, k*sizeof(bcl));
+      assert( f != NULL );
+      i = bcp_NewBCLsByPartition(p, l, k, f);   // also clears the flags of "l"
+      assert( i != 0 );
 
 #ifdef BC_TAUT_DEBUG 
   bc_var_stack[depth] = -2;
   bc_is_2nd[depth] = is_2nd;
 #endif // BC_TAUT_DEBUG
-      
-      // if either f1 or f2 is a tautology, then the complete list is tautology
-      if ( bcp_IsBCLTautologySub(p, f1, depth+1, 0) != 0 )
-        return bcp_DeleteBCL(p,  f1), bcp_DeleteBCL(p,  f2), 1;
-      if ( bcp_IsBCLTautologySub(p, f2, depth+1, 1) != 0 )
-        return bcp_DeleteBCL(p,  f1), bcp_DeleteBCL(p,  f2), 1;
 
-      return bcp_DeleteBCL(p,  f1), bcp_DeleteBCL(p,  f2), 0; // neither f1 nor f2 are tautology, return 0;
+      for( i = 1; i < k; i++ )
+        if ( f[i]->cnt > f[largest]->cnt )
+          largest = i;
+      if ( t != NULL && t->cnt < BCT_INCREMENTAL_MAX_CNT )
+      {
+        acc = bcp_NewBCT(p);
+        assert( acc != NULL );
+        bcp_CopyBCT(p, acc, t);
+      }
+      
+      // if any partition is a tautology, then the complete list is tautology
+      result = 0;
+      for( i = 0; i < k && result == 0; i++ )
+      {
+        if ( i != largest )
+        {
+          bct ti = bcp_NewBCT(p);
+          assert( ti != NULL );
+          bcp_CalcBCLBinateSplitVariableTable(p, ti, f[i]);
+          bcp_StartTautologyScope(p, &scope);
+          result = bcp_IsBCLTautologySub(p, f[i], ti, depth+1, i > 0);
+          result = bcp_EndTautologyScope(p, &scope, result);
+          if ( acc != NULL )
+            bcp_SubtractBCT(p, acc, ti);
+          bcp_DeleteBCT(p, ti);
+        }
+      }
+      if ( result == 0 )
+      {
+        bcp_StartTautologyScope(p, &scope);
+        result = bcp_IsBCLTautologySub(p, f[largest], acc, depth+1, largest > 0);
+        result = bcp_EndTautologyScope(p, &scope, result);
+      }
+      if ( acc != NULL )
+        bcp_DeleteBCT(p, acc);
+      for( i = 0; i < k; i++ )
+        bcp_DeleteBCL(p, f[i]);
+      return bcp_EndBCLArenaFrame(p), result;
     }
   }
   
-  bcp_CalcBCLBinateSplitVariableTable(p, l);
+  if ( t == NULL )
+  {
+    // no table from the caller, calculate the table for "l" and continue with that table
+    t = bcp_NewBCT(p);
+    assert( t != NULL );
+    bcp_CalcBCLBinateSplitVariableTable(p, t, l);
+    result = bcp_IsBCLTautologyRecursion(p, l, t, depth, is_2nd);
+    bcp_DeleteBCT(p, t);
+    return result;
+  }
 
   // if bcp_IsBCLUnate() return 1, then bcp_GetBCLMaxBinateSplitVariable() will return -1 !
   // however bcp_IsBCLUnate() is much faster then bcp_GetBCLMaxBinateSplitVariable()
   
 #ifdef BCL_TAUTOLOGY_WITH_UNATE_PRECHECK  
-  is_unate = bcp_IsBCLUnate(p);
+  is_unate = bcp_IsBCLUnate(p, t);
   if ( is_unate )
   {
     int i, cnt = l->cnt;
@@ -230,7 +363,7 @@ int bcp_IsBCLTautologySub(bcp p, bcl l, int depth, int is_2nd)
   }
 #endif
 
-  var_pos = bcp_GetBCLMaxBinateSplitVariable(p, l);     // bcp_GetBCLMaxBinateSplitVariableSimple has similar performance
+  var_pos = bcp_GetBCLMaxBinateSplitVariable(p, t, l);     // bcp_GetBCLMaxBinateSplitVariableSimple has similar performance
 #ifdef BC_TAUT_DEBUG 
   bc_var_stack[depth] = var_pos;
   bc_is_2nd[depth] = is_2nd;
@@ -262,43 +395,189 @@ int bcp_IsBCLTautologySub(bcp p, bcl l, int depth, int is_2nd)
   /*
   if ( var_pos < 0 )
   {
-    printf("split var simple %d\n", bcp_GetBCLMaxBinateSplitVariableSimple(p, l));
+    printf("split var simple %d\n", bcp_GetBCLMaxBinateSplitVariableSimple(p, t, l));
   }
   */
 
   assert( var_pos >= 0 );
-  f1 = bcp_NewBCLCofacterByVariable(p, l, var_pos, 1);
-  f2 = bcp_NewBCLCofacterByVariable(p, l, var_pos, 2);
-  assert( f1 != NULL );
-  assert( f2 != NULL );
   
+  result = bcp_IsBCLTautologyCofactorMT(p, l, t, var_pos, depth);
+  if ( result >= 0 )
+    return result;
+  
+  /* the table "ct" is used for both sub problems: f2 is created after f1 has been checked */
+  ct = bcp_NewBCT(p);
+  assert( ct != NULL );
   
+  bcp_StartBCLArenaFrame(p);
+  f1 = bcp_NewBCLCofacterByVariableWithBCT(p, l, t, ct, var_pos, 1);
+  assert( f1 != NULL );
   //assert( bcp_IsPurgeUsefull(p, f1) == 0 );
-  //assert( bcp_IsPurgeUsefull(p, f2) == 0 );
 
 #ifdef BC_TAUT_DEBUG 
-/*
-  printf("l f1\n");
-  bcp_Show2BCL(p, l, f1);
-  printf("l f2\n");
-  bcp_Show2BCL(p, l, f2);
-  */
-
   bcp_IsBCLVariableUnate(p, f1, var_pos, 1);
+#endif // BC_TAUT_DEBUG
+
+  result = bcp_IsBCLTautologySub(p, f1, ct, depth+1, 0);
+  bcp_DeleteBCL(p,  f1);
+  bcp_EndBCLArenaFrame(p);
+  if ( result == 0 )
+    return bcp_DeleteBCT(p, ct), 0;
+
+  bcp_StartBCLArenaFrame(p);
+  f2 = bcp_NewBCLCofacterByVariableWithBCT(p, l, t, ct, var_pos, 2);
+  assert( f2 != NULL );
+  //assert( bcp_IsPurgeUsefull(p, f2) == 0 );
+
+#ifdef BC_TAUT_DEBUG 
   bcp_IsBCLVariableUnate(p, f2, var_pos, 2);
 #endif // BC_TAUT_DEBUG
 
+  result = bcp_IsBCLTautologySub(p, f2, ct, depth+1, 1);
+  bcp_DeleteBCL(p,  f2);
+  bcp_EndBCLArenaFrame(p);
+  return bcp_DeleteBCT(p, ct), result;
+}
+
+/*
+  lists with up to this number of active variables are decided with a truth table, see bcltruthtable.c
+  the truth table has 2^(BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT-6) words on the stack
+*/
+#ifndef BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT
+#define BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT 12
+#endif
+
+/*
+  decide simple cases without recursion, returns -1 if the check was not successful
+  The checks are done in one pass over the cubes, which are not deleted, and are applied to each node of the recursion:
+    - a cube without literal is the universal cube
+    - OR is not the universal cube: all cubes have the same literal for a variable, so there is no tautology
+    - a cube with k literals covers 2^-k of all minterms: if the sum is below 1, then there is no tautology
+    - AND has at most BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT variables, which are not don't care: use a truth table
+  The minterm check is useful for the sub problems, although the sum of both cofactors is twice the sum of the 
+  parent: The sum is not split evenly, so one of the cofactors may fall below 1. Additionally the cofactor 
+  removes cubes, which are covered by another cube.
+  If "l" contains deleted cubes and the check was not successful, then "l" is purged, because the partition 
+  finder of bcp_IsBCLTautologyRecursion() requires a list without deleted cubes.
+*/
+static int bcp_IsBCLTautologyLeaf(bcp p, bcl l)
+{
+  int i, j, k, cnt = l->cnt;
+  int live_cnt = 0;
+  bc or_cube;
+  bc and_cube;
+  bc lc;
+  __m128i c;
+  double minterm_sum = 0.0;
+  int var_pos[BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT];
+  uint64_t tt[1<<(BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT > 6 ? BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT-6 : 0)];
+  int var_cnt;
+  
+  if ( cnt <= 1 && (cnt == 0 || l->flags[0] == 0) )
+    return -1;          // handled by bcp_IsBCLTautologyRecursion()
+  bcp_StartCubeStackFrame(p);
+  or_cube = bcp_GetTempCube(p);
+  and_cube = bcp_GetTempCube(p);
+  memset(or_cube, 0, p->bytes_per_cube_cnt);
+  bcp_CopyGlobalCube(p, and_cube, 3);
+  for( i = 0; i < cnt; i++ )
+  {
+    if ( l->flags[i] != 0 )
+      continue;
+    live_cnt++;
+    lc = bcp_GetBCLCube(p, l, i);
+    k = bcp_GetCubeVariableCount(p, lc);
+    if ( k == 0 )
+    {
+      p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_UNIVERSAL]++;
+      return bcp_EndCubeStackFrame(p), 1;
+    }
+    if ( k < 64 )
+      minterm_sum += 1.0 / (double)((uint64_t)1 << k);  // cubes with more literals are ignored (rounded down to 0)
+    for( j = 0; j < p->blk_cnt; j++ )
+    {
+      c = _mm_loadu_si128(lc+j);
+      _mm_storeu_si128(or_cube+j, _mm_or_si128(_mm_loadu_si128(or_cube+j), c));
+      _mm_storeu_si128(and_cube+j, _mm_and_si128(_mm_loadu_si128(and_cube+j), c));
+    }
+  }
+  
+  if ( live_cnt == 0 )
+    return bcp_EndCubeStackFrame(p), 0;         // only deleted cubes, this is the empty list
+  
+  if ( bcp_IsTautologyCube(p, or_cube) == 0 )
+  {
+    p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_LITERAL]++;
+    return bcp_EndCubeStackFrame(p), 0;
+  }
   
-  if ( bcp_IsBCLTautologySub(p, f1, depth+1, 0) == 0 )
-    return bcp_DeleteBCL(p,  f1), bcp_DeleteBCL(p,  f2), 0;
-  if ( bcp_IsBCLTautologySub(p, f2, depth+1, 1) == 0 )
-    return bcp_DeleteBCL(p,  f1), bcp_DeleteBCL(p,  f2), 0;
+  /* the sum might have been rounded down, so allow an error of 2^-52 for each cube */
+  if ( minterm_sum < 1.0 - (double)live_cnt / (double)((uint64_t)1 << 52) )
+  {
+    p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_MINTERM]++;
+    return bcp_EndCubeStackFrame(p), 0;
+  }
+  
+  var_cnt = bcp_GetCubeActiveVariables(p, and_cube, var_pos, BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT);
+  bcp_EndCubeStackFrame(p);
+  if ( var_cnt <= BCP_TAUTOLOGY_TRUTH_TABLE_MAX_VAR_CNT )
+  {
+    p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_TRUTH_TABLE]++;
+    bcp_GetBCLTruthTable(p, l, var_pos, var_cnt, tt);
+    return bcp_IsTruthTableTautology(tt, var_cnt);
+  }
+  
+  if ( live_cnt < cnt )
+    bcp_PurgeBCL(p, l);
+  return -1;
+}
 
+void bcp_ShowTautologyLeafStatistics(bcp p)
+{
+  printf("tautology leaf: universal=%ld literal=%ld minterm=%ld truth table=%ld\n",
+    p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_UNIVERSAL],
+    p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_LITERAL],
+    p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_MINTERM],
+    p->tautology_leaf_cnt[BCP_TAUTOLOGY_LEAF_TRUTH_TABLE]);
+}
 
-  return bcp_DeleteBCL(p,  f1), bcp_DeleteBCL(p,  f2), 1;
+/*
+  Same as bcp_IsBCLTautologyRecursion(), but simple cases are decided by bcp_IsBCLTautologyLeaf() and
+  if the tautology cache is enabled for the context, then the result for "l" is taken from the cache or added to the cache.
+*/
+int bcp_IsBCLTautologySub(bcp p, bcl l, bct t, int depth, int is_2nd)
+{
+  int result;
+  if ( p->tautology_worker != NULL && bcp_IsTautologyCancel(p) )
+    return 0;           // the result is not required any more, see bcltautologymt.c
+  bcp_IncStat(p, BCP_STAT_TAUTOLOGY_NODE);
+  bcp_UpdateStatDepth(p, depth);
+  result = bcp_IsBCLTautologyLeaf(p, l);
+  if ( result >= 0 )
+    return result;
+  if ( p->tautology_cache != NULL && l->cnt >= p->tautology_cache->min_cnt )
+    return bcp_IsBCLTautologyWithCache(p, l, t, depth, is_2nd);
+  return bcp_IsBCLTautologyRecursion(p, l, t, depth, is_2nd);
 }
 
+/*
+  "l" is not modified, so the same list can be checked by several threads (each with its own context).
+  The partition finder uses the flags of the list, so the check is done on a copy of "l".
+  Use bcp_IsBCLTautologySub(p, l, NULL, 0, 0) directly, if "l" is a private list of the caller.
+*/
 int bcp_IsBCLTautology(bcp p, bcl l)
 {
-  return bcp_IsBCLTautologySub(p, l, 0, 0);
+  int result;
+  bcl n;
+  bcp_StartStatOp(p, BCP_STAT_OP_TAUTOLOGY);
+  bcp_StartBCLArenaFrame(p);
+  n = bcp_NewBCLByBCL(p, l);
+  assert( n != NULL );
+  if ( bcp_IsPurgeUsefull(p, n) )
+    bcp_PurgeBCL(p, n);
+  result = bcp_IsBCLTautologySub(p, n, NULL, 0, 0);
+  bcp_DeleteBCL(p, n);
+  bcp_EndBCLArenaFrame(p);
+  bcp_EndStatOp(p, BCP_STAT_OP_TAUTOLOGY);
+  return result;
 }
@@ -0,0 +1,223 @@
+/*
+
+  bcltautologycache.c
+
+  boolean cube list: cache for the results of the tautology check
+
+  The expand and the multi cube containment operation will call the tautology check
+  for many similar lists. The recursion of the tautology check will often reach
+  the same sub problem again, maybe with a different order of the cubes.
+  The cache stores the result for those sub problems, see struct bcm_struct in bc.h
+
+*/
+
+#include "bc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+
+/* one cube of the list, which is sorted to get the canonical order of the cubes */
+struct bcm_sort_struct
+{
+  uint64_t hash;
+  bc cube;
+  int bytes;
+};
+
+static uint64_t bcp_mix64(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+static uint64_t bcp_GetCubeHash(bcp p, bc c)
+{
+  const uint64_t *w = (const uint64_t *)c;
+  int i, cnt = p->bytes_per_cube_cnt / sizeof(uint64_t);
+  uint64_t h = 0x9e3779b97f4a7c15ULL;
+  for( i = 0; i < cnt; i++ )
+    h = (h ^ w[i]) * 0x100000001b3ULL + (h >> 29);
+  return bcp_mix64(h);
+}
+
+static int bcp_bcm_sort_compare(const void *a, const void *b)
+{
+  const struct bcm_sort_struct *x = (const struct bcm_sort_struct *)a;
+  const struct bcm_sort_struct *y = (const struct bcm_sort_struct *)b;
+  if ( x->hash < y->hash )
+    return -1;
+  if ( x->hash > y->hash )
+    return 1;
+  return memcmp(x->cube, y->cube, x->bytes);
+}
+
+/*
+  enable the tautology cache for the context "p"
+  mem_budget: max number of bytes for the cubes of all cache entries, 0 for a default of 64MB
+  min_cnt: lists with fewer cubes are not cached, 0 for the default BCM_DEFAULT_MIN_CNT
+  If the cache already exists, then only the parameters are updated.
+  returns 0 for memory error
+*/
+int bcp_EnableTautologyCache(bcp p, size_t mem_budget, int min_cnt)
+{
+  bcm m = p->tautology_cache;
+  if ( mem_budget == 0 )
+    mem_budget = (size_t)64*1024*1024;
+  if ( min_cnt <= 1 )
+    min_cnt = BCM_DEFAULT_MIN_CNT;
+  if ( m == NULL )
+  {
+    m = (bcm)malloc(sizeof(struct bcm_struct));
+    if ( m == NULL )
+      return 0;
+    m->slot_cnt = BCM_DEFAULT_SLOT_CNT;
+    m->slot = (struct bcm_entry_struct *)calloc(m->slot_cnt, sizeof(struct bcm_entry_struct));
+    if ( m->slot == NULL )
+      return free(m), 0;
+    m->mem_used = 0;
+    m->hit_cnt = 0;
+    m->miss_cnt = 0;
+    m->collision_cnt = 0;
+    m->flush_cnt = 0;
+    p->tautology_cache = m;
+  }
+  m->mem_budget = mem_budget;
+  m->min_cnt = min_cnt;
+  return 1;
+}
+
+void bcp_ClearTautologyCache(bcp p)
+{
+  bcm m = p->tautology_cache;
+  int i;
+  if ( m == NULL )
+    return;
+  for( i = 0; i < m->slot_cnt; i++ )
+  {
+    free(m->slot[i].list);
+    m->slot[i].list = NULL;
+    m->slot[i].cnt = 0;
+  }
+  m->mem_used = 0;
+}
+
+void bcp_DisableTautologyCache(bcp p)
+{
+  if ( p->tautology_cache == NULL )
+    return;
+  bcp_ClearTautologyCache(p);
+  free(p->tautology_cache->slot);
+  free(p->tautology_cache);
+  p->tautology_cache = NULL;
+}
+
+void bcp_ShowTautologyCacheStatistics(bcp p)
+{
+  bcm m = p->tautology_cache;
+  if ( m == NULL )
+  {
+    puts("tautology cache disabled");
+    return;
+  }
+  printf("tautology cache: hit=%ld miss=%ld collision=%ld flush=%ld memory=%zu/%zu\n",
+    m->hit_cnt, m->miss_cnt, m->collision_cnt, m->flush_cnt, m->mem_used, m->mem_budget);
+}
+
+/*
+  copy the cubes of "l" in canonical order into a new memory area and calculate the hash of the list
+  returns NULL for memory error
+*/
+static __m128i *bcp_NewCanonicalCubeList(bcp p, bcl l, uint64_t *hash)
+{
+  int i;
+  uint64_t h = (uint64_t)l->cnt;
+  struct bcm_sort_struct *s;
+  __m128i *list = (__m128i *)malloc((size_t)l->cnt*p->bytes_per_cube_cnt);
+  if ( list == NULL )
+    return NULL;
+  s = (struct bcm_sort_struct *)malloc(l->cnt*sizeof(struct bcm_sort_struct));
+  if ( s == NULL )
+    return free(list), NULL;
+
+  for( i = 0; i < l->cnt; i++ )
+  {
+    s[i].cube = bcp_GetBCLCube(p, l, i);
+    s[i].hash = bcp_GetCubeHash(p, s[i].cube);
+    s[i].bytes = p->bytes_per_cube_cnt;
+  }
+  qsort(s, l->cnt, sizeof(struct bcm_sort_struct), bcp_bcm_sort_compare);
+  for( i = 0; i < l->cnt; i++ )
+  {
+    memcpy(list + i*p->blk_cnt, s[i].cube, p->bytes_per_cube_cnt);
+    h = bcp_mix64(h ^ s[i].hash) + (uint64_t)i;
+  }
+  free(s);
+  *hash = h;
+  return list;
+}
+
+/*
+  lookup "l" in the cache of the context. If "l" is not found, then the result is calculated
+  with bcp_IsBCLTautologyRecursion() and stored in the cache.
+  All cubes of "l" must be valid (which is the case for bcp_IsBCLTautologySub())
+*/
+int bcp_IsBCLTautologyWithCache(bcp p, bcl l, bct t, int depth, int is_2nd)
+{
+  bcm m = p->tautology_cache;
+  struct bcm_entry_struct *e;
+  uint64_t hash;
+  size_t size = (size_t)l->cnt*p->bytes_per_cube_cnt;
+  int result;
+  __m128i *list;
+
+  assert( m != NULL );
+  list = bcp_NewCanonicalCubeList(p, l, &hash);
+  if ( list == NULL )
+    return bcp_IsBCLTautologyRecursion(p, l, t, depth, is_2nd);   // no memory for the cache, continue without it
+
+  e = m->slot + (hash & (m->slot_cnt-1));
+  if ( e->cnt == l->cnt && e->hash == hash )
+  {
+    if ( memcmp(e->list, list, size) == 0 )
+    {
+      m->hit_cnt++;
+      free(list);
+      return e->result;
+    }
+    m->collision_cnt++;
+  }
+  m->miss_cnt++;
+
+  result = bcp_IsBCLTautologyRecursion(p, l, t, depth, is_2nd);
+
+  /* a canceled sub problem of the multi threaded check has an undefined result */
+  if ( bcp_IsTautologyCancel(p) )
+    return free(list), result;
+  
+  /* the sub problems might have used the same slot */
+  if ( size > m->mem_budget )
+    return free(list), result;
+  if ( e->list != NULL )
+  {
+    m->mem_used -= (size_t)e->cnt*p->bytes_per_cube_cnt;
+    free(e->list);
+    e->list = NULL;
+    e->cnt = 0;
+  }
+  if ( m->mem_used + size > m->mem_budget )
+  {
+    bcp_ClearTautologyCache(p);
+    m->flush_cnt++;
+  }
+  e->hash = hash;
+  e->cnt = l->cnt;
+  e->result = result;
+  e->list = list;
+  m->mem_used += size;
+  return result;
+}
@@ -0,0 +1,490 @@
+/*
+
+  bcltautologymt.c
+
+  boolean cube list: multi threaded tautology check
+
+  The recursion of bcp_IsBCLTautologySub() is distributed to a pool of worker threads.
+  Each worker has its own context (bcp_NewContext()) and the context points to the worker
+  (p->tautology_worker), so that the serial recursion in bcltautology.c is used by all workers:
+  leaf checks, tautology cache and the k-way partitions are the same as for the serial check.
+  Only the binate split of larger lists is done by bcp_IsBCLTautologyCofactorMT():
+  The worker always continues with the first cofactor and pushes the second cofactor to
+  the end of its own deque. Idle workers steal tasks from the beginning of the deque of other
+  workers (these are the largest sub problems).
+
+  A stolen task contains its own list and binate split table, so no list is used by two workers
+  at the same time.
+
+  A sub problem is tautology only if both cofactors are tautology. Once a cofactor is not a tautology,
+  the cancel flag of the current scope is set and all other tasks of the same scope will return early.
+  Independent partitions start a new scope for each partition (bcp_StartTautologyScope()),
+  because a partition which is not tautology must not cancel the other partitions.
+  A result, which was calculated inside a canceled scope, must not be stored in the tautology cache.
+
+  Workers without a task (and owners, which wait for a stolen task) will spin for a short time
+  and are then parked on the condition variable of the pool. They are woken up if a new task
+  is pushed, a stolen task is done or the pool is finished.
+
+*/
+
+#include "bc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* lists with less cubes are not distributed to other workers, instead the serial algorithm is used */
+#ifndef BCP_TAUT_MT_MIN_CNT
+#define BCP_TAUT_MT_MIN_CNT 16
+#endif
+
+/* max number of tasks in the deque of one worker, if the deque is full, the task is executed directly */
+#define BCP_TAUT_MT_DEQUE_SIZE 1024
+
+#define BCP_TAUT_MT_MAX_THREADS 256
+
+/* number of unsuccessful attempts to find a task before the worker is parked */
+#define BCP_TAUT_MT_SPIN_CNT 64
+
+typedef struct bcp_taut_scope_struct *bcp_taut_scope;
+typedef struct bcp_taut_task_struct *bcp_taut_task;
+typedef struct bcp_taut_worker_struct *bcp_taut_worker;
+typedef struct bcp_taut_pool_struct *bcp_taut_pool;
+
+struct bcp_taut_task_struct
+{
+  bcl l;                        // sub problem, owned by the task
+  bct t;                        // binate split table of "l", owned by the task
+  int depth;
+  bcp_taut_scope scope;
+  int result;
+  int is_done;                  // set to 1 (with release semantics) after "result" is available
+};
+
+struct bcp_taut_worker_struct
+{
+  bcp p;                        // private context of this worker, p->tautology_worker points back to this worker
+  bcp_taut_pool pool;
+  bcp_taut_scope scope;         // current scope of the worker
+  int idx;
+  pthread_t thread;
+  pthread_mutex_t mutex;        // protects the deque
+  int base;                     // first task in the deque, this is the position where other workers steal the task
+  int top;                      // one after the last task in the deque, push and pop by the owner happens here
+  bcp_taut_task deque[BCP_TAUT_MT_DEQUE_SIZE];
+};
+
+struct bcp_taut_pool_struct
+{
+  int worker_cnt;
+  int is_finished;              // set to 1 if all worker threads should terminate
+  int task_cnt;                 // number of tasks in all deques
+  int sleep_cnt;                // number of parked workers
+  pthread_mutex_t mutex;        // protects the condition variable
+  pthread_cond_t cond;          // parked workers wait here
+  bcp_taut_worker worker[BCP_TAUT_MT_MAX_THREADS];
+};
+
+/*============================================================*/
+/* scope */
+
+static int bcp_IsTautScopeCancel(bcp_taut_scope scope)
+{
+  while( scope != NULL )
+  {
+    if ( __atomic_load_n(&(scope->is_cancel), __ATOMIC_RELAXED) != 0 )
+      return 1;
+    scope = scope->parent;
+  }
+  return 0;
+}
+
+static void bcp_SetTautScopeCancel(bcp_taut_scope scope)
+{
+  __atomic_store_n(&(scope->is_cancel), 1, __ATOMIC_RELAXED);
+}
+
+/* returns 1 if the current scope of the worker of "p" has been canceled, always 0 for the serial check */
+int bcp_IsTautologyCancel(bcp p)
+{
+  if ( p->tautology_worker == NULL )
+    return 0;
+  return bcp_IsTautScopeCancel(p->tautology_worker->scope);
+}
+
+/* start a new scope for an independent partition, does nothing for the serial check */
+void bcp_StartTautologyScope(bcp p, struct bcp_taut_scope_struct *scope)
+{
+  if ( p->tautology_worker == NULL )
+    return;
+  scope->is_cancel = 0;
+  scope->parent = p->tautology_worker->scope;
+  p->tautology_worker->scope = scope;
+}
+
+/* end the scope, which was started by bcp_StartTautologyScope(), returns 0 if the scope was canceled, otherwise "result" */
+int bcp_EndTautologyScope(bcp p, struct bcp_taut_scope_struct *scope, int result)
+{
+  if ( p->tautology_worker == NULL )
+    return result;
+  assert( p->tautology_worker->scope == scope );
+  p->tautology_worker->scope = scope->parent;
+  if ( __atomic_load_n(&(scope->is_cancel), __ATOMIC_RELAXED) != 0 )
+    return 0;
+  return result;
+}
+
+/*============================================================*/
+/* pool */
+
+/* wake up all parked workers, if there are any */
+static void bcp_WakeTautPool(bcp_taut_pool pool)
+{
+  if ( __atomic_load_n(&(pool->sleep_cnt), __ATOMIC_SEQ_CST) > 0 )
+  {
+    pthread_mutex_lock(&(pool->mutex));
+    pthread_cond_broadcast(&(pool->cond));
+    pthread_mutex_unlock(&(pool->mutex));
+  }
+}
+
+static int bcp_GetTautDequeCnt(bcp_taut_worker w)
+{
+  int cnt;
+  pthread_mutex_lock(&(w->mutex));
+  cnt = w->top - w->base;
+  pthread_mutex_unlock(&(w->mutex));
+  return cnt;
+}
+
+/*
+  park the worker until another worker has a task, "task" is done (if not NULL) or the pool is finished
+  The counters are accessed with sequential consistency: Either the worker will see the new task (or the done flag)
+  or the other worker will see the incremented sleep_cnt and wake up the worker.
+*/
+static void bcp_ParkTautWorker(bcp_taut_worker w, bcp_taut_task task)
+{
+  bcp_taut_pool pool = w->pool;
+  pthread_mutex_lock(&(pool->mutex));
+  __atomic_add_fetch(&(pool->sleep_cnt), 1, __ATOMIC_SEQ_CST);
+  /* tasks in the own deque can not be stolen by this worker, so they are not counted */
+  while( __atomic_load_n(&(pool->task_cnt), __ATOMIC_SEQ_CST) <= bcp_GetTautDequeCnt(w)
+    && __atomic_load_n(&(pool->is_finished), __ATOMIC_SEQ_CST) == 0
+    && (task == NULL || __atomic_load_n(&(task->is_done), __ATOMIC_SEQ_CST) == 0) )
+    pthread_cond_wait(&(pool->cond), &(pool->mutex));
+  __atomic_sub_fetch(&(pool->sleep_cnt), 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&(pool->mutex));
+}
+
+/*============================================================*/
+/* deque */
+
+/* returns 0 if the deque is full */
+static int bcp_PushTautTask(bcp_taut_worker w, bcp_taut_task task)
+{
+  int is_pushed = 0;
+  pthread_mutex_lock(&(w->mutex));
+  if ( w->top == w->base )
+  {
+    w->top = 0;
+    w->base = 0;
+  }
+  if ( w->top < BCP_TAUT_MT_DEQUE_SIZE )
+  {
+    w->deque[w->top++] = task;
+    is_pushed = 1;
+  }
+  pthread_mutex_unlock(&(w->mutex));
+  if ( is_pushed )
+  {
+    __atomic_add_fetch(&(w->pool->task_cnt), 1, __ATOMIC_SEQ_CST);
+    bcp_WakeTautPool(w->pool);
+  }
+  return is_pushed;
+}
+
+/* remove "task" from the end of the deque of the owner, returns 0 if the task has been stolen by another worker */
+static int bcp_PopTautTask(bcp_taut_worker w, bcp_taut_task task)
+{
+  int is_poped = 0;
+  pthread_mutex_lock(&(w->mutex));
+  if ( w->top > w->base && w->deque[w->top-1] == task )
+  {
+    w->top--;
+    is_poped = 1;
+  }
+  pthread_mutex_unlock(&(w->mutex));
+  if ( is_poped )
+    __atomic_sub_fetch(&(w->pool->task_cnt), 1, __ATOMIC_SEQ_CST);
+  return is_poped;
+}
+
+/* remove a task from the beginning of the deque of "victim", returns NULL if the deque is empty */
+static bcp_taut_task bcp_StealTautTask(bcp_taut_worker victim)
+{
+  bcp_taut_task task = NULL;
+  pthread_mutex_lock(&(victim->mutex));
+  if ( victim->top > victim->base )
+    task = victim->deque[victim->base++];
+  pthread_mutex_unlock(&(victim->mutex));
+  if ( task != NULL )
+    __atomic_sub_fetch(&(victim->pool->task_cnt), 1, __ATOMIC_SEQ_CST);
+  return task;
+}
+
+static void bcp_DeleteTautTask(bcp p, bcp_taut_task task)
+{
+  bcp_DeleteBCT(p, task->t);
+  bcp_DeleteBCL(p, task->l);
+  free(task);
+}
+
+/* the task is executed inside the scope of the task, the owner of a stolen task is woken up */
+static void bcp_ExecuteTautTask(bcp_taut_worker w, bcp_taut_task task)
+{
+  int result = 0;
+  bcp_taut_scope scope = w->scope;
+  w->scope = task->scope;
+  if ( bcp_IsTautScopeCancel(task->scope) == 0 )
+    result = bcp_IsBCLTautologySub(w->p, task->l, task->t, task->depth, 1);
+  w->scope = scope;
+  task->result = result;
+  __atomic_store_n(&(task->is_done), 1, __ATOMIC_SEQ_CST);
+  bcp_WakeTautPool(w->pool);
+}
+
+/* try to steal and execute one task from any other worker, returns 0 if there was no task */
+static int bcp_HelpTautPool(bcp_taut_worker w)
+{
+  bcp_taut_pool pool = w->pool;
+  bcp_taut_task task;
+  int i;
+  for( i = 1; i < pool->worker_cnt; i++ )
+  {
+    task = bcp_StealTautTask(pool->worker[(w->idx + i) % pool->worker_cnt]);
+    if ( task != NULL )
+    {
+      bcp_ExecuteTautTask(w, task);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*
+  help the other workers until "task" is done (if not NULL) or the pool is finished
+  After BCP_TAUT_MT_SPIN_CNT unsuccessful attempts the worker is parked.
+*/
+static void bcp_WaitTautPool(bcp_taut_worker w, bcp_taut_task task)
+{
+  int spin_cnt = 0;
+  for(;;)
+  {
+    if ( __atomic_load_n(&(w->pool->is_finished), __ATOMIC_ACQUIRE) != 0 )
+      return;
+    if ( task != NULL && __atomic_load_n(&(task->is_done), __ATOMIC_ACQUIRE) != 0 )
+      return;
+    if ( bcp_HelpTautPool(w) != 0 )
+      spin_cnt = 0;
+    else if ( spin_cnt < BCP_TAUT_MT_SPIN_CNT )
+    {
+      spin_cnt++;
+      sched_yield();
+    }
+    else
+    {
+      bcp_ParkTautWorker(w, task);
+      spin_cnt = 0;
+    }
+  }
+}
+
+static void *bcp_TautWorkerThread(void *arg)
+{
+  bcp_WaitTautPool((bcp_taut_worker)arg, NULL);
+  return NULL;
+}
+
+/*============================================================*/
+/* tautology */
+
+/*
+  called by bcp_IsBCLTautologyRecursion() for the split at "var_pos":
+  the second cofactor is pushed to the deque of the worker, so that it can be stolen by other workers,
+  the first cofactor is checked by the worker itself.
+  "t" must be the binate split table of "l", "l" and "t" are not modified.
+  returns -1 if this is not a parallel check or if "l" is too small, the split has to be done by the caller
+  The result is undefined if the scope has been canceled.
+*/
+int bcp_IsBCLTautologyCofactorMT(bcp p, bcl l, bct t, int var_pos, int depth)
+{
+  bcp_taut_worker w = p->tautology_worker;
+  int result;
+  bcl f1;
+  bct t1;
+  bcp_taut_task task;
+
+  if ( w == NULL || l->cnt < BCP_TAUT_MT_MIN_CNT )
+    return -1;
+
+  /*
+    The list of the task might be allocated from the arena of "p", this is ok, because "p" will wait for the task
+    and the other worker will not add cubes to the list.
+  */
+  task = (bcp_taut_task)malloc(sizeof(struct bcp_taut_task_struct));
+  assert( task != NULL );
+  task->t = bcp_NewBCT(p);
+  assert( task->t != NULL );
+  task->l = bcp_NewBCLCofacterByVariableWithBCT(p, l, t, task->t, var_pos, 2);
+  assert( task->l != NULL );
+  task->depth = depth+1;
+  task->scope = w->scope;
+  task->result = 0;
+  task->is_done = 0;
+
+  if ( bcp_PushTautTask(w, task) == 0 )
+  {
+    bcp_ExecuteTautTask(w, task);         // deque is full
+  }
+
+  t1 = bcp_NewBCT(p);
+  assert( t1 != NULL );
+  bcp_StartBCLArenaFrame(p);
+  f1 = bcp_NewBCLCofacterByVariableWithBCT(p, l, t, t1, var_pos, 1);
+  assert( f1 != NULL );
+  result = bcp_IsBCLTautologySub(p, f1, t1, depth+1, 0);
+  bcp_DeleteBCL(p, f1);
+  bcp_EndBCLArenaFrame(p);
+  bcp_DeleteBCT(p, t1);
+  if ( result == 0 )
+    bcp_SetTautScopeCancel(w->scope);     // stop all other tasks of this scope
+
+  if ( bcp_PopTautTask(w, task) != 0 )
+  {
+    /* task was not stolen */
+    if ( result != 0 )
+      bcp_ExecuteTautTask(w, task);
+  }
+  else
+  {
+    /* task was stolen, help the other workers until the task is done */
+    bcp_WaitTautPool(w, task);
+  }
+
+  if ( result != 0 )
+  {
+    result = task->result;
+    if ( result == 0 )
+      bcp_SetTautScopeCancel(w->scope);
+  }
+  bcp_DeleteTautTask(p, task);
+
+  return result;
+}
+
+/*
+  Same as bcp_IsBCLTautology(), but use "thread_cnt" threads (including the calling thread)
+  If "thread_cnt" is 1 or less, then bcp_IsBCLTautology() is called.
+  If the tautology cache is enabled for "p", then the other workers will also use a cache with the same settings.
+  Returns -1 for memory or thread creation error.
+*/
+int bcp_IsBCLTautologyParallel(bcp p, bcl l, int thread_cnt)
+{
+  struct bcp_taut_pool_struct pool;
+  struct bcp_taut_scope_struct scope = { 0, NULL };
+  bct t;
+  bcl n;
+  int i;
+  int result = -1;
+
+  if ( thread_cnt <= 1 || l->cnt < BCP_TAUT_MT_MIN_CNT )
+    return bcp_IsBCLTautology(p, l);
+  if ( thread_cnt > BCP_TAUT_MT_MAX_THREADS )
+    thread_cnt = BCP_TAUT_MT_MAX_THREADS;
+  assert( p->tautology_worker == NULL );        // nested parallel checks are not supported
+
+  /* same as bcp_IsBCLTautology(): work on a copy, so that "l" is not modified */
+  n = bcp_NewBCLByBCL(p, l);
+  if ( n == NULL )
+    return -1;
+  if ( bcp_IsPurgeUsefull(p, n) )
+    bcp_PurgeBCL(p, n);
+  t = bcp_NewBCT(p);
+  if ( t == NULL )
+    return bcp_DeleteBCL(p, n), -1;
+  bcp_CalcBCLBinateSplitVariableTable(p, t, n);
+
+  pool.worker_cnt = 0;
+  pool.is_finished = 0;
+  pool.task_cnt = 0;
+  pool.sleep_cnt = 0;
+  pthread_mutex_init(&(pool.mutex), NULL);
+  pthread_cond_init(&(pool.cond), NULL);
+  for( i = 0; i < thread_cnt; i++ )
+  {
+    bcp_taut_worker w = (bcp_taut_worker)malloc(sizeof(struct bcp_taut_worker_struct));
+    if ( w == NULL )
+      break;
+    w->p = i == 0 ? p : bcp_NewContext(p);    // the calling thread uses "p"
+    if ( w->p == NULL )
+    {
+      free(w);
+      break;
+    }
+    if ( i > 0 && p->tautology_cache != NULL )
+      if ( bcp_EnableTautologyCache(w->p, p->tautology_cache->mem_budget, p->tautology_cache->min_cnt) == 0 )
+      {
+        bcp_Delete(w->p);
+        free(w);
+        break;
+      }
+    w->p->tautology_worker = w;
+    w->pool = &pool;
+    w->scope = &scope;
+    w->idx = i;
+    w->base = 0;
+    w->top = 0;
+    pthread_mutex_init(&(w->mutex), NULL);
+    pool.worker[i] = w;
+    pool.worker_cnt++;
+  }
+
+  if ( pool.worker_cnt == thread_cnt )
+  {
+    for( i = 1; i < pool.worker_cnt; i++ )
+      if ( pthread_create(&(pool.worker[i]->thread), NULL, bcp_TautWorkerThread, pool.worker[i]) != 0 )
+        break;
+    if ( i == pool.worker_cnt )
+    {
+      bcp_StartStatOp(p, BCP_STAT_OP_TAUTOLOGY);
+      bcp_StartBCLArenaFrame(p);
+      result = bcp_IsBCLTautologySub(p, n, t, 0, 0);
+      bcp_EndBCLArenaFrame(p);
+      bcp_EndStatOp(p, BCP_STAT_OP_TAUTOLOGY);
+      if ( scope.is_cancel != 0 )
+        result = 0;
+    }
+    __atomic_store_n(&(pool.is_finished), 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&(pool.mutex));
+    pthread_cond_broadcast(&(pool.cond));
+    pthread_mutex_unlock(&(pool.mutex));
+    while( --i > 0 )
+      pthread_join(pool.worker[i]->thread, NULL);
+  }
+
+  for( i = 0; i < pool.worker_cnt; i++ )
+  {
+    pthread_mutex_destroy(&(pool.worker[i]->mutex));
+    pool.worker[i]->p->tautology_worker = NULL;
+    if ( i > 0 )
+      bcp_Delete(pool.worker[i]->p);
+    free(pool.worker[i]);
+  }
+  pthread_cond_destroy(&(pool.cond));
+  pthread_mutex_destroy(&(pool.mutex));
+  bcp_DeleteBCT(p, t);
+  bcp_DeleteBCL(p, n);
+  return result;
+}
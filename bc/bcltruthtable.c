@@ -0,0 +1,353 @@
+/*
+
+  bcltruthtable.c
+
+  boolean cube list: truth table for lists with only a few active variables
+
+  A variable is active, if at least one cube of the list has a literal for this variable.
+  With at most BCP_TRUTH_TABLE_MAX_VAR_CNT active variables, the list can be
+  converted into a truth table with 2^var_cnt bits, stored in uint64_t words:
+  bit m of the table is the value of the function for the assignment m, where the
+  active variable k (var_pos[k]) has the value (m>>k)&1.
+  The variables 0..5 select the bit inside a word, the other variables select the word.
+  For less than 6 variables the table is one word, which is repeated for the unused variables.
+
+  Tautology, containment and complement are then calculated with bitwise operations.
+  The complement is converted back into cubes with the irredundant sum of products
+  algorithm from Minato and Morreale ("ISOP").
+
+*/
+
+#include "bc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/* truth table of the variables 0..5 inside one word */
+static const uint64_t bc_tt_var[6] =
+{
+  0xaaaaaaaaaaaaaaaaULL, 0xccccccccccccccccULL, 0xf0f0f0f0f0f0f0f0ULL,
+  0xff00ff00ff00ff00ULL, 0xffff0000ffff0000ULL, 0xffffffff00000000ULL
+};
+
+int bcp_GetTruthTableWordCnt(int var_cnt)
+{
+  if ( var_cnt <= 6 )
+    return 1;
+  return 1 << (var_cnt-6);
+}
+
+/*
+  "c" is the AND of all cubes of a list (don't care 11 for variables, which are not used by any cube)
+  write the position of the active variables to "var_pos" and return the number of active variables.
+  If there are more than "max_cnt" active variables, then max_cnt+1 is returned and only
+  the first max_cnt entries of "var_pos" are valid.
+*/
+int bcp_GetCubeActiveVariables(bcp p, bc c, int *var_pos, int max_cnt)
+{
+  int i, b, cnt = 0;
+  uint64_t w, used;
+  for( i = 0; i < p->blk_cnt*2; i++ )
+  {
+    w = ((uint64_t *)c)[i];
+    used = ~(w & (w>>1)) & 0x5555555555555555ULL;       // bit 0 of each variable, which is not 11
+    while( used != 0 )
+    {
+      if ( cnt >= max_cnt )
+        return max_cnt+1;
+      b = __builtin_ctzll(used);
+      used &= used-1;
+      var_pos[cnt++] = i*32 + b/2;
+    }
+  }
+  return cnt;
+}
+
+/*
+  calculate the AND of all cubes of "l" and "m" and return the active variables, see bcp_GetCubeActiveVariables()
+  "m" can be NULL
+*/
+int bcp_GetBCLActiveVariables(bcp p, bcl l, bcl m, int *var_pos, int max_cnt)
+{
+  int i, j, cnt;
+  bc c;
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  bcp_CopyGlobalCube(p, c, 3);
+  for( i = 0; i < l->cnt; i++ )
+    for( j = 0; j < p->blk_cnt; j++ )
+      _mm_storeu_si128(c+j, _mm_and_si128(_mm_loadu_si128(c+j), _mm_loadu_si128(bcp_GetBCLCube(p, l, i)+j)));
+  if ( m != NULL )
+    for( i = 0; i < m->cnt; i++ )
+      for( j = 0; j < p->blk_cnt; j++ )
+        _mm_storeu_si128(c+j, _mm_and_si128(_mm_loadu_si128(c+j), _mm_loadu_si128(bcp_GetBCLCube(p, m, i)+j)));
+  cnt = bcp_GetCubeActiveVariables(p, c, var_pos, max_cnt);
+  bcp_EndCubeStackFrame(p);
+  return cnt;
+}
+
+/*
+  OR the minterms of cube "c" into the truth table "tt"
+  All literals of "c" must be part of "var_pos".
+*/
+static void bcp_OrCubeTruthTable(bcp p, bc c, const int *var_pos, int var_cnt, uint64_t *tt)
+{
+  int j;
+  uint64_t word_mask = ~(uint64_t)0;    // minterms inside one word
+  unsigned care = 0;                    // word index bits with a literal
+  unsigned value = 0;                   // required value of the word index bits
+  unsigned free_bits, w;
+
+  for( j = 0; j < var_cnt; j++ )
+  {
+    switch( bcp_GetCubeVar(p, c, var_pos[j]) )
+    {
+      case 0:
+        return;         // illegal cube, no minterm
+      case 1:
+        if ( j < 6 )
+          word_mask &= ~bc_tt_var[j];
+        else
+          care |= 1u << (j-6);
+        break;
+      case 2:
+        if ( j < 6 )
+          word_mask &= bc_tt_var[j];
+        else
+          care |= 1u << (j-6), value |= 1u << (j-6);
+        break;
+    }
+  }
+  if ( var_cnt <= 6 )
+  {
+    tt[0] |= word_mask;
+    return;
+  }
+  /* visit all words, which match "value" for the "care" bits */
+  free_bits = (bcp_GetTruthTableWordCnt(var_cnt)-1) & ~care;
+  w = 0;
+  do
+  {
+    tt[value | w] |= word_mask;
+    w = (w - free_bits) & free_bits;    // next subset of free_bits
+  } while( w != 0 );
+}
+
+/*
+  calculate the truth table of "l", "tt" must have bcp_GetTruthTableWordCnt(var_cnt) words
+  "var_pos" must contain all active variables of "l"
+*/
+void bcp_GetBCLTruthTable(bcp p, bcl l, const int *var_pos, int var_cnt, uint64_t *tt)
+{
+  int i;
+  memset(tt, 0, bcp_GetTruthTableWordCnt(var_cnt)*sizeof(uint64_t));
+  for( i = 0; i < l->cnt; i++ )
+    if ( l->flags[i] == 0 )
+      bcp_OrCubeTruthTable(p, bcp_GetBCLCube(p, l, i), var_pos, var_cnt, tt);
+}
+
+int bcp_IsTruthTableTautology(const uint64_t *tt, int var_cnt)
+{
+  int i, cnt = bcp_GetTruthTableWordCnt(var_cnt);
+  uint64_t r = ~(uint64_t)0;
+  for( i = 0; i < cnt; i++ )
+    r &= tt[i];
+  return r == ~(uint64_t)0;
+}
+
+/*=== irredundant sum of products ===*/
+
+/*
+  cover all minterms of "lower" with cubes, which do not exceed "upper" (lower <= upper)
+  The cubes are built in "c" (starting with don't care for the variables 0..n-1) and added to "r".
+  The function of the added cubes is returned in "result".
+  Single word version for n <= 6, returns 0 for memory error
+*/
+static int bcp_isop_word(bcp p, bcl r, bc c, const int *var_pos, int n, uint64_t lower, uint64_t upper, uint64_t *result)
+{
+  uint64_t v, l0, l1, u0, u1, r0, r1, rs;
+  int s;
+
+  if ( lower == 0 )
+    return *result = 0, 1;
+  if ( upper == ~(uint64_t)0 )
+  {
+    *result = ~(uint64_t)0;
+    return bcp_AddBCLCubeByCube(p, r, c) >= 0;
+  }
+  assert( n > 0 );
+  n--;
+  v = bc_tt_var[n];
+  s = 1 << n;
+  l0 = lower & ~v; l0 |= l0 << s;
+  l1 = lower & v; l1 |= l1 >> s;
+  u0 = upper & ~v; u0 |= u0 << s;
+  u1 = upper & v; u1 |= u1 >> s;
+  if ( l0 == l1 && u0 == u1 )
+    return bcp_isop_word(p, r, c, var_pos, n, lower, upper, result);      // variable n is not used
+
+  bcp_SetCubeVar(p, c, var_pos[n], 1);
+  if ( bcp_isop_word(p, r, c, var_pos, n, l0 & ~u1, u0, &r0) == 0 )
+    return 0;
+  bcp_SetCubeVar(p, c, var_pos[n], 2);
+  if ( bcp_isop_word(p, r, c, var_pos, n, l1 & ~u0, u1, &r1) == 0 )
+    return 0;
+  bcp_SetCubeVar(p, c, var_pos[n], 3);
+  if ( bcp_isop_word(p, r, c, var_pos, n, (l0 & ~r0) | (l1 & ~r1), u0 & u1, &rs) == 0 )
+    return 0;
+  *result = ((r0 | rs) & ~v) | ((r1 | rs) & v);
+  return 1;
+}
+
+/*
+  same as bcp_isop_word(), but for n > 6, "lower", "upper" and "result" have bcp_GetTruthTableWordCnt(n) words
+*/
+static int bcp_isop(bcp p, bcl r, bc c, const int *var_pos, int n, const uint64_t *lower, const uint64_t *upper, uint64_t *result)
+{
+  int i, half, is_ok = 0;
+  uint64_t *m;
+  uint64_t *l, *u, *r0, *r1, *rs;
+  uint64_t all = ~(uint64_t)0, any = 0;
+
+  if ( n <= 6 )
+    return bcp_isop_word(p, r, c, var_pos, n, lower[0], upper[0], result);
+
+  half = bcp_GetTruthTableWordCnt(n-1);
+  for( i = 0; i < 2*half; i++ )
+  {
+    any |= lower[i];
+    all &= upper[i];
+  }
+  if ( any == 0 )
+    return memset(result, 0, 2*half*sizeof(uint64_t)), 1;
+  if ( all == ~(uint64_t)0 )
+  {
+    memset(result, 0xff, 2*half*sizeof(uint64_t));
+    return bcp_AddBCLCubeByCube(p, r, c) >= 0;
+  }
+  if ( memcmp(lower, lower+half, half*sizeof(uint64_t)) == 0 && memcmp(upper, upper+half, half*sizeof(uint64_t)) == 0 )
+  {
+    /* variable n-1 is not used */
+    if ( bcp_isop(p, r, c, var_pos, n-1, lower, upper, result) == 0 )
+      return 0;
+    memcpy(result+half, result, half*sizeof(uint64_t));
+    return 1;
+  }
+
+  m = (uint64_t *)malloc(5*half*sizeof(uint64_t));
+  if ( m == NULL )
+    return 0;
+  l = m; u = m + half; r0 = m + 2*half; r1 = m + 3*half; rs = m + 4*half;
+
+  for( i = 0; i < half; i++ )
+    l[i] = lower[i] & ~upper[half+i];
+  bcp_SetCubeVar(p, c, var_pos[n-1], 1);
+  if ( bcp_isop(p, r, c, var_pos, n-1, l, upper, r0) != 0 )
+  {
+    for( i = 0; i < half; i++ )
+      l[i] = lower[half+i] & ~upper[i];
+    bcp_SetCubeVar(p, c, var_pos[n-1], 2);
+    if ( bcp_isop(p, r, c, var_pos, n-1, l, upper+half, r1) != 0 )
+    {
+      for( i = 0; i < half; i++ )
+      {
+        l[i] = (lower[i] & ~r0[i]) | (lower[half+i] & ~r1[i]);
+        u[i] = upper[i] & upper[half+i];
+      }
+      bcp_SetCubeVar(p, c, var_pos[n-1], 3);
+      if ( bcp_isop(p, r, c, var_pos, n-1, l, u, rs) != 0 )
+      {
+        for( i = 0; i < half; i++ )
+        {
+          result[i] = r0[i] | rs[i];
+          result[half+i] = r1[i] | rs[i];
+        }
+        is_ok = 1;
+      }
+    }
+  }
+  bcp_SetCubeVar(p, c, var_pos[n-1], 3);
+  free(m);
+  return is_ok;
+}
+
+/*
+  add an irredundant cover of the truth table "tt" to "r"
+  returns 0 for memory error
+*/
+int bcp_AddBCLCubesByTruthTable(bcp p, bcl r, const uint64_t *tt, const int *var_pos, int var_cnt)
+{
+  int is_ok;
+  bc c;
+  uint64_t *result = (uint64_t *)malloc(bcp_GetTruthTableWordCnt(var_cnt)*sizeof(uint64_t));
+  if ( result == NULL )
+    return 0;
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  bcp_CopyGlobalCube(p, c, 3);
+  is_ok = bcp_isop(p, r, c, var_pos, var_cnt, tt, tt, result);
+  bcp_EndCubeStackFrame(p);
+  free(result);
+  return is_ok;
+}
+
+/*=== operations ===*/
+
+/*
+  calculate the complement of "l" with a truth table, "l" is not modified
+  returns NULL, if "l" has more than BCP_TRUTH_TABLE_MAX_VAR_CNT active variables or for memory error
+*/
+bcl bcp_NewBCLComplementWithTruthTable(bcp p, bcl l)
+{
+  int var_pos[BCP_TRUTH_TABLE_MAX_VAR_CNT];
+  int var_cnt = bcp_GetBCLActiveVariables(p, l, NULL, var_pos, BCP_TRUTH_TABLE_MAX_VAR_CNT);
+  int i, word_cnt;
+  uint64_t *tt;
+  bcl r;
+
+  if ( var_cnt > BCP_TRUTH_TABLE_MAX_VAR_CNT )
+    return NULL;
+  word_cnt = bcp_GetTruthTableWordCnt(var_cnt);
+  tt = (uint64_t *)malloc(word_cnt*sizeof(uint64_t));
+  if ( tt == NULL )
+    return NULL;
+  r = bcp_NewBCL(p);
+  if ( r == NULL )
+    return free(tt), NULL;
+  bcp_GetBCLTruthTable(p, l, var_pos, var_cnt, tt);
+  for( i = 0; i < word_cnt; i++ )
+    tt[i] = ~tt[i];
+  if ( bcp_AddBCLCubesByTruthTable(p, r, tt, var_pos, var_cnt) == 0 )
+    return free(tt), bcp_DeleteBCL(p, r), NULL;
+  free(tt);
+  return r;
+}
+
+/*
+  test, whether "b" is a subset of "a" with a truth table
+  returns:
+    1: yes, "b" is a subset of "a"
+    0: no, "b" is not a subset of "a"
+    -1: more than BCP_TRUTH_TABLE_MAX_VAR_CNT active variables or memory error
+*/
+int bcp_IsBCLSubsetWithTruthTable(bcp p, bcl a, bcl b)
+{
+  int var_pos[BCP_TRUTH_TABLE_MAX_VAR_CNT];
+  int var_cnt = bcp_GetBCLActiveVariables(p, a, b, var_pos, BCP_TRUTH_TABLE_MAX_VAR_CNT);
+  int i, word_cnt, result = 1;
+  uint64_t *tt;
+
+  if ( var_cnt > BCP_TRUTH_TABLE_MAX_VAR_CNT )
+    return -1;
+  word_cnt = bcp_GetTruthTableWordCnt(var_cnt);
+  tt = (uint64_t *)malloc(2*word_cnt*sizeof(uint64_t));
+  if ( tt == NULL )
+    return -1;
+  bcp_GetBCLTruthTable(p, a, var_pos, var_cnt, tt);
+  bcp_GetBCLTruthTable(p, b, var_pos, var_cnt, tt+word_cnt);
+  for( i = 0; i < word_cnt; i++ )
+    if ( (tt[word_cnt+i] & ~tt[i]) != 0 )
+      result = 0;
+  free(tt);
+  return result;
+}
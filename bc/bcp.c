@@ -29,57 +29,97 @@ int bcp_GetVarCntFromString(const char *s)
   return cnt; // we should never reach this statement
 }
 
-static void bcp_var_cnt_clear(bcp p)
+static void bcp_context_clear(bcp p)
 {
-  bcp_DeleteBCL(p, p->global_cube_list);
-  p->global_cube_list = NULL;
+  bca b;
+  assert(p->arena_depth == 0);
+  bcp_DisableTautologyCache(p);
+  free(p->partition_var);
+  p->partition_var = NULL;
+  while( p->arena_first != NULL )
+  {
+    b = p->arena_first;
+    p->arena_first = b->next;
+    free(b);
+  }
+  p->arena_current = NULL;
   bcp_DeleteBCL(p, p->stack_cube_list);
   p->stack_cube_list = NULL;
   free(p->cube_to_str);
   p->cube_to_str = NULL;
 }
 
+static int bcp_context_init(bcp p)
+{
+  p->stack_depth = 0;
+  p->arena_first = NULL;
+  p->arena_current = NULL;
+  p->arena_depth = 0;
+  p->tautology_cache = NULL;
+  p->tautology_worker = NULL;
+  bcp_ClearStat(p);
+  p->partition_stamp = 0;
+  p->partition_var = (int *)calloc(3*p->var_cnt+1, sizeof(int));
+  if ( p->partition_var == NULL )
+    return 0;
+  p->cube_to_str = (char *)malloc(p->var_cnt+1); 
+  if ( p->cube_to_str != NULL )
+  {
+    p->stack_cube_list = bcp_NewBCL(p);
+    if ( p->stack_cube_list != NULL )
+      return 1;
+    free(p->cube_to_str);
+    p->cube_to_str = NULL;
+  }
+  free(p->partition_var);
+  p->partition_var = NULL;
+  return 0;
+}
+
+static void bcp_var_cnt_clear(bcp p)
+{
+  bcp_DeleteBCL(p, p->global_cube_list);
+  p->global_cube_list = NULL;
+  bcp_context_clear(p);
+}
+
 
 static int bcp_var_cnt_init(bcp p, size_t var_cnt)
 {
+  int simd_blk_cnt;
   p->var_cnt = var_cnt;
   p->vars_per_blk_cnt = sizeof(__m128i)*4;
   p->blk_cnt = (var_cnt + p->vars_per_blk_cnt-1)/p->vars_per_blk_cnt;
+  /* select the SIMD kernels and extend blk_cnt so that the wide registers can be used without remainder loop */
+  p->simd_level = bcp_GetSIMDLevel(p->blk_cnt);
+  simd_blk_cnt = bcp_GetSIMDBlkCnt(p->simd_level);
+  p->blk_cnt = (p->blk_cnt + simd_blk_cnt-1)/simd_blk_cnt*simd_blk_cnt;
+  bcp_SetCubeFunctions(p);
   p->bytes_per_cube_cnt = p->blk_cnt*sizeof(__m128i);
   //printf("p->bytes_per_cube_cnt=%d\n", p->bytes_per_cube_cnt);
-  p->stack_depth = 0;
-  p->cube_to_str = (char *)malloc(p->var_cnt+1); 
-  if ( p->cube_to_str != NULL )
+  if ( bcp_context_init(p) != 0 )
   {
-    p->stack_cube_list = bcp_NewBCL(p);
-    if ( p->stack_cube_list != NULL )
+    p->global_cube_list = bcp_NewBCL(p);
+    if ( p->global_cube_list != NULL )
     {
-      p->global_cube_list = bcp_NewBCL(p);
-      if ( p->global_cube_list != NULL )
+      int i;
+                  /*
+                          0..3:	constant cubes for all illegal, all zero, all one and all don't care
+                          the counters for the binate split are stored in a bct
+                  */
+      for( i = 0; i < 4; i++ )
+        bcp_AddBCLCube(p, p->global_cube_list);
+      if ( p->global_cube_list->cnt >= 4 )
       {
-        int i;
-                    /*
-                            0..3:	constant cubes for all illegal, all zero, all one and all don't care
-                            4..7:	uint8_t counters for zeros in a list
-                            8..11:	uint8_t counters for ones in a list
-                            4..11: uint16_t counters
-                            12..19: uint16_t counters
-                    */
-        for( i = 0; i < 4+8+8; i++ )
-          bcp_AddBCLCube(p, p->global_cube_list);
-        if ( p->global_cube_list->cnt >= 4 )
-        {
-          memset(bcp_GetBCLCube(p, p->global_cube_list, 0), 0, p->bytes_per_cube_cnt);  // all vars are illegal
-          memset(bcp_GetBCLCube(p, p->global_cube_list, 1), 0x55, p->bytes_per_cube_cnt);  // all vars are zero
-          memset(bcp_GetBCLCube(p, p->global_cube_list, 2), 0xaa, p->bytes_per_cube_cnt);  // all vars are one
-          memset(bcp_GetBCLCube(p, p->global_cube_list, 3), 0xff, p->bytes_per_cube_cnt);  // all vars are don't care
-          return 1;
-        }
-        bcp_DeleteBCL(p, p->global_cube_list);
+        memset(bcp_GetBCLCube(p, p->global_cube_list, 0), 0, p->bytes_per_cube_cnt);  // all vars are illegal
+        memset(bcp_GetBCLCube(p, p->global_cube_list, 1), 0x55, p->bytes_per_cube_cnt);  // all vars are zero
+        memset(bcp_GetBCLCube(p, p->global_cube_list, 2), 0xaa, p->bytes_per_cube_cnt);  // all vars are one
+        memset(bcp_GetBCLCube(p, p->global_cube_list, 3), 0xff, p->bytes_per_cube_cnt);  // all vars are don't care
+        return 1;
       }
-      bcp_DeleteBCL(p, p->stack_cube_list);
+      bcp_DeleteBCL(p, p->global_cube_list);
     }
-    free(p->cube_to_str);
+    bcp_context_clear(p);
   }
   return 0;
 }
@@ -90,6 +130,7 @@ bcp bcp_New(size_t var_cnt)
   bcp p = (bcp)malloc(sizeof(struct bcp_struct));
   if ( p != NULL )
   {
+      p->master = NULL;
       p->var_map = NULL;
       p->var_list = NULL;
 
@@ -109,6 +150,34 @@ bcp bcp_New(size_t var_cnt)
   return NULL;
 }
 
+/*
+  Create a new execution context for the problem of "p".
+  The context shares the problem data (constant cubes, variable names) with "p", but has its own
+  temp cube stack and string buffer, so that the context can be used in another thread.
+  Lists created with any context of the same problem can be used with all other contexts.
+  The problem must not be changed (bcp_Parse(), bcp_UpdateFromBCX()) as long as contexts exist 
+  and all contexts must be deleted with bcp_Delete() before the problem is deleted.
+*/
+bcp bcp_NewContext(bcp p)
+{
+  bcp c;
+  if ( p->master != NULL )
+    p = p->master;
+  if ( p->var_list == NULL )
+    if ( bcp_BuildVarList(p) == 0 )     // build the var list now, it is created by bcp_GetExpressionBCL() otherwise
+      return NULL;
+  c = (bcp)malloc(sizeof(struct bcp_struct));
+  if ( c != NULL )
+  {
+    *c = *p;            // copy problem data and the pointers to the shared objects
+    c->master = p;
+    if ( bcp_context_init(c) != 0 )
+      return c;
+    free(c);
+  }
+  return NULL;
+}
+
 /*      
   Update p->var_cnt from p->x_var_cnt after expression analysis
   Idea is this:
@@ -119,6 +188,7 @@ bcp bcp_New(size_t var_cnt)
 int bcp_UpdateFromBCX(bcp p)
 {
   assert( p->var_cnt <= 1 );
+  assert( p->master == NULL );
   bcp_var_cnt_clear(p);
   if ( bcp_var_cnt_init(p, p->x_var_cnt) != 0 )
   {
@@ -131,6 +201,13 @@ void bcp_Delete(bcp p)
 {
   if ( p == NULL )
     return ;
+  if ( p->master != NULL )
+  {
+    bcp_AddStatByContext(p->master, p);
+    bcp_context_clear(p);       // the problem data belongs to the master
+    free(p);
+    return;
+  }
   bcp_var_cnt_clear(p);
   
   if ( p->var_list != NULL )
@@ -180,7 +257,7 @@ void bcp_EndCubeStackFrame(bcp p)
 }
 
 /* Return a temporary cube, which will deleted with bcp_EndCubeStackFrame(). Requires a call to bcp_StartCubeStackFrame(). */
-/* this is NOT MT-SAFE, each thread requires its own bcp structure */
+/* this is NOT MT-SAFE, each thread requires its own context, see bcp_NewContext() */
 bc bcp_GetTempCube(bcp p)
 {
   int i;
@@ -194,4 +271,107 @@ bc bcp_GetTempCube(bcp p)
   return bcp_GetBCLCube(p, p->stack_cube_list, i);
 }
 
+/*============================================================*/
+/* bcl arena */
+
+/*
+  The recursive algorithms create and delete many private lists (cofactors, partitions).
+  Inside a bcl arena frame, bcp_NewBCL() and the functions based on it will take the memory
+  for the struct, the cubes and the flags from the arena of the context. All this memory is released 
+  at once with bcp_EndBCLArenaFrame(). 
+  bcp_DeleteBCL() must still be called for those lists (the bit sliced view is not part of the arena),
+  but a list created inside a frame must not be used after the frame has been closed and
+  cubes must not be added to a list while another frame has been started (the new memory would
+  belong to the inner frame, this is checked by an assert in bcp_ResizeBCL()).
+  The recursive complement is also used inside a frame by bcp_DoBCLReduce(), see bcp_NewBCLComplement().
+  Like bcp_GetTempCube() this is NOT MT-SAFE, each thread requires its own context.
+*/
+void bcp_StartBCLArenaFrame(bcp p)
+{
+  if ( p->arena_depth >= BCP_MAX_ARENA_FRAME_DEPTH )
+  {
+    assert(p->arena_depth < BCP_MAX_ARENA_FRAME_DEPTH);  // output error message
+    exit(1); // just ensure, that we do exit, also incases if NDEBUG is active
+  }
+  p->arena_frame_block[p->arena_depth] = p->arena_current;
+  p->arena_frame_pos[p->arena_depth] = p->arena_current == NULL ? 0 : p->arena_current->pos;
+  p->arena_depth++;
+}
+
+void bcp_EndBCLArenaFrame(bcp p)
+{
+  assert(p->arena_depth > 0);
+  p->arena_depth--;
+  p->arena_current = p->arena_frame_block[p->arena_depth];
+  if ( p->arena_current == NULL )
+    p->arena_current = p->arena_first;  // nothing had been allocated at the time the frame was started
+  if ( p->arena_current != NULL )
+    p->arena_current->pos = p->arena_frame_pos[p->arena_depth];
+}
 
+/*
+  Return memory with "size" bytes from the current arena frame.
+  If "ptr" is not NULL, then "ptr" must be a previous result of this function with "old_size" bytes.
+  The memory of "ptr" is extended in place if "ptr" is the last allocation, otherwise the content of 
+  "ptr" is copied to the new memory (the old memory is released with the frame).
+  Sizes are rounded up to a multiple of 64 bytes, so each result starts at a multiple of 64 bytes 
+  from the start of the block "data". "data" itself is only aligned to 16 bytes (sizeof(__m128i), 
+  malloc() and the offset of "data" in struct bca_struct), so the result is 16 byte aligned, but 
+  not necessarily 64 byte aligned. This is enough for the AVX2/AVX-512 kernels in bcube.c, which use 
+  unaligned loads and stores and only require, that a cube consists of complete 32/64 byte blocks.
+  Returns NULL for memory error.
+*/
+void *bcp_ResizeBCLArenaMemory(bcp p, void *ptr, size_t old_size, size_t size)
+{
+  bca b = p->arena_current;
+  void *m;
+  
+  assert(p->arena_depth > 0);
+  size = (size + 63) & ~(size_t)63;
+  old_size = (old_size + 63) & ~(size_t)63;
+  
+  if ( ptr != NULL && b != NULL && (uint8_t *)ptr + old_size == (uint8_t *)b->data + b->pos )
+  {
+    if ( (uint8_t *)ptr + size <= (uint8_t *)b->data + b->size )
+    {
+      b->pos = (uint8_t *)ptr + size - (uint8_t *)b->data;
+      return ptr;
+    }
+  }
+  
+  if ( b == NULL || b->pos + size > b->size )
+  {
+    /* use the next block, if it is large enough, otherwise insert a new block */
+    if ( b != NULL && b->next != NULL && b->next->size >= size )
+    {
+      b = b->next;
+    }
+    else
+    {
+      size_t block_size = size > BCA_BLOCK_SIZE ? size : BCA_BLOCK_SIZE;
+      bca n = (bca)malloc(sizeof(struct bca_struct) + block_size);
+      if ( n == NULL )
+        return NULL;
+      n->size = block_size;
+      if ( b == NULL )
+      {
+        n->next = p->arena_first;
+        p->arena_first = n;
+      }
+      else
+      {
+        n->next = b->next;
+        b->next = n;
+      }
+      b = n;
+    }
+    b->pos = 0;
+    p->arena_current = b;
+  }
+  
+  m = (uint8_t *)b->data + b->pos;
+  b->pos += size;
+  if ( ptr != NULL )
+    memcpy(m, ptr, old_size < size ? old_size : size);
+  return m;
+}
@@ -8,8 +8,12 @@
 
 #include "bc.h"
 #include <assert.h>
+#include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 
 
 
@@ -182,6 +186,1141 @@ void internalTest(int var_cnt)
 
 }
 
+/*============================================================*/
+
+/* assign random values to the cube, "dc_ratio" is the probability in percent for a don't care value */
+static void bcp_SetRandomCube(bcp p, bc c, int dc_ratio)
+{
+  int i;
+  bcp_ClrCube(p, c);
+  for( i = 0; i < p->var_cnt; i++ )
+    if ( rand() % 100 >= dc_ratio )
+      bcp_SetCubeVar(p, c, i, 1 + (rand() & 1));
+}
+
+/*
+  compare the cube kernels selected for "var_cnt" (AVX2/AVX-512 for larger var_cnt) 
+  against the SSE2 kernels
+*/
+void cubeKernelTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  struct bcp_struct sse2;     // same problem, but with the SSE2 kernels
+  bc a, b, r1, r2;
+  int i, x1, x2;
+  
+  printf("cube kernel test, var_cnt=%d simd_level=%d blk_cnt=%d\n", var_cnt, p->simd_level, p->blk_cnt);
+  sse2 = *p;
+  sse2.simd_level = BCP_SIMD_SSE2;
+  bcp_SetCubeFunctions(&sse2);
+  
+  bcp_StartCubeStackFrame(p);
+  a = bcp_GetTempCube(p);
+  b = bcp_GetTempCube(p);
+  r1 = bcp_GetTempCube(p);
+  r2 = bcp_GetTempCube(p);
+  for( i = 0; i < 2000; i++ )
+  {
+    bcp_SetRandomCube(p, a, 90 + i % 10);
+    bcp_SetRandomCube(p, b, 90 + (i/10) % 10);
+    if ( i % 3 == 0 )
+      bcp_CopyCube(p, a, b);            // subset case
+    if ( i % 7 == 0 )
+      bcp_SetCubeVar(p, a, rand() % var_cnt, 3);
+    x1 = bcp_IntersectionCube(p, r1, a, b);
+    x2 = bcp_IntersectionCube(&sse2, r2, a, b);
+    assert( x1 == x2 );
+    assert( bcp_CompareCube(p, r1, r2) == 0 );
+    assert( bcp_IsIntersectionCube(p, a, b) == bcp_IsIntersectionCube(&sse2, a, b) );
+    assert( bcp_IsSubsetCube(p, a, b) == bcp_IsSubsetCube(&sse2, a, b) );
+    assert( bcp_IsSubsetCube(p, b, a) == bcp_IsSubsetCube(&sse2, b, a) );
+    assert( bcp_GetCubeDelta(p, a, b) == bcp_GetCubeDelta(&sse2, a, b) );
+    x1 = bcp_OrBitCnt(p, r1, a, b);
+    x2 = bcp_OrBitCnt(&sse2, r2, a, b);
+    assert( x1 == x2 );
+    assert( bcp_CompareCube(p, r1, r2) == 0 );
+  }
+  bcp_EndCubeStackFrame(p);
+  bcp_Delete(p);
+}
+
+/* compare the bit sliced view against the single cube functions */
+void sliceTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bc c;
+  uint64_t *im, *sm;
+  int i, j, is_any_i, is_any_s, is_i, is_s;
+
+  printf("slice test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < 300; i++ )
+  {
+    j = bcp_AddBCLCube(p, l);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, j), 70 + i % 30);
+  }
+  for( i = 0; i < l->cnt; i += 5 )
+    l->flags[i] = 1;            // some deleted cubes
+  im = (uint64_t *)malloc(bcp_GetBCLSlice(p, l)->word_cnt*sizeof(uint64_t));
+  sm = (uint64_t *)malloc(bcp_GetBCLSlice(p, l)->word_cnt*sizeof(uint64_t));
+  assert( im != NULL && sm != NULL );
+
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  for( i = 0; i < 500; i++ )
+  {
+    bcp_SetRandomCube(p, c, 50 + i % 50);
+    if ( i % 4 == 0 )
+      bcp_CopyCube(p, c, bcp_GetBCLCube(p, l, i % l->cnt));
+    is_any_i = bcp_GetBCLSliceIntersectionMask(p, l, c, im);
+    is_any_s = bcp_GetBCLSliceSubsetMask(p, l, c, sm);
+    for( j = 0; j < l->cnt; j++ )
+    {
+      is_i = l->flags[j] == 0 && bcp_IsIntersectionCube(p, c, bcp_GetBCLCube(p, l, j));
+      is_s = l->flags[j] == 0 && bcp_IsSubsetCube(p, c, bcp_GetBCLCube(p, l, j));
+      assert( is_i == 0 || is_any_i != 0 );
+      assert( is_s == 0 || is_any_s != 0 );
+      if ( is_any_i )
+        assert( (int)((im[j/64] >> (j&63)) & 1) == is_i );
+      if ( is_any_s )
+        assert( (int)((sm[j/64] >> (j&63)) & 1) == is_s );
+    }
+  }
+
+  /* an in-place modification does not change the number of cubes, still the view must be recreated */
+  j = 1;
+  bcp_CopyCube(p, bcp_GetBCLCube(p, l, j), bcp_GetGlobalCube(p, 3));
+  bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, j), 0, 1);
+  bcp_InvalidateBCLSlice(p, l);
+  bcp_CopyCube(p, c, bcp_GetGlobalCube(p, 3));
+  bcp_SetCubeVar(p, c, 0, 2);
+  bcp_GetBCLSliceIntersectionMask(p, l, c, im);
+  assert( ((im[j/64] >> (j&63)) & 1) == 0 );
+  bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, j), 0, 2);
+  bcp_UpdateBCLSignature(p, l, j);
+  is_any_i = bcp_GetBCLSliceIntersectionMask(p, l, c, im);
+  assert( is_any_i != 0 );
+  assert( ((im[j/64] >> (j&63)) & 1) == 1 );
+
+  bcp_EndCubeStackFrame(p);
+  free(im);
+  free(sm);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* check the signatures of a list against the cubes */
+static void bcp_CheckBCLSignature(bcp p, bcl l)
+{
+  int i;
+  assert( l->is_sig != 0 );
+  for( i = 0; i < l->cnt; i++ )
+    assert( l->sig[i] == bcp_GetCubeSignature(p, bcp_GetBCLCube(p, l, i)) );
+}
+
+/* the signature tests must never contradict the cube kernels, the signatures must be kept by the list functions */
+void signatureTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl n;
+  bc a, b;
+  uint64_t *sig;
+  int i, j, pos, subset_cnt = 0, reject_cnt = 0;
+
+  printf("signature test, var_cnt=%d", var_cnt);
+  for( i = 0; i < 200; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 60 + i % 40);
+  }
+  sig = bcp_GetBCLSignature(p, l);
+  for( i = 0; i < l->cnt; i++ )
+  {
+    a = bcp_GetBCLCube(p, l, i);
+    for( j = 0; j < l->cnt; j++ )
+    {
+      b = bcp_GetBCLCube(p, l, j);
+      if ( bcp_IsSubsetCube(p, a, b) )
+      {
+        assert( bcp_IsSignatureSubsetPossible(sig[i], sig[j]) );
+        subset_cnt++;
+      }
+      if ( bcp_IsSignatureSubsetPossible(sig[i], sig[j]) == 0 )
+        reject_cnt++;
+      if ( bcp_IsSignatureIntersectionSure(sig[i], sig[j]) )
+      {
+        assert( bcp_IsIntersectionCube(p, a, b) );
+        assert( bcp_GetCubeDelta(p, a, b) == 0 );
+      }
+    }
+  }
+  printf(", subset pairs=%d, rejected pairs=%d of %d\n", subset_cnt, reject_cnt, l->cnt*l->cnt);
+  
+  /* maintained by add, purge, copy and cofactor */
+  for( i = 0; i < 50; i++ )
+  {
+    pos = bcp_AddBCLCubeByCube(p, l, bcp_GetBCLCube(p, l, i*3));
+    assert( pos >= 0 );
+  }
+  bcp_CheckBCLSignature(p, l);
+  for( i = 0; i < l->cnt; i += 3 )
+    l->flags[i] = 1;
+  bcp_PurgeBCL(p, l);
+  bcp_CheckBCLSignature(p, l);
+  n = bcp_NewBCLByBCL(p, l);
+  assert( n != NULL );
+  bcp_CheckBCLSignature(p, n);
+  bcp_DoBCLOneVariableCofactor(p, n, 1, 2);
+  bcp_CheckBCLSignature(p, n);
+  bcp_DeleteBCL(p, n);
+  
+  bcp_StartBCLArenaFrame(p);
+  n = bcp_NewBCLCofacterByVariable(p, l, 0, 1);
+  assert( n != NULL );
+  bcp_CheckBCLSignature(p, n);
+  for( i = 0; i < 100; i++ )
+  {
+    pos = bcp_AddBCLCubeByCube(p, n, bcp_GetBCLCube(p, l, i % l->cnt));    // grow the arena list
+    assert( pos >= 0 );
+  }
+  bcp_CheckBCLSignature(p, n);
+  bcp_DoBCLSingleCubeContainment(p, n);
+  bcp_CheckBCLSignature(p, n);
+  bcp_DeleteBCL(p, n);
+  bcp_EndBCLArenaFrame(p);
+  
+  bcp_InvalidateBCLSlice(p, l);
+  assert( l->is_sig == 0 );
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* check the single cube containment: the result must contain exactly the maximal cubes of the input */
+void sccTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl r;
+  bc c;
+  int i, j, k, pos, cnt;
+
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  for( cnt = 10; cnt <= 1000; cnt *= 10 )
+  {
+    bcp_ClearBCL(p, l);
+    for( i = 0; i < cnt; i++ )
+    {
+      pos = bcp_AddBCLCube(p, l);
+      bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 40 + i % 50);
+      if ( i % 3 == 0 )
+      {
+        /* add a subset of an existing cube and also a duplicate */
+        bcp_CopyCube(p, c, bcp_GetBCLCube(p, l, rand() % l->cnt));
+        bcp_SetCubeVar(p, c, rand() % var_cnt, 1 + (i & 1));
+        bcp_AddBCLCubeByCube(p, l, c);
+        bcp_CopyCube(p, c, bcp_GetBCLCube(p, l, rand() % l->cnt));
+        bcp_AddBCLCubeByCube(p, l, c);
+      }
+    }
+    r = bcp_NewBCLByBCL(p, l);
+    assert( r != NULL );
+    bcp_DoBCLSingleCubeContainment(p, r);
+    printf("scc test, cnt=%d, result cnt=%d\n", l->cnt, r->cnt);
+    /* no cube of the result is a subset of another cube of the result */
+    for( i = 0; i < r->cnt; i++ )
+      for( j = 0; j < r->cnt; j++ )
+        if ( i != j )
+          assert( bcp_IsSubsetCube(p, bcp_GetBCLCube(p, r, i), bcp_GetBCLCube(p, r, j)) == 0 );
+    /* each cube of the input is a subset of a cube in the result */
+    for( i = 0; i < l->cnt; i++ )
+    {
+      for( k = 0; k < r->cnt; k++ )
+        if ( bcp_IsSubsetCube(p, bcp_GetBCLCube(p, r, k), bcp_GetBCLCube(p, l, i)) )
+          break;
+      assert( k < r->cnt );
+    }
+    bcp_DeleteBCL(p, r);
+  }
+  bcp_EndCubeStackFrame(p);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* lists inside bcl arena frames: in place extension, block change and reuse of the memory */
+void arenaTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl h = bcp_NewBCL(p);        // heap list with the expected content
+  bcl a, b, c;
+  int i, pos;
+
+  printf("arena test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < 300; i++ )
+  {
+    pos = bcp_AddBCLCube(p, h);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, h, pos), 50);
+    h->flags[pos] = i & 1;
+  }
+  
+  bcp_StartBCLArenaFrame(p);
+  a = bcp_NewBCL(p);
+  assert( a->is_arena != 0 );
+  for( i = 0; i < h->cnt; i++ )
+  {
+    pos = bcp_AddBCLCubeByCube(p, a, bcp_GetBCLCube(p, h, i));
+    a->flags[pos] = h->flags[i];
+  }
+  
+  bcp_StartBCLArenaFrame(p);
+  b = bcp_NewBCLByBCL(p, a);
+  assert( b->is_arena != 0 );
+  for( i = 0; i < 20000; i++ )          // requires more than one arena block
+    bcp_AddBCLCubeByCube(p, b, bcp_GetBCLCube(p, a, i % a->cnt));
+  bcp_DeleteBCL(p, b);
+  bcp_EndBCLArenaFrame(p);
+  
+  bcp_StartBCLArenaFrame(p);
+  c = bcp_NewBCLByBCL(p, h);
+  assert( c == b );             // the memory of the closed frame is used again
+  bcp_DeleteBCL(p, c);
+  bcp_EndBCLArenaFrame(p);
+
+  /* the content of "a" is not modified by the inner frames */
+  assert( a->cnt == h->cnt );
+  for( i = 0; i < h->cnt; i++ )
+  {
+    assert( a->flags[i] == h->flags[i] );
+    assert( bcp_CompareCube(p, bcp_GetBCLCube(p, a, i), bcp_GetBCLCube(p, h, i)) == 0 );
+  }
+  bcp_PurgeBCL(p, a);
+  assert( a->cnt == h->cnt/2 );
+  bcp_DeleteBCL(p, a);
+  bcp_EndBCLArenaFrame(p);
+  
+  assert( p->arena_depth == 0 );
+  a = bcp_NewBCL(p);
+  assert( a->is_arena == 0 );            // outside of a frame lists are created with malloc
+  bcp_DeleteBCL(p, a);
+  bcp_DeleteBCL(p, h);
+  bcp_Delete(p);
+}
+
+/* capacity of lists: geometric growth, reserve and shrink */
+void reserveTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  int i, pos;
+  int realloc_cnt = 0;
+  int max = 0;
+  int is_ok;
+
+  printf("reserve test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < 10000; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), i % var_cnt, 1 + (i & 1));
+    if ( l->max != max )
+      realloc_cnt++, max = l->max;
+  }
+  assert( realloc_cnt < 30 );
+  
+  is_ok = bcp_ReserveBCL(p, l, 30000);
+  assert( is_ok != 0 );
+  assert( l->max >= 30000 && l->cnt == 10000 );
+  is_ok = bcp_ShrinkBCL(p, l);
+  assert( is_ok != 0 );
+  assert( l->max == l->cnt );
+  for( i = 0; i < l->cnt; i++ )
+    assert( bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, i), i % var_cnt) == 1 + (i & 1) );
+  
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* bcp_SwapBCL() and bcp_MoveBCL() for heap and arena lists */
+static void moveTestSub(bcp p, bcl a, bcl b)
+{
+  bcl ca = bcp_NewBCLByBCL(p, a);
+  bcl cb = bcp_NewBCLByBCL(p, b);
+  __m128i *list = a->list;
+  int result;
+  
+  result = bcp_SwapBCL(p, a, b);
+  assert( result != 0 );
+  assert( bcp_IsBCLEqual(p, a, cb) && bcp_IsBCLEqual(p, b, ca) );
+  if ( a->is_arena == 0 && b->is_arena == 0 )
+    assert( b->list == list );          // no copy
+  result = bcp_MoveBCL(p, a, b);
+  assert( result != 0 );
+  assert( bcp_IsBCLEqual(p, a, ca) && b->cnt == 0 );
+  result = bcp_AddBCLCubeByCube(p, b, bcp_GetGlobalCube(p, 3));
+  assert( result >= 0 );                // "b" is still usable
+  bcp_DeleteBCL(p, ca);
+  bcp_DeleteBCL(p, cb);
+}
+
+void moveTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl a = bcp_NewBCL(p);
+  bcl b = bcp_NewBCL(p);
+  bcl c;
+  int i, pos;
+
+  printf("move test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < 100; i++ )
+  {
+    pos = bcp_AddBCLCube(p, i < 60 ? a : b);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, i < 60 ? a : b, pos), 50);
+  }
+  moveTestSub(p, a, b);
+  
+  bcp_StartBCLArenaFrame(p);
+  c = bcp_NewBCLByBCL(p, b);
+  pos = bcp_AddBCLCubeByCube(p, c, bcp_GetGlobalCube(p, 1));
+  assert( pos >= 0 );
+  moveTestSub(p, a, c);
+  bcp_DeleteBCL(p, c);
+  bcp_EndBCLArenaFrame(p);
+
+  bcp_DeleteBCL(p, a);
+  bcp_DeleteBCL(p, b);
+  bcp_Delete(p);
+}
+
+/* check the complement with the unate recursive paradigm against the complement with subtract */
+void urpComplementTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl c, s;
+  int i, j, k, pos;
+  clock_t t0, t_urp, t_subtract;
+
+  for( i = 0; i < 3; i++ )
+  {
+    bcp_ClearBCL(p, l);
+    for( j = 0; j < 8 + i*2; j++ )
+    {
+      pos = bcp_AddBCLCube(p, l);
+      bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 75);
+    }
+    t0 = clock();
+    c = bcp_NewBCLComplementWithURP(p, l);
+    t_urp = clock() - t0;
+    t0 = clock();
+    s = bcp_NewBCLComplementWithSubtract(p, l);
+    t_subtract = clock() - t0;
+    assert( c != NULL && s != NULL );
+    printf("urp complement test, cnt=%d, urp cnt=%d clock=%ld, subtract cnt=%d clock=%ld\n", l->cnt, c->cnt, (long)t_urp, s->cnt, (long)t_subtract);
+    /* the complement must not intersect with "l" */
+    for( j = 0; j < c->cnt; j++ )
+      for( k = 0; k < l->cnt; k++ )
+        assert( bcp_IsIntersectionCube(p, bcp_GetBCLCube(p, c, j), bcp_GetBCLCube(p, l, k)) == 0 );
+    assert( bcp_IsBCLEqual(p, c, s) != 0 );
+    bcp_DeleteBCL(p, c);
+    bcp_DeleteBCL(p, s);
+  }
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* 
+  tautology check and multi cube containment with and without the tautology cache must return the same result 
+  a list with reversed cube order must be found in the cache
+*/
+void tautologyCacheTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl t, r, m1, m2;
+  int i, j, expected, is_ok;
+  long miss_cnt;
+
+  printf("tautology cache test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < 4; i++ )
+  {
+    t = bcp_NewBCLWithRandomTautology(p, var_cnt/2, 0);
+    assert( t != NULL );
+    r = bcp_NewBCL(p);                  // "t" in reverse order, but without the last cube of "t", so "r" is not a tautology
+    for( j = t->cnt-2; j >= 0; j-- )
+      bcp_AddBCLCubeByCube(p, r, bcp_GetBCLCube(p, t, j));
+    expected = bcp_IsBCLTautology(p, r);
+    assert( expected == 0 );
+
+    is_ok = bcp_EnableTautologyCache(p, 0, 8);
+    assert( is_ok != 0 );
+    assert( bcp_IsBCLTautology(p, t) != 0 );
+    assert( bcp_IsBCLTautology(p, r) == expected );
+    /* the complete list is either in the cache or decided by the fast leaf checks, so there is no cache miss */
+    miss_cnt = p->tautology_cache->miss_cnt;
+    assert( bcp_IsBCLTautology(p, r) == expected );     // same list again
+    assert( p->tautology_cache->miss_cnt == miss_cnt );
+    bcp_DeleteBCL(p, t);
+    t = bcp_NewBCL(p);                  // the cubes of "r" in a different order
+    for( j = r->cnt-1; j >= 0; j-- )
+      bcp_AddBCLCubeByCube(p, t, bcp_GetBCLCube(p, r, j));
+    miss_cnt = p->tautology_cache->miss_cnt;
+    assert( bcp_IsBCLTautology(p, t) == expected );
+    assert( p->tautology_cache->miss_cnt == miss_cnt );
+    
+    /* a small memory budget will flush the cache, but the result must be the same */
+    is_ok = bcp_EnableTautologyCache(p, 8*r->cnt*p->bytes_per_cube_cnt, 2);
+    assert( is_ok != 0 );
+    m1 = bcp_NewBCLByBCL(p, r);
+    bcp_DoBCLMultiCubeContainment(p, m1);
+    bcp_ShowTautologyCacheStatistics(p);
+    bcp_DisableTautologyCache(p);
+    m2 = bcp_NewBCLByBCL(p, r);
+    bcp_DoBCLMultiCubeContainment(p, m2);
+    assert( m1->cnt == m2->cnt );
+    assert( bcp_IsBCLEqual(p, m1, m2) != 0 );
+    
+    bcp_DeleteBCL(p, m1);
+    bcp_DeleteBCL(p, m2);
+    bcp_DeleteBCL(p, r);
+    bcp_DeleteBCL(p, t);
+  }
+  bcp_Delete(p);
+}
+
+/* compare the tautology check (including the fast leaf checks) against the evaluation of all minterms */
+void tautologyLeafTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l;
+  bc m;
+  int i, j, k, expected;
+  
+  assert( var_cnt <= 16 );
+  printf("tautology leaf test, var_cnt=%d\n", var_cnt);
+  bcp_StartCubeStackFrame(p);
+  m = bcp_GetTempCube(p);
+  for( i = 0; i < 200; i++ )
+  {
+    l = bcp_NewBCLWithRandomTautology(p, 4 + i % 40, i % 3);
+    expected = 1;
+    for( j = 0; j < (1<<var_cnt) && expected != 0; j++ )
+    {
+      for( k = 0; k < var_cnt; k++ )
+        bcp_SetCubeVar(p, m, k, ((j>>k)&1) + 1);
+      for( k = 0; k < l->cnt; k++ )
+        if ( bcp_IsSubsetCube(p, bcp_GetBCLCube(p, l, k), m) )
+          break;
+      if ( k == l->cnt )
+        expected = 0;
+    }
+    assert( bcp_IsBCLTautology(p, l) == expected );
+    bcp_DeleteBCL(p, l);
+  }
+  bcp_EndCubeStackFrame(p);
+  
+  /* the universal cube is found before the recursion starts */
+  l = bcp_NewBCLWithRandomTautology(p, 30, 2);
+  bcp_AddBCLCubeByCube(p, l, bcp_GetGlobalCube(p, 3));
+  assert( bcp_IsBCLTautology(p, l) != 0 );
+  bcp_DeleteBCL(p, l);
+
+  /* the cofactor does not copy the cubes with the other literal, so a list, where all cubes have the same literal, is created here */
+  l = bcp_NewBCLWithRandomTautology(p, 30, 0);
+  for( i = 0; i < l->cnt; i++ )
+    bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, i), var_cnt-1, 2);
+  assert( bcp_IsBCLTautology(p, l) == 0 );
+
+  /* deleted cubes of a private list are ignored by bcp_IsBCLTautologySub() */
+  bcp_AddBCLCubeByCube(p, l, bcp_GetGlobalCube(p, 3));
+  l->flags[l->cnt-1] = 1;
+  assert( bcp_IsBCLTautologySub(p, l, NULL, 0, 0) == 0 );
+  bcp_DeleteBCL(p, l);
+  l = bcp_NewBCLWithRandomTautology(p, 30, 0);
+  for( i = 0; i < 20; i++ )
+  {
+    bcp_AddBCLCubeByCube(p, l, bcp_GetBCLCube(p, l, i));
+    bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, l->cnt-1), var_cnt-1, 0);   // illegal cube, which must be ignored
+    l->flags[l->cnt-1] = 1;
+  }
+  assert( bcp_IsBCLTautologySub(p, l, NULL, 0, 0) != 0 );
+  bcp_DeleteBCL(p, l);
+
+  bcp_ShowTautologyLeafStatistics(p);
+  for( i = 0; i < BCP_TAUTOLOGY_LEAF_CNT; i++ )
+    assert( p->tautology_leaf_cnt[i] > 0 );
+  bcp_Delete(p);
+}
+
+/* compare complement and subset with truth table against the cube based algorithms */
+void truthTableTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl m = bcp_NewBCL(p);
+  bcl c, s;
+  int i, j, k, pos;
+
+  assert( var_cnt <= BCP_TRUTH_TABLE_MAX_VAR_CNT );
+  printf("truth table test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < 20; i++ )
+  {
+    bcp_ClearBCL(p, l);
+    for( j = 0; j < 3 + i; j++ )
+    {
+      pos = bcp_AddBCLCube(p, l);
+      bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 50);
+    }
+    c = bcp_NewBCLComplementWithTruthTable(p, l);
+    s = bcp_NewBCLComplementWithSubtract(p, l);
+    assert( c != NULL && s != NULL );
+    for( j = 0; j < c->cnt; j++ )
+      for( k = 0; k < l->cnt; k++ )
+        assert( bcp_IsIntersectionCube(p, bcp_GetBCLCube(p, c, j), bcp_GetBCLCube(p, l, k)) == 0 );
+    assert( bcp_IsBCLSubsetWithCofactor(p, c, s) != 0 );
+    assert( bcp_IsBCLSubsetWithCofactor(p, s, c) != 0 );
+    assert( bcp_IsBCLSubsetWithTruthTable(p, c, s) == 1 );
+    
+    /* "m" is "l" without the last cube */
+    bcp_CopyBCL(p, m, l);
+    m->flags[m->cnt-1] = 1;
+    bcp_PurgeBCL(p, m);
+    assert( bcp_IsBCLSubsetWithTruthTable(p, l, m) == 1 );
+    assert( bcp_IsBCLSubsetWithTruthTable(p, m, l) == bcp_IsBCLSubsetWithCofactor(p, m, l) );
+    assert( bcp_IsBCLSubsetWithTruthTable(p, c, l) == 0 || l->cnt == 0 );
+    
+    bcp_DeleteBCL(p, c);
+    bcp_DeleteBCL(p, s);
+  }
+  bcp_DeleteBCL(p, l);
+  bcp_DeleteBCL(p, m);
+  bcp_Delete(p);
+}
+
+/* 
+  lists with "group_cnt" independent groups of 6 variables each: check bcp_GetBCLPartition(), 
+  the k-way tautology recursion and the complement with partitions 
+*/
+void partitionTest(int group_cnt)
+{
+  bcp p = bcp_New(group_cnt*6);
+  bcl l = bcp_NewBCL(p);
+  bcl c, s;
+  bc m1, m2;
+  int i, j, k, g, v, pos;
+
+  printf("partition test, group_cnt=%d\n", group_cnt);
+  bcp_StartCubeStackFrame(p);
+  m1 = bcp_GetTempCube(p);
+  m2 = bcp_GetTempCube(p);
+  for( i = 0; i < 4*group_cnt; i++ )
+  {
+    /* a chain of cubes inside each group, so that all cubes of a group are connected */
+    g = i % group_cnt;
+    v = (i / group_cnt) % 5;
+    pos = bcp_AddBCLCube(p, l);
+    bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), g*6 + v, 1 + (rand() & 1));
+    bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), g*6 + v + 1, 1 + (rand() & 1));
+  }
+  k = bcp_GetBCLPartition(p, l);
+  assert( k == group_cnt );
+  for( i = 0; i < l->cnt; i++ )
+    for( j = 0; j < l->cnt; j++ )
+    {
+      bcp_GetVariableMask(p, m1, bcp_GetBCLCube(p, l, i));
+      bcp_GetVariableMask(p, m2, bcp_GetBCLCube(p, l, j));
+      assert( (l->flags[i] == l->flags[j]) == (i % group_cnt == j % group_cnt) );
+      if ( l->flags[i] != l->flags[j] )
+        assert( bcp_IsAndZero(p, m1, m2) );
+    }
+  memset(l->flags, 0, l->cnt);
+  bcp_EndCubeStackFrame(p);
+  
+  /* each group is not a tautology, so the complete list is not a tautology */
+  assert( bcp_IsBCLTautology(p, l) == 0 );
+  c = bcp_NewBCLComplementWithURP(p, l);
+  s = bcp_NewBCLComplementWithSubtract(p, l);
+  assert( c != NULL && s != NULL );
+  assert( bcp_IsBCLEqual(p, c, s) != 0 );
+  bcp_DeleteBCL(p, c);
+  bcp_DeleteBCL(p, s);
+  
+  /* the last group becomes a tautology */
+  pos = bcp_AddBCLCube(p, l);
+  bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), (group_cnt-1)*6, 1);
+  pos = bcp_AddBCLCube(p, l);
+  bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), (group_cnt-1)*6, 2);
+  assert( bcp_IsBCLTautology(p, l) != 0 );
+  c = bcp_NewBCLComplementWithURP(p, l);
+  assert( c != NULL && c->cnt == 0 );
+  bcp_DeleteBCL(p, c);
+  
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* 
+  compare the incremental update of the binate split table against the full calculation 
+  the new cofactor list must be equal to the in-place cofactor, also for the cofactor by cube
+*/
+void splitTableTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCLWithRandomTautology(p, var_cnt/2 > 30 ? 30 : var_cnt/2, var_cnt);
+  bcl f, n;
+  int j;
+  bct t = bcp_NewBCT(p);
+  bct ct = bcp_NewBCT(p);
+  bct ft = bcp_NewBCT(p);
+  int i, value;
+
+  printf("split table test, var_cnt=%d cnt=%d\n", var_cnt, l->cnt);
+  bcp_CalcBCLBinateSplitVariableTable(p, t, l);
+  for( i = 0; i < var_cnt; i++ )
+  {
+    for( value = 1; value <= 2; value++ )
+    {
+      f = bcp_NewBCLCofacterByVariableWithBCT(p, l, t, ct, i, value);
+      assert( f != NULL );
+      bcp_CalcBCLBinateSplitVariableTable(p, ft, f);
+      assert( ct->cnt == ft->cnt );
+      assert( memcmp(ct->zero_cnt, ft->zero_cnt, 16*p->blk_cnt*sizeof(__m128i)) == 0 );
+      assert( bcp_GetBCLMaxBinateSplitVariable(p, ct, f) == bcp_GetBCLMaxBinateSplitVariableSimple(p, ft, f) );
+      n = bcp_NewBCLByBCL(p, l);
+      assert( n != NULL );
+      bcp_DoBCLOneVariableCofactor(p, n, i, value);
+      assert( n->cnt == f->cnt );
+      for( j = 0; j < n->cnt; j++ )
+        assert( bcp_CompareCube(p, bcp_GetBCLCube(p, n, j), bcp_GetBCLCube(p, f, j)) == 0 );
+      bcp_DeleteBCL(p, n);
+      bcp_DeleteBCL(p, f);
+    }
+  }
+  bcp_GetBCLSignature(p, l);         // the signatures of unmodified cubes are copied by bcp_NewBCLCofactorByCube()
+  for( i = 0; i < l->cnt && i < 32; i++ )
+  {
+    f = bcp_NewBCLCofactorByCube(p, l, bcp_GetBCLCube(p, l, i), i & 1 ? i : -1);
+    assert( f != NULL );
+    bcp_CheckBCLSignature(p, f);
+    n = bcp_NewBCLByBCL(p, l);
+    assert( n != NULL );
+    bcp_DoBCLCofactorByCube(p, n, bcp_GetBCLCube(p, l, i), i & 1 ? i : -1);
+    assert( n->cnt == f->cnt );
+    for( j = 0; j < n->cnt; j++ )
+      assert( bcp_CompareCube(p, bcp_GetBCLCube(p, n, j), bcp_GetBCLCube(p, f, j)) == 0 );
+    bcp_DeleteBCL(p, n);
+    bcp_DeleteBCL(p, f);
+  }
+  bcp_DeleteBCT(p, t);
+  bcp_DeleteBCT(p, ct);
+  bcp_DeleteBCT(p, ft);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* add the cubes of "a" (from "q") to "l" (from "p"), the variables of "a" are moved by "offset" */
+static void bcp_AddBCLCubesWithOffset(bcp p, bcl l, bcp q, bcl a, int offset)
+{
+  int i, v, pos;
+  for( i = 0; i < a->cnt; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    assert( pos >= 0 );
+    for( v = 0; v < q->var_cnt; v++ )
+      bcp_SetCubeVar(p, bcp_GetBCLCube(p, l, pos), offset + v, bcp_GetCubeVar(q, bcp_GetBCLCube(q, a, i), v));
+  }
+}
+
+/* compare the multi threaded tautology check against the serial version */
+void parallelTautologyTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcp q = bcp_New(var_cnt/2);
+  bcl l, a, b;
+  int i, thread_cnt;
+  int serial, parallel;
+  int is_ok;
+
+  for( i = 0; i < 6; i++ )
+  {
+    l = bcp_NewBCLWithRandomTautology(p, 30, i);
+    serial = bcp_IsBCLTautology(p, l);
+    for( thread_cnt = 2; thread_cnt <= 4; thread_cnt++ )
+    {
+      parallel = bcp_IsBCLTautologyParallel(p, l, thread_cnt);
+      printf("parallel tautology test, cnt=%d, threads=%d, serial=%d parallel=%d\n", l->cnt, thread_cnt, serial, parallel);
+      assert( serial == parallel );
+    }
+    bcp_DeleteBCL(p, l);
+  }
+  
+  /* two independent partitions: a partition, which is not a tautology, must not cancel the other partition */
+  for( i = 0; i < 4; i++ )
+  {
+    a = bcp_NewBCLWithRandomTautology(q, 40, 1 + i);
+    b = bcp_NewBCLWithRandomTautology(q, 40, i % 2);
+    l = bcp_NewBCL(p);
+    bcp_AddBCLCubesWithOffset(p, l, q, a, 0);
+    bcp_AddBCLCubesWithOffset(p, l, q, b, q->var_cnt);
+    serial = bcp_IsBCLTautology(p, l);
+    parallel = bcp_IsBCLTautologyParallel(p, l, 4);
+    printf("parallel tautology partition test, cnt=%d, serial=%d parallel=%d\n", l->cnt, serial, parallel);
+    assert( serial == parallel );
+    
+    /* the workers use a cache with the same settings */
+    is_ok = bcp_EnableTautologyCache(p, 0, 8);
+    assert( is_ok != 0 );
+    assert( bcp_IsBCLTautologyParallel(p, l, 3) == serial );
+    assert( bcp_IsBCLTautologyParallel(p, l, 3) == serial );
+    bcp_DisableTautologyCache(p);
+    bcp_DeleteBCL(p, l);
+    bcp_DeleteBCL(q, a);
+    bcp_DeleteBCL(q, b);
+  }
+  bcp_Delete(q);
+  bcp_Delete(p);
+}
+
+/* shared lists for the context test, each thread uses its own context */
+struct context_test_struct
+{
+  bcp p;                // context of the thread
+  bcl t;                // shared tautology list
+  bcl r;                // shared list, which is not a tautology
+  bcl off;              // shared list, used for the bit sliced view
+  int result;
+};
+
+static void *contextTestThread(void *arg)
+{
+  struct context_test_struct *ct = (struct context_test_struct *)arg;
+  bcp p = ct->p;
+  uint64_t *mask;
+  int i;
+  ct->result = 1;
+  mask = (uint64_t *)malloc(((ct->off->cnt + 127)/128*2)*sizeof(uint64_t));
+  assert( mask != NULL );
+  for( i = 0; i < 20; i++ )
+  {
+    if ( bcp_IsBCLTautology(p, ct->t) == 0 )
+      ct->result = 0;
+    if ( bcp_IsBCLTautology(p, ct->r) != 0 )
+      ct->result = 0;
+    if ( bcp_IsBCLEqual(p, ct->r, ct->r) == 0 )
+      ct->result = 0;
+    if ( bcp_GetBCLSliceIntersectionMask(p, ct->off, bcp_GetBCLCube(p, ct->off, i % ct->off->cnt), mask) == 0 )
+      ct->result = 0;
+    bcp_GetStringFromCube(p, bcp_GetBCLCube(p, ct->r, i % ct->r->cnt));
+  }
+  free(mask);
+  return NULL;
+}
+
+/* run the same operations on the same lists in several threads */
+void contextTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl t = bcp_NewBCLWithRandomTautology(p, 24, 0);
+  bcl r = bcp_NewBCLWithRandomTautology(p, 24, 3);
+  struct context_test_struct ct[4];
+  pthread_t thread[4];
+  int i, result;
+  
+  printf("context test, var_cnt=%d\n", var_cnt);
+  assert( bcp_IsBCLTautology(p, t) != 0 );
+  assert( bcp_IsBCLTautology(p, r) == 0 );
+  for( i = 0; i < 4; i++ )
+  {
+    ct[i].p = bcp_NewContext(p);
+    assert( ct[i].p != NULL );
+    ct[i].t = t;
+    ct[i].r = r;
+    ct[i].off = t;
+    result = pthread_create(thread+i, NULL, contextTestThread, ct+i);
+    assert( result == 0 );
+  }
+  for( i = 0; i < 4; i++ )
+  {
+    pthread_join(thread[i], NULL);
+    assert( ct[i].result != 0 );
+    bcp_Delete(ct[i].p);
+  }
+  bcp_DeleteBCL(p, t);
+  bcp_DeleteBCL(p, r);
+  bcp_Delete(p);
+}
+
+/* the parallel IRREDUNDANT must return the same cubes in the same order as the serial version */
+void parallelMCCTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl m;
+  int i, j, pos, thread_cnt;
+
+  for( i = 0; i < 6; i++ )
+  {
+    bcp_ClearBCL(p, l);
+    for( j = 0; j < 60 + i*40; j++ )
+    {
+      pos = bcp_AddBCLCube(p, l);
+      bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 40 + i*2);
+    }
+    bcp_DoBCLSingleCubeContainment(p, l);
+    for( thread_cnt = 2; thread_cnt <= 4; thread_cnt++ )
+    {
+      m = bcp_NewBCLByBCL(p, l);
+      assert( m != NULL );
+      bcp_DoBCLMultiCubeContainmentParallel(p, m, thread_cnt);
+      if ( thread_cnt == 2 )
+        bcp_DoBCLMultiCubeContainment(p, l);
+      printf("parallel MCC test, threads=%d, serial cnt=%d parallel cnt=%d\n", thread_cnt, l->cnt, m->cnt);
+      assert( m->cnt == l->cnt );
+      for( j = 0; j < l->cnt; j++ )
+        assert( bcp_CompareCube(p, bcp_GetBCLCube(p, l, j), bcp_GetBCLCube(p, m, j)) == 0 );
+      bcp_DeleteBCL(p, m);
+    }
+  }
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* write a random bcl with "cnt" cubes as json string vector */
+static void jsonTestWriteBCL(bcp p, FILE *fp, int cnt)
+{
+  int i;
+  bc c;
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  fprintf(fp, "[");
+  for( i = 0; i < cnt; i++ )
+  {
+    bcp_SetRandomCube(p, c, 70);
+    fprintf(fp, "%s\"%s\"", i == 0 ? "" : ",", bcp_GetStringFromCube(p, c));
+  }
+  fprintf(fp, "]");
+  bcp_EndCubeStackFrame(p);
+}
+
+/* read the remaining content of "fp" into a '\0' terminated string, which must be free'd */
+static char *jsonTestReadFile(FILE *fp)
+{
+  long size;
+  char *s;
+  size_t read_size;
+  fseek(fp, 0L, SEEK_END);
+  size = ftell(fp);
+  rewind(fp);
+  s = (char *)malloc(size+1);
+  assert( s != NULL );
+  read_size = fread(s, 1, size, fp);
+  assert( read_size == (size_t)size );
+  s[size] = '\0';
+  return s;
+}
+
+/* the json commands must produce the same output with one and with several threads */
+void jsonTest(int slot_cnt)
+{
+  bcp p = bcp_New(12);
+  FILE *in = tmpfile();
+  FILE *out1 = tmpfile();
+  FILE *out4 = tmpfile();
+  co v;
+  char *s1, *s4;
+  int i, slot, is_ok;
+  static const char *cmd[] = { "equal0", "subtract0", "intersection0", "copy0", "exchange0", "equal0" };
+  
+  assert( in != NULL && out1 != NULL && out4 != NULL );
+  fprintf(in, "[\n");
+  for( i = 0; i < slot_cnt; i++ )
+  {
+    fprintf(in, "{\"cmd\":\"bcl2slot\", \"slot\":%d, \"bcl\":", i);
+    jsonTestWriteBCL(p, in, 4 + i % 7);
+    fprintf(in, "},\n");
+  }
+  for( i = 0; i < 8*slot_cnt; i++ )
+  {
+    slot = 1 + (i*7) % (slot_cnt-1);
+    if ( i % 9 == 4 )                   // reload slot 0 from time to time
+    {
+      fprintf(in, "{\"cmd\":\"bcl2slot\", \"slot\":0, \"bcl\":");
+      jsonTestWriteBCL(p, in, 12);
+      fprintf(in, "},\n");
+    }
+    if ( i % 5 == 2 )
+    {
+      fprintf(in, "{\"cmd\":\"%s\", \"label\":\"l%d\", \"bcl\":", cmd[i%6], i);
+      jsonTestWriteBCL(p, in, 6);
+      fprintf(in, "},\n");
+    }
+    else
+    {
+      fprintf(in, "{\"cmd\":\"%s\", \"slot\":%d, \"%s\":\"l%d\"},\n", cmd[i%6], slot, i % 3 == 0 ? "label0" : "label", i);
+    }
+  }
+  fprintf(in, "{\"cmd\":\"equal0\", \"slot\":1, \"label0\":\"last\"}\n]\n");
+  rewind(in);
+  v = coReadJSONByFP(in);
+  assert( v != NULL );
+  
+  is_ok = bc_ExecuteVector(v, slot_cnt, 1, out1);
+  assert( is_ok != 0 );
+  is_ok = bc_ExecuteVector(v, slot_cnt, 4, out4);
+  assert( is_ok != 0 );
+  s1 = jsonTestReadFile(out1);
+  s4 = jsonTestReadFile(out4);
+  printf("json test, slot_cnt=%d, cmd cnt=%ld, output size=%ld\n", slot_cnt, coVectorSize(v), (long)strlen(s1));
+  assert( strstr(s1, "superset") != NULL );
+  assert( strcmp(s1, s4) == 0 );
+  
+  free(s1);
+  free(s4);
+  coDelete(v);
+  fclose(in);
+  fclose(out1);
+  fclose(out4);
+  bcp_Delete(p);
+}
+
+/* returns the value of member "key" of the result map for "label" in the response line "line" */
+static int serverTestGetResult(char *line, const char *label, const char *key)
+{
+  FILE *fp = fmemopen(line, strlen(line), "r");
+  co resp;
+  cco o;
+  int value = -1;
+  assert( fp != NULL );
+  resp = coReadJSONByFP(fp);
+  fclose(fp);
+  assert( resp != NULL );
+  o = coMapGet(resp, "result");
+  if ( o != NULL )
+    o = coMapGet(o, label);
+  if ( o != NULL )
+    o = coMapGet(o, key);
+  if ( coIsDbl(o) )
+    value = (int)coDblGet(o);
+  coDelete(resp);
+  return value;
+}
+
+/* returns 1 if the response line "line" has an "error" member */
+static int serverTestIsError(char *line)
+{
+  FILE *fp = fmemopen(line, strlen(line), "r");
+  co resp;
+  int is_error;
+  assert( fp != NULL );
+  resp = coReadJSONByFP(fp);
+  fclose(fp);
+  assert( resp != NULL );
+  is_error = coIsStr(coMapGet(resp, "error"));
+  coDelete(resp);
+  return is_error;
+}
+
+/* the slots of a problem must be available for the next request, also after an invalid command */
+void serverTest(void)
+{
+  FILE *in = tmpfile();
+  FILE *out = tmpfile();
+  char line[1024];
+  int i, is_ok;
+  
+  assert( in != NULL && out != NULL );
+  fprintf(in, "{\"problem\":\"x\", \"cmd\":[{\"cmd\":\"bcl2slot\", \"expr\":\"a&b|c\"}, {\"cmd\":\"bcl2slot\", \"expr\":\"d\", \"slot\":1}]}\n");
+  fprintf(in, "{\"problem\":\"y\", \"cmd\":[{\"cmd\":\"bcl2slot\", \"bcl\":\"1-0\"}]}\n");
+  fprintf(in, "\n");
+  fprintf(in, "{\"problem\":\"x\", \"cmd\":[{\"cmd\":\"equal0\", \"expr\":\"c|b&a\", \"label\":\"eq\"}]}\n");
+  fprintf(in, "{\"problem\":\"y\", \"cmd\":[{\"cmd\":\"subtract0\", \"bcl\":\"1--\", \"label\":\"sub\"}], \"delete\":1}\n");
+  fprintf(in, "{\"problem\":\"x\", \"cmd\":[{\"cmd\":\"intersection0\", \"slot\":1, \"label\":\"is\"}]}\n");
+  fprintf(in, "{\"problem\":\"y\", \"cmd\":[{\"cmd\":\"bcl2slot\", \"bcl\":\"1-0\"}, {\"cmd\":\"equal0\", \"bcl\":\"1-0\", \"label\":\"eq\"}]}\n");
+  fprintf(in, "{\"problem\":\"z\", \"cmd\":[{\"cmd\":\"bcl2slot\", \"bcl\":\"10\"}, {\"cmd\":\"equal0\", \"slot\":1, \"label\":\"eq\"}]}\n");
+  fprintf(in, "{\"problem\":\"z\", \"cmd\":[{\"cmd\":\"bcl2slot\", \"bcl\":\"101\"}, {\"cmd\":\"copy0\", \"slot\":1}]}\n");
+  fprintf(in, "{\"problem\":\"z\", \"cmd\":[{\"cmd\":\"equal0\", \"bcl\":\"10\", \"label\":\"eq\"}, {\"cmd\":\"equal0\", \"slot\":1, \"label\":\"eq1\"}]}\n");
+  fprintf(in, "{\"quit\":0}\n");
+  fprintf(in, "{\"quit\":1}\n");
+  fprintf(in, "{\"problem\":\"x\", \"cmd\":[{\"cmd\":\"bcl2slot\", \"expr\":\"a\", \"label\":\"no\"}]}\n");
+  rewind(in);
+  
+  is_ok = bc_ExecuteServer(in, out, 4, 2);
+  assert( is_ok != 0 );
+  rewind(out);
+  i = 0;
+  while( fgets(line, 1024, out) != NULL )
+  {
+    if ( line[0] == '\n' )
+      continue;
+    if ( i == 2 )
+      assert( serverTestGetResult(line, "eq", "superset") == 1 && serverTestGetResult(line, "eq", "subset") == 1 );
+    if ( i == 3 )
+      assert( serverTestGetResult(line, "sub", "empty") == 1 );
+    if ( i == 4 )
+      assert( serverTestGetResult(line, "is", "empty") == 0 );
+    if ( i == 5 )
+      assert( serverTestGetResult(line, "eq", "superset") == 1 );
+    if ( i == 6 )               // slot 1 is empty
+      assert( serverTestIsError(line) && serverTestGetResult(line, "eq", "superset") == -1 );
+    if ( i == 7 )               // bcl with three variables, "copy0" is still executed
+      assert( serverTestIsError(line) );
+    if ( i == 8 )
+      assert( serverTestIsError(line) == 0 && serverTestGetResult(line, "eq", "superset") == 1 && serverTestGetResult(line, "eq1", "subset") == 1 );
+    if ( i == 9 )               // "quit":0
+      assert( serverTestIsError(line) == 0 );
+    i++;
+  }
+  printf("server test, response cnt=%d\n", i);
+  assert( i == 10 );
+  fclose(in);
+  fclose(out);
+}
+
+/* the statistics of a context must be added to the problem */
+void statTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcp c;
+  bcl l = bcp_NewBCLWithRandomTautology(p, 20, 0);
+  bcl m;
+  co s;
+  long node_cnt;
+  
+  assert( l != NULL );
+  bcp_ClearStat(p);
+  assert( bcp_IsBCLTautology(p, l) != 0 );
+  node_cnt = p->stat.cnt[BCP_STAT_TAUTOLOGY_NODE];
+  printf("stat test, var_cnt=%d, tautology nodes=%ld, max depth=%d, cofactor cubes=%ld, time=%.6f\n", var_cnt, 
+    node_cnt, p->stat.tautology_max_depth, p->stat.cnt[BCP_STAT_COFACTOR_CUBE], p->stat.op_time[BCP_STAT_OP_TAUTOLOGY]);
+#if BCP_STAT
+  assert( node_cnt > 0 );
+  assert( p->stat.op_cnt[BCP_STAT_OP_TAUTOLOGY] == 1 );
+  assert( p->stat.op_depth[BCP_STAT_OP_TAUTOLOGY] == 0 );
+#endif
+
+  c = bcp_NewContext(p);
+  assert( c != NULL );
+  m = bcp_NewBCLComplement(c, l);       // complement of a tautology is empty
+  assert( m != NULL && m->cnt == 0 );
+  assert( bcp_IsBCLSubset(c, l, l) != 0 );
+  assert( c->stat.op_cnt[BCP_STAT_OP_TAUTOLOGY] == 0 );         // the subset test calls the sub function directly
+  bcp_DeleteBCL(c, m);
+  bcp_Delete(c);
+#if BCP_STAT
+  assert( p->stat.op_cnt[BCP_STAT_OP_COMPLEMENT] == 1 );
+  assert( p->stat.op_cnt[BCP_STAT_OP_SUBSET] == 1 );
+  assert( p->stat.cnt[BCP_STAT_TAUTOLOGY_NODE] >= node_cnt );
+#endif
+
+  s = bcp_NewStatMap(p);
+  assert( s != NULL );
+  assert( coIsDbl(coMapGet(s, "tautology_node")) );
+  assert( (long)coDblGet(coMapGet(s, "tautology_node")) == p->stat.cnt[BCP_STAT_TAUTOLOGY_NODE] );
+  assert( coIsMap(coMapGet(s, "op")) );
+  coDelete(s);
+  
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
 void speedTest(int cnt) 
 {
   int is_subset = 0;
@@ -430,4 +1569,602 @@ void expressionTest(void)
   expression_test_sub("--11\n1--1\n-1-1\n", "(a|b|c)&d", 1);
   expression_test_sub("--11\n1--1\n-1-1\n", "-(-a&-b&-c)&d", 1);
   expression_test_sub("--11\n1--1\n-1-1\n", "-(-a&-b&-c)&d", 0);
-}
\ No newline at end of file
+}
+/* write "l" as DIMACS CNF, each cube becomes one clause with inverted literals */
+static void dimacsCNFTestWrite(bcp p, bcl l, FILE *fp)
+{
+  int i, v, code;
+  fprintf(fp, "c dimacs cnf test\nc\np cnf %d %d\n", p->var_cnt, l->cnt);
+  for( i = 0; i < l->cnt; i++ )
+  {
+    for( v = 0; v < p->var_cnt; v++ )
+    {
+      code = bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, i), v);
+      if ( code == 1 )
+        fprintf(fp, "%d ", v+1);
+      else if ( code == 2 )
+        fprintf(fp, "-%d%s", v+1, (v % 7) == 0 ? "\n  " : "\t");     // clauses may continue on the next line
+    }
+    fprintf(fp, "0\n");
+  }
+}
+
+/* read a DIMACS CNF with mmap, with a small buffer, from a pipe and check some invalid inputs */
+void dimacsCNFTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl r;
+  bcd d;
+  FILE *fp;
+  int i, pos, result, fd[2];
+  ssize_t write_size;
+  static const char *pipe_cnf = "p cnf 3 2\n1 -3 0\n-2 0\n%\n0\n";
+  static const char *invalid_cnf[] = { "1 2 0\n", "p dnf 3 1\n1 0\n", "p cnf 3 1\n1 99 0\n", "p cnf 3 1\n1 x 0\n", NULL };
+
+  printf("dimacs cnf test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < 200; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 70);
+  }
+  bcp_AddBCLCube(p, l);         // an empty clause is the universal cube
+  
+  fp = tmpfile();
+  assert( fp != NULL );
+  dimacsCNFTestWrite(p, l, fp);
+  fflush(fp);
+  for( i = 0; i < 2; i++ )
+  {
+    rewind(fp);
+    d = bcp_NewBCD(fp, i == 0 ? 0 : 5);
+    assert( d != NULL );
+    assert( d->is_mmap == (i == 0) );
+    assert( d->var_cnt == var_cnt && d->clause_cnt == l->cnt );
+    r = bcp_NewBCLByBCD(p, d);
+    assert( r != NULL );
+    assert( bcp_IsBCLEqual(p, l, r) );
+    bcp_DeleteBCL(p, r);
+    bcp_DeleteBCD(d);
+  }
+  r = bcp_NewBCLByDIMACSCNF(p, fp);   // old interface
+  assert( r != NULL && bcp_IsBCLEqual(p, l, r) );
+  bcp_DeleteBCL(p, r);
+  fclose(fp);
+  
+  for( i = 0; invalid_cnf[i] != NULL; i++ )
+  {
+    fp = tmpfile();
+    assert( fp != NULL );
+    fputs(invalid_cnf[i], fp);
+    rewind(fp);
+    d = bcp_NewBCD(fp, 0);
+    if ( d != NULL )
+    {
+      r = bcp_NewBCLByBCD(p, d);
+      assert( r == NULL );
+      bcp_DeleteBCD(d);
+    }
+    fclose(fp);
+  }
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+  
+  /* a pipe can not be mapped or seeked, the two cubes are 0-1 and -1-, the SATLIB end marker "%" stops the parser */
+  result = pipe(fd);
+  assert( result == 0 );
+  write_size = write(fd[1], pipe_cnf, strlen(pipe_cnf));
+  assert( write_size == (ssize_t)strlen(pipe_cnf) );
+  close(fd[1]);
+  fp = fdopen(fd[0], "r");
+  assert( fp != NULL );
+  d = bcp_NewBCD(fp, 0);
+  assert( d != NULL && d->is_mmap == 0 );
+  p = bcp_NewByBCD(d);
+  l = bcp_NewBCLByBCD(p, d);
+  assert( l != NULL && l->cnt == 2 );
+  assert( bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, 0), 0) == 1 && bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, 0), 1) == 3 && bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, 0), 2) == 2 );
+  assert( bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, 1), 0) == 3 && bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, 1), 1) == 2 );
+  bcp_DeleteBCD(d);
+  fclose(fp);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* write a random PLA with "out_cnt" outputs, type "fr" uses all minterms of the inputs so that on-set and off-set do not intersect */
+static void plaTestWrite(int in_cnt, int out_cnt, const char *type, FILE *fp)
+{
+  static const char in_char[] = "01---";
+  static const char out_char[] = "110--";
+  int i, j, k;
+  int is_minterm = strcmp(type, "fr") == 0;
+  int cnt = is_minterm ? 1<<in_cnt : 4*in_cnt;
+  fprintf(fp, "# random pla\n.i %d\n.o %d\n.ilb", in_cnt, out_cnt);
+  for( i = 0; i < in_cnt; i++ )
+    fprintf(fp, " x%d", i);
+  fprintf(fp, "\n.ob");
+  for( k = 0; k < out_cnt; k++ )
+    fprintf(fp, " y%d", k);
+  fprintf(fp, "\n.type %s\n.p %d\n", type, cnt);
+  for( j = 0; j < cnt; j++ )
+  {
+    for( i = 0; i < in_cnt; i++ )
+      fputc(is_minterm ? '0' + ((j >> i) & 1) : in_char[rand() % 5], fp);
+    fputc(' ', fp);
+    for( k = 0; k < out_cnt; k++ )
+      fputc(out_char[rand() % 5], fp);
+    fputc('\n', fp);
+  }
+  fprintf(fp, ".e\n");
+}
+
+/* 
+  read a random PLA, minimize all outputs and check each output against the original PLA:
+  on-set <= result + dc-set <= on-set + dc-set (type "fd") or result does not intersect with the off-set (type "fr")
+  the written result must be equal to the minimized function
+*/
+void plaTest(int in_cnt, int out_cnt, const char *type)
+{
+  static const char *invalid_pla[] = { ".o 1\n1 1\n", ".i 3\n10 1\n", ".i 2\n.mv 3\n", ".i 2\n.o 2\n.ob a\n11 11\n", ".i 2\n11 1\n.type fr\n", ".i 2\n1x 1\n", NULL };
+  FILE *fp = tmpfile();
+  bcf f, g, h;
+  bcl on, dc, off, r, w, t;
+  int i, k, is_ok, out_cube_cnt = 0;
+
+  assert( fp != NULL );
+  printf("pla test, in_cnt=%d, out_cnt=%d, type=%s", in_cnt, out_cnt, type);
+  plaTestWrite(in_cnt, out_cnt, type, fp);
+  rewind(fp);
+  f = bcp_NewBCFByPLA(fp);
+  rewind(fp);
+  g = bcp_NewBCFByPLA(fp);
+  fclose(fp);
+  assert( f != NULL && g != NULL );
+  assert( f->in_cnt == in_cnt && f->out_cnt == out_cnt && f->p->var_cnt == in_cnt + out_cnt );
+  assert( f->in_name != NULL && coVectorSize(f->in_name) == (size_t)in_cnt );
+  assert( (f->off != NULL) == (strcmp(type, "fr") == 0) );
+  
+  is_ok = bcp_MinimizeBCF(f);
+  assert( is_ok != 0 );
+  printf(", cnt=%d, minimized cnt=%d", g->on->cnt, f->on->cnt);
+  
+  fp = tmpfile();
+  assert( fp != NULL );
+  is_ok = bcp_WriteBCFPLA(f, fp);
+  assert( is_ok != 0 );
+  rewind(fp);
+  h = bcp_NewBCFByPLA(fp);
+  fclose(fp);
+  assert( h != NULL && h->out_name != NULL && coVectorSize(h->out_name) == (size_t)out_cnt );
+
+  for( k = 0; k < out_cnt; k++ )
+  {
+    on = bcp_NewBCLByBCFOutput(g, g->on, k);
+    dc = bcp_NewBCLByBCFOutput(g, g->dc, k);
+    r = bcp_NewBCLByBCFOutput(f, f->on, k);
+    w = bcp_NewBCLByBCFOutput(h, h->on, k);
+    assert( on != NULL && dc != NULL && r != NULL && w != NULL );
+    out_cube_cnt += r->cnt;
+    assert( bcp_IsBCLEqual(f->p, r, w) );
+    t = bcp_NewBCLByBCL(f->p, r);
+    assert( t != NULL );
+    is_ok = bcp_AddBCLCubesByBCL(f->p, t, dc);
+    assert( is_ok != 0 );
+    assert( bcp_IsBCLSubset(f->p, t, on) );     // a point of the on-set, which is also part of the dc-set, is a don't care
+    bcp_DeleteBCL(f->p, t);
+    if ( g->off != NULL )
+    {
+      off = bcp_NewBCLByBCFOutput(g, g->off, k);
+      t = bcp_NewBCL(f->p);
+      assert( off != NULL && t != NULL );
+      is_ok = bcp_IntersectionBCLs(f->p, t, r, off);
+      assert( is_ok != 0 );
+      assert( t->cnt == 0 );
+      bcp_DeleteBCL(f->p, t);
+      bcp_DeleteBCL(g->p, off);
+    }
+    else
+    {
+      is_ok = bcp_AddBCLCubesByBCL(g->p, dc, on);
+      assert( is_ok != 0 );
+      assert( bcp_IsBCLSubset(f->p, dc, r) );
+    }
+    bcp_DeleteBCL(h->p, w);
+    bcp_DeleteBCL(f->p, r);
+    bcp_DeleteBCL(g->p, dc);
+    bcp_DeleteBCL(g->p, on);
+  }
+  printf(", cubes of all outputs=%d\n", out_cube_cnt);
+  assert( out_cube_cnt >= f->on->cnt );         // a shared cube is counted for each of its outputs
+  bcp_DeleteBCF(h);
+  bcp_DeleteBCF(g);
+  bcp_DeleteBCF(f);
+
+  for( i = 0; invalid_pla[i] != NULL; i++ )
+  {
+    fp = tmpfile();
+    assert( fp != NULL );
+    fputs(invalid_pla[i], fp);
+    rewind(fp);
+    f = bcp_NewBCFByPLA(fp);
+    assert( f == NULL );
+    fclose(fp);
+  }
+}
+
+/* save a list with variable names into the binary format and map it back */
+void binaryBCLTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcp q;
+  bcl l = bcp_NewBCL(p);
+  bcl m, r;
+  char name[] = "/tmp/bcbinXXXXXX";
+  char var_name[16];
+  FILE *fp;
+  int i, pos, fd, is_ok;
+
+  printf("binary bcl test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < var_cnt; i++ )
+  {
+    sprintf(var_name, "v%d", i);
+    is_ok = bcp_AddVar(p, var_name);
+    assert( is_ok != 0 );
+  }
+  for( i = 0; i < 100; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 60);
+  }
+  m = bcp_NewBCLByBCL(p, l);
+  l->flags[7] = 1;      // deleted cubes are not written
+  m->flags[7] = 1;
+  bcp_PurgeBCL(p, m);
+
+  fd = mkstemp(name);
+  assert( fd >= 0 );
+  close(fd);
+  is_ok = bcp_SaveBCLBinaryFile(p, l, name);
+  assert( is_ok != 0 );
+
+  q = bcp_NewByBinaryFile(name);
+  assert( q != NULL && q->var_cnt == var_cnt && q->x_var_cnt == var_cnt );
+  r = bcp_NewBCLByBinaryFile(q, name);
+  assert( r != NULL && r->map_addr != NULL );
+  is_ok = bcp_BuildVarList(q);
+  assert( is_ok != 0 );
+  for( i = 0; i < var_cnt; i++ )
+  {
+    sprintf(var_name, "v%d", i);
+    assert( strcmp(coStrGet(coVectorGet(q->var_list, i)), var_name) == 0 );
+  }
+  assert( bcp_IsBCLEqual(p, m, r) );
+  bcp_SetCubeVar(q, bcp_GetBCLCube(q, r, 0), 0, 3);    // copy on write, the file is not changed
+  pos = bcp_AddBCLCubeByCube(q, r, bcp_GetGlobalCube(q, 3));   // the cubes are moved to the heap
+  assert( pos >= 0 );
+  assert( r->map_addr == NULL && r->cnt == m->cnt+1 );
+  bcp_DeleteBCL(q, r);
+  bcp_Delete(q);
+
+  r = bcp_NewBCLByBinaryFile(p, name);
+  assert( r != NULL && bcp_IsBCLEqual(p, m, r) );
+  bcp_DeleteBCL(p, r);
+  bcp_StartBCLArenaFrame(p);
+  r = bcp_NewBCLByBinaryFile(p, name);  // arena lists are copied
+  assert( r != NULL && r->map_addr == NULL && bcp_IsBCLEqual(p, m, r) );
+  bcp_DeleteBCL(p, r);
+  bcp_EndBCLArenaFrame(p);
+
+  is_ok = truncate(name, 100) == 0;
+  assert( is_ok );
+  r = bcp_NewBCLByBinaryFile(p, name);
+  assert( r == NULL );
+  fp = fopen(name, "w");
+  assert( fp != NULL );
+  fputs("p cnf 3 1\n1 2 0\n", fp);
+  fclose(fp);
+  q = bcp_NewByBinaryFile(name);
+  assert( q == NULL );
+  unlink(name);
+
+  bcp_DeleteBCL(p, l);
+  bcp_DeleteBCL(p, m);
+  bcp_Delete(p);
+}
+
+/* compare the string conversion of bcube.c with a char by char conversion */
+void stringConversionTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  char *s = (char *)malloc(2*var_cnt+8);
+  char *t = (char *)malloc(var_cnt+1);
+  const char *ptr;
+  bc c;
+  int i, j, pos, is_ok;
+
+  printf("string conversion test, var_cnt=%d\n", var_cnt);
+  assert( s != NULL && t != NULL );
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  for( i = 0; i < 50; i++ )
+  {
+    for( j = 0; j < var_cnt; j++ )
+      s[j] = "x01-"[rand() & 3];
+    s[var_cnt] = '\0';
+    bcp_SetCubeByString(p, c, s);
+    for( j = 0; j < var_cnt; j++ )
+      assert( bcp_GetCubeVar(p, c, j) == (unsigned)(strchr("x01-", s[j]) - "x01-") );
+    bcp_GetStringFromCubeBuffer(p, c, t);       // "t" is also used below
+    assert( strcmp(t, s) == 0 );
+    assert( strcmp(bcp_GetStringFromCube(p, c), s) == 0 );
+
+    /* white space inside the cube and a short line: the missing variables are don't care */
+    pos = rand() % var_cnt;
+    memmove(s + pos + 1, s + pos, var_cnt - pos + 1);
+    s[pos] = (i & 1) ? ' ' : '\t';
+    bcp_SetCubeByString(p, c, s);
+    assert( strcmp(bcp_GetStringFromCube(p, c), t) == 0 );
+    s[pos] = '\n';
+    ptr = s;
+    bcp_SetCubeByStringPointer(p, c, &ptr);
+    assert( ptr == s + pos );
+    for( j = 0; j < var_cnt; j++ )
+      assert( bcp_GetCubeVar(p, c, j) == (j < pos ? (unsigned)(strchr("x01-", t[j]) - "x01-") : 3) );
+  }
+  bcp_EndCubeStackFrame(p);
+
+  /* two lines, the second with unknown chars, which are don't care */
+  for( j = 0; j < var_cnt; j++ )
+  {
+    s[j] = "01"[j & 1];
+    s[var_cnt+1+j] = "0a"[j & 1];
+  }
+  s[var_cnt] = '\n';
+  s[2*var_cnt+1] = '\0';
+  is_ok = bcp_AddBCLCubesByString(p, l, s);
+  assert( is_ok != 0 );
+  assert( l->cnt == 2 );
+  for( j = 0; j < var_cnt; j++ )
+  {
+    assert( bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, 0), j) == (unsigned)(1 + (j & 1)) );
+    assert( bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, 1), j) == (unsigned)(1 + 2*(j & 1)) );
+  }
+  free(s);
+  free(t);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* compare bcp_GetExpressionBCL() and bcp_WriteExpressionBCL() with a variable by variable conversion */
+void expressionOutputTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  char var_name[16];
+  char *expr, *ref, *t, *file_expr;
+  FILE *fp;
+  long len;
+  int i, j, v, pos, is_first, is_ok;
+
+  printf("expression output test, var_cnt=%d\n", var_cnt);
+  for( i = 0; i < var_cnt; i++ )
+  {
+    sprintf(var_name, i % 3 ? "v%d" : "long_name_%d", i);
+    is_ok = bcp_AddVar(p, var_name);
+    assert( is_ok != 0 );
+  }
+  for( i = 0; i < 60; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    if ( i > 0 )                // the first cube is the universal cube
+      bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), i % 10 ? 80 : 99);
+  }
+
+  ref = (char *)malloc((size_t)l->cnt*(var_cnt*20+2));
+  assert( ref != NULL );
+  t = ref;
+  is_ok = bcp_BuildVarList(p);
+  assert( is_ok != 0 );
+  for( i = 0; i < l->cnt; i++ )
+  {
+    if ( i > 0 )
+      *t++ = '|';
+    is_first = 1;
+    for( j = 0; j < var_cnt; j++ )
+    {
+      v = bcp_GetCubeVar(p, bcp_GetBCLCube(p, l, i), j);
+      if ( v == 1 || v == 2 )
+      {
+        t += sprintf(t, "%s%s%s", is_first ? "" : "&", v == 1 ? "-" : "", coStrGet(coVectorGet(p->var_list, j)));
+        is_first = 0;
+      }
+    }
+    if ( is_first )
+      *t++ = '1';
+  }
+  *t = '\0';
+
+  expr = bcp_GetExpressionBCL(p, l);
+  assert( expr != NULL && strcmp(expr, ref) == 0 );
+
+  fp = tmpfile();
+  assert( fp != NULL );
+  is_ok = bcp_WriteExpressionBCL(p, l, fp);
+  assert( is_ok != 0 );
+  len = ftell(fp);
+  assert( len == (long)strlen(ref) );
+  rewind(fp);
+  file_expr = (char *)malloc(len+1);
+  assert( file_expr != NULL );
+  is_ok = fread(file_expr, 1, len, fp) == (size_t)len;
+  assert( is_ok );
+  file_expr[len] = '\0';
+  assert( strcmp(file_expr, ref) == 0 );
+  fclose(fp);
+  free(file_expr);
+  free(expr);
+
+  bcp_ClearBCL(p, l);
+  expr = bcp_GetExpressionBCL(p, l);
+  assert( expr != NULL && expr[0] == '\0' );
+  free(expr);
+
+  free(ref);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* the expanded list must be equal to the original list and each cube must be prime */
+void expandTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl off, e;
+  bc c;
+  int i, v, code, pos;
+
+  printf("expand test, var_cnt=%d", var_cnt);
+  for( i = 0; i < 2*var_cnt; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 50);
+  }
+  off = bcp_NewBCLComplement(p, l);
+  e = bcp_NewBCLByBCL(p, l);
+  assert( off != NULL && e != NULL );
+  bcp_DoBCLExpandWithOffSet(p, e, off);
+  printf(", cnt=%d, off cnt=%d, expand cnt=%d\n", l->cnt, off->cnt, e->cnt);
+  assert( e->cnt <= l->cnt );
+  assert( bcp_IsBCLEqual(p, l, e) );
+  for( i = 0; i < e->cnt; i++ )
+  {
+    c = bcp_GetBCLCube(p, e, i);
+    for( v = 0; v < var_cnt; v++ )
+    {
+      code = bcp_GetCubeVar(p, c, v);
+      if ( code == 3 )
+        continue;
+      bcp_SetCubeVar(p, c, v, 3);
+      assert( bcp_IsBCLCubeCovered(p, l, c) == 0 );      // the cube is prime
+      bcp_SetCubeVar(p, c, v, code);
+    }
+  }
+  bcp_DeleteBCL(p, e);
+  bcp_DeleteBCL(p, off);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* reduce and the minimize loop must not change the function, the loop must not be worse than a single pass */
+void reduceMinimizeTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl l = bcp_NewBCL(p);
+  bcl r, m, s;
+  int i, pos, is_ok;
+
+  printf("reduce minimize test, var_cnt=%d", var_cnt);
+  for( i = 0; i < 3*var_cnt; i++ )
+  {
+    pos = bcp_AddBCLCube(p, l);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, l, pos), 55);
+  }
+  r = bcp_NewBCLByBCL(p, l);
+  m = bcp_NewBCLByBCL(p, l);
+  s = bcp_NewBCLByBCL(p, l);
+  assert( r != NULL && m != NULL && s != NULL );
+  
+  is_ok = bcp_DoBCLReduce(p, r);
+  assert( is_ok != 0 );
+  assert( r->cnt <= l->cnt );
+  assert( bcp_IsBCLEqual(p, l, r) );
+  
+  bcp_MinimizeBCLWithOffSet(p, s);
+  is_ok = bcp_MinimizeBCLWithBudget(p, m, 0, 0);
+  assert( is_ok != 0 );
+  printf(", cnt=%d, reduce cnt=%d, single pass cnt=%d, loop cnt=%d\n", l->cnt, r->cnt, s->cnt, m->cnt);
+  assert( m->cnt <= s->cnt );
+  assert( bcp_IsBCLEqual(p, l, m) );
+
+  bcp_DeleteBCL(p, s);
+  bcp_DeleteBCL(p, m);
+  bcp_DeleteBCL(p, r);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+
+  /* a cover, for which the single pass stops at 5 cubes, the reduce/expand loop finds a cover with 4 cubes */
+  p = bcp_New(5);
+  l = bcp_NewBCL(p);
+  bcp_AddBCLCubesByString(p, l, "100-1\n1-01-\n1-110\n00---\n-1-0-\n");
+  m = bcp_NewBCLByBCL(p, l);
+  s = bcp_NewBCLByBCL(p, l);
+  assert( m != NULL && s != NULL );
+  bcp_MinimizeBCLWithOffSet(p, s);
+  is_ok = bcp_MinimizeBCLWithBudget(p, m, 0, 0);
+  assert( is_ok != 0 );
+  assert( s->cnt == 5 );
+  assert( m->cnt == 4 );
+  assert( bcp_IsBCLEqual(p, l, s) );
+  assert( bcp_IsBCLEqual(p, l, m) );
+  bcp_DeleteBCL(p, s);
+  bcp_DeleteBCL(p, m);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+}
+
+/* compare bcp_IntersectionBCLs() with the intersection of all pairs, the result must have the SCC property */
+void intersectionTest(int var_cnt)
+{
+  bcp p = bcp_New(var_cnt);
+  bcl a = bcp_NewBCL(p);
+  bcl b = bcp_NewBCL(p);
+  bcl r = bcp_NewBCL(p);
+  bcl n = bcp_NewBCL(p);
+  bc c;
+  int i, j, pos, is_ok;
+
+  printf("intersection test, var_cnt=%d", var_cnt);
+  for( i = 0; i < 200; i++ )
+  {
+    pos = bcp_AddBCLCube(p, a);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, a, pos), 70);
+  }
+  for( i = 0; i < 30; i++ )
+  {
+    pos = bcp_AddBCLCube(p, b);
+    bcp_SetRandomCube(p, bcp_GetBCLCube(p, b, pos), 60);
+  }
+  
+  bcp_StartCubeStackFrame(p);
+  c = bcp_GetTempCube(p);
+  for( i = 0; i < a->cnt; i++ )
+    for( j = 0; j < b->cnt; j++ )
+      if ( bcp_IntersectionCube(p, c, bcp_GetBCLCube(p, a, i), bcp_GetBCLCube(p, b, j)) )
+      {
+        pos = bcp_AddBCLCubeByCube(p, n, c);
+        assert( pos >= 0 );
+      }
+  bcp_EndCubeStackFrame(p);
+  bcp_DoBCLSingleCubeContainment(p, n);
+  
+  is_ok = bcp_IntersectionBCLs(p, r, a, b);
+  assert( is_ok != 0 );
+  printf(", result cnt=%d, pairs cnt=%d\n", r->cnt, n->cnt);
+  assert( r->cnt == n->cnt );
+  assert( bcp_IsBCLEqual(p, r, n) );
+  for( i = 0; i < r->cnt; i++ )
+    for( j = 0; j < r->cnt; j++ )
+      if ( i != j )
+        assert( bcp_IsSubsetCube(p, bcp_GetBCLCube(p, r, i), bcp_GetBCLCube(p, r, j)) == 0 );
+  
+  is_ok = bcp_IntersectionBCLs(p, r, b, a);      // same result with exchanged arguments
+  assert( is_ok != 0 );
+  assert( r->cnt == n->cnt );
+  
+  bcp_DeleteBCL(p, n);
+  bcp_DeleteBCL(p, r);
+  bcp_DeleteBCL(p, b);
+  bcp_DeleteBCL(p, a);
+  bcp_Delete(p);
+}
@@ -0,0 +1,241 @@
+/*
+
+  bcserver.c
+  
+  persistent server mode for the json commands (see bcjson.c)
+
+  The server reads one request per line from "in" and writes one response line to "out".
+  Each request uses a named problem. A problem together with its slots is kept from one request 
+  to the next, so the base covers have to be parsed only once.
+  "in" and "out" can be any stream, e.g. stdin/stdout or a connected UNIX socket (fdopen()).
+
+  request:
+    {
+      problem:"",
+      cmd:[ ... ],
+      delete:1
+    }
+    
+    problem
+      Name of the problem, defaults to "". The problem is created by the first request with this name.
+      All variables of the problem must be known with the first request.
+
+    cmd
+      The vector with the command maps, as described in bcjson.c.
+      
+    delete
+      Delete the problem after the execution of "cmd", if the value is not 0.
+      
+    A request, which is a vector, is executed with the problem "".
+
+  response:
+    {
+      problem:"",
+      result:{ ... },
+      error:""
+    }
+    
+    result
+      The label output of the commands of the request, see bcjson.c
+  
+    error
+      Only present if the request or one of its commands could not be executed.
+      A command with an invalid bcl or an empty argument slot is skipped, the other
+      commands of the request are executed and the problem is kept.
+
+  The server terminates at the end of "in" or with the request {"quit":1}.
+  A "quit" member with the value 0 is ignored.
+  
+*/
+
+#include "co.h"
+#include "bc.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <assert.h>
+
+struct bc_server_problem_struct
+{
+  char *name;
+  bcj j;
+};
+
+struct bc_server_struct
+{
+  struct bc_server_problem_struct *list;
+  int cnt;
+  int max;
+  int slot_cnt;
+  int thread_cnt;
+};
+
+/* returns the position of the problem "name" or -1 */
+static int bc_FindServerProblem(struct bc_server_struct *s, const char *name)
+{
+  int i;
+  for( i = 0; i < s->cnt; i++ )
+    if ( strcmp(s->list[i].name, name) == 0 )
+      return i;
+  return -1;
+}
+
+/* returns the position of the problem "name", the problem is created if required, -1 for memory error */
+static int bc_GetServerProblem(struct bc_server_struct *s, const char *name)
+{
+  struct bc_server_problem_struct *list;
+  int pos = bc_FindServerProblem(s, name);
+  if ( pos >= 0 )
+    return pos;
+  if ( s->cnt >= s->max )
+  {
+    list = (struct bc_server_problem_struct *)realloc(s->list, (s->max*2+4)*sizeof(struct bc_server_problem_struct));
+    if ( list == NULL )
+      return -1;
+    s->list = list;
+    s->max = s->max*2+4;
+  }
+  s->list[s->cnt].name = strdup(name);
+  if ( s->list[s->cnt].name == NULL )
+    return -1;
+  s->list[s->cnt].j = bc_NewBCJ(s->slot_cnt);
+  if ( s->list[s->cnt].j == NULL )
+    return free(s->list[s->cnt].name), -1;
+  return s->cnt++;
+}
+
+static void bc_DeleteServerProblem(struct bc_server_struct *s, int pos)
+{
+  bc_DeleteBCJ(s->list[pos].j);
+  free(s->list[pos].name);
+  s->cnt--;
+  s->list[pos] = s->list[s->cnt];
+}
+
+/* returns 1 if the member "key" of the request map "req" is a number other than 0 */
+static int bc_IsServerRequestFlag(cco req, const char *key)
+{
+  cco o = coMapGet(req, key);
+  return coIsDbl(o) && coDblGet(o) != 0.0;
+}
+
+/* execute one request, returns the response map */
+static co bc_ExecuteServerRequest(struct bc_server_struct *s, cco req)
+{
+  const char *name = "";
+  cco cmd = req;
+  cco o;
+  co result;
+  char error[64];
+  int pos;
+  co resp = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+  assert( resp != NULL );
+  
+  if ( coIsMap(req) )
+  {
+    o = coMapGet(req, "problem");
+    if ( coIsStr(o) )
+      name = coStrGet(o);
+    cmd = coMapGet(req, "cmd");
+  }
+  else if ( coIsVector(req) == 0 )
+  {
+    coMapAdd(resp, "error", coNewStr(CO_STRDUP, "request must be a map or a vector"));
+    return resp;
+  }
+  coMapAdd(resp, "problem", coNewStr(CO_STRDUP, name));
+  
+  pos = bc_GetServerProblem(s, name);
+  if ( pos < 0 )
+  {
+    coMapAdd(resp, "error", coNewStr(CO_STRDUP, "memory error"));
+    return resp;
+  }
+  if ( coIsVector(cmd) )
+  {
+    result = bc_ExecuteBCJ(s->list[pos].j, cmd, s->thread_cnt);
+    if ( result == NULL )
+    {
+      coMapAdd(resp, "error", coNewStr(CO_STRDUP, "memory error"));
+    }
+    else
+    {
+      coMapAdd(resp, "result", result);
+      if ( s->list[pos].j->error != NULL )
+      {
+        snprintf(error, sizeof(error), "cmd %ld: %s", s->list[pos].j->error_idx, s->list[pos].j->error);
+        coMapAdd(resp, "error", coNewStr(CO_STRDUP, error));
+      }
+    }
+  }
+  if ( coIsMap(req) && bc_IsServerRequestFlag(req, "delete") )
+    bc_DeleteServerProblem(s, pos);
+  return resp;
+}
+
+/*
+  read requests from "in" and write the responses to "out" until the end of "in"
+  returns 0 if a request line could not be read
+*/
+int bc_ExecuteServer(FILE *in, FILE *out, int slot_cnt, int thread_cnt)
+{
+  struct bc_server_struct s;
+  char *line = NULL;
+  size_t line_size = 0;
+  ssize_t len;
+  FILE *fp;
+  co req;
+  co resp;
+  int is_quit = 0;
+  int is_ok = 1;
+  
+  s.list = NULL;
+  s.cnt = 0;
+  s.max = 0;
+  s.slot_cnt = slot_cnt;
+  s.thread_cnt = thread_cnt;
+  
+  while( is_quit == 0 && (len = getline(&line, &line_size, in)) >= 0 )
+  {
+    if ( strspn(line, " \t\r\n") == (size_t)len )
+      continue;         // empty line
+    fp = fmemopen(line, len, "r");
+    if ( fp == NULL )
+    {
+      is_ok = 0;
+      break;
+    }
+    req = coReadJSONByFP(fp);
+    fclose(fp);
+    if ( req == NULL )
+    {
+      resp = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+      assert( resp != NULL );
+      coMapAdd(resp, "error", coNewStr(CO_STRDUP, "JSON read error"));
+    }
+    else if ( coIsMap(req) && bc_IsServerRequestFlag(req, "quit") )
+    {
+      is_quit = 1;
+      resp = NULL;
+    }
+    else
+    {
+      resp = bc_ExecuteServerRequest(&s, req);
+    }
+    if ( resp != NULL )
+    {
+      coWriteJSON(resp, 1, 1, out);     // compact output: one response per line
+      fputc('\n', out);
+      fflush(out);
+      coDelete(resp);
+    }
+    if ( req != NULL )
+      coDelete(req);
+  }
+  
+  free(line);
+  while( s.cnt > 0 )
+    bc_DeleteServerProblem(&s, s.cnt-1);
+  free(s.list);
+  return is_ok;
+}
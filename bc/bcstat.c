@@ -0,0 +1,152 @@
+/*
+
+  bcstat.c
+  
+  execution statistics of a context
+
+  The counters are part of each context (struct bcp_stat_struct in bc.h), so they can be 
+  updated without any synchronization. bcp_Delete() adds the statistics of a context to the
+  problem, so after all worker contexts are deleted, the problem contains the totals.
+  Compile with -DBCP_STAT=0 to remove all counter updates.
+
+*/
+
+#include "co.h"
+#include "bc.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static const char *bcp_stat_name[BCP_STAT_CNT] = 
+{
+  "intersection_cube",
+  "is_intersection_cube",
+  "is_subset_cube",
+  "cube_delta",
+  "or_bit_cnt",
+  "slice_query",
+  "tautology_node",
+  "partition",
+  "cofactor_cube",
+  "scc_removed",
+  "mcc_removed"
+};
+
+static const char *bcp_stat_op_name[BCP_STAT_OP_CNT] = 
+{
+  "tautology",
+  "subset",
+  "subtract",
+  "intersection",
+  "complement",
+  "minimize"
+};
+
+static const char *bcp_stat_leaf_name[BCP_TAUTOLOGY_LEAF_CNT] = 
+{
+  "universal",
+  "literal",
+  "minterm",
+  "truth_table"
+};
+
+/* monotonic wall clock time in seconds */
+double bcp_GetStatTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* clear the statistics and the tautology leaf counters of the context */
+void bcp_ClearStat(bcp p)
+{
+  memset(&(p->stat), 0, sizeof(struct bcp_stat_struct));
+  memset(p->tautology_leaf_cnt, 0, sizeof(p->tautology_leaf_cnt));
+}
+
+/* add the statistics of context "c" to "p" */
+void bcp_AddStatByContext(bcp p, bcp c)
+{
+  int i;
+  for( i = 0; i < BCP_STAT_CNT; i++ )
+    p->stat.cnt[i] += c->stat.cnt[i];
+  for( i = 0; i < BCP_TAUTOLOGY_LEAF_CNT; i++ )
+    p->tautology_leaf_cnt[i] += c->tautology_leaf_cnt[i];
+  if ( p->stat.tautology_max_depth < c->stat.tautology_max_depth )
+    p->stat.tautology_max_depth = c->stat.tautology_max_depth;
+  for( i = 0; i < BCP_STAT_OP_CNT; i++ )
+  {
+    p->stat.op_cnt[i] += c->stat.op_cnt[i];
+    p->stat.op_time[i] += c->stat.op_time[i];
+  }
+}
+
+/* start the wall time of operation "op", a nested call of the same operation is ignored */
+void bcp_StartStatOpTimer(bcp p, int op)
+{
+  if ( p->stat.op_depth[op]++ == 0 )
+    p->stat.op_start[op] = bcp_GetStatTime();
+}
+
+void bcp_EndStatOpTimer(bcp p, int op)
+{
+  if ( --p->stat.op_depth[op] == 0 )
+  {
+    p->stat.op_cnt[op]++;
+    p->stat.op_time[op] += bcp_GetStatTime() - p->stat.op_start[op];
+  }
+}
+
+void bcp_ShowStat(bcp p)
+{
+  int i;
+  for( i = 0; i < BCP_STAT_CNT; i++ )
+    printf("stat %s=%ld\n", bcp_stat_name[i], p->stat.cnt[i]);
+  printf("stat tautology_max_depth=%d\n", p->stat.tautology_max_depth);
+  for( i = 0; i < BCP_TAUTOLOGY_LEAF_CNT; i++ )
+    printf("stat leaf_%s=%ld\n", bcp_stat_leaf_name[i], p->tautology_leaf_cnt[i]);
+  for( i = 0; i < BCP_STAT_OP_CNT; i++ )
+    if ( p->stat.op_cnt[i] > 0 )
+      printf("stat op %s: cnt=%ld time=%.6f\n", bcp_stat_op_name[i], p->stat.op_cnt[i], p->stat.op_time[i]);
+}
+
+/*
+  create a map with all statistics, operations, which were not called, are not part of the map:
+  { "is_subset_cube":25, ..., "leaf":{ "universal":0, ... }, "op":{ "tautology":{ "cnt":1, "time":0.01 }, ... } }
+  returns NULL for memory error
+*/
+co bcp_NewStatMap(bcp p)
+{
+  int i;
+  co leaf, op, e;
+  co m = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+  if ( m == NULL )
+    return NULL;
+  for( i = 0; i < BCP_STAT_CNT; i++ )
+    coMapAdd(m, bcp_stat_name[i], coNewDbl(p->stat.cnt[i]));
+  coMapAdd(m, "tautology_max_depth", coNewDbl(p->stat.tautology_max_depth));
+  leaf = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+  if ( leaf == NULL )
+    return coDelete(m), NULL;
+  for( i = 0; i < BCP_TAUTOLOGY_LEAF_CNT; i++ )
+    coMapAdd(leaf, bcp_stat_leaf_name[i], coNewDbl(p->tautology_leaf_cnt[i]));
+  coMapAdd(m, "leaf", leaf);
+  op = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+  if ( op == NULL )
+    return coDelete(m), NULL;
+  for( i = 0; i < BCP_STAT_OP_CNT; i++ )
+  {
+    if ( p->stat.op_cnt[i] > 0 )
+    {
+      e = coNewMap(CO_STRDUP|CO_STRFREE|CO_FREE_VALS);
+      if ( e == NULL )
+        return coDelete(op), coDelete(m), NULL;
+      coMapAdd(e, "cnt", coNewDbl(p->stat.op_cnt[i]));
+      coMapAdd(e, "time", coNewDbl(p->stat.op_time[i]));
+      coMapAdd(op, bcp_stat_op_name[i], e);
+    }
+  }
+  coMapAdd(m, "op", op);
+  return m;
+}
@@ -51,36 +51,126 @@ unsigned bcp_GetCubeVar(bcp p, bc c, unsigned var_pos)
   ((((uint16_t *)(c))[(var_pos)/8] >> (((var_pos)&7)*2)) & 3)
 */
 
-const char *bcp_GetStringFromCube(bcp p, bc c)
+/*
+  convert one block (64 variables) into 64 chars, SSSE3 version
+  Each byte of the cube contains 4 variables. The low and the high nibble of each byte are used 
+  as index into two lookup tables (pshufb): one table for the lower and one for the upper variable of the nibble.
+  The four resulting char vectors are interleaved with unpack operations.
+*/
+__attribute__ ((target("ssse3")))
+static void bcp_GetStringFromBlockSSSE3(const __m128i *b, char *s)
+{
+  const __m128i t0 = _mm_setr_epi8('x','0','1','-', 'x','0','1','-', 'x','0','1','-', 'x','0','1','-');
+  const __m128i t1 = _mm_setr_epi8('x','x','x','x', '0','0','0','0', '1','1','1','1', '-','-','-','-');
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  __m128i x = _mm_loadu_si128(b);
+  __m128i lo = _mm_and_si128(x, nibble);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+  __m128i c0 = _mm_shuffle_epi8(t0, lo);        // variable 4*i
+  __m128i c1 = _mm_shuffle_epi8(t1, lo);        // variable 4*i+1
+  __m128i c2 = _mm_shuffle_epi8(t0, hi);        // variable 4*i+2
+  __m128i c3 = _mm_shuffle_epi8(t1, hi);        // variable 4*i+3
+  __m128i c01, c23;
+  c01 = _mm_unpacklo_epi8(c0, c1);
+  c23 = _mm_unpacklo_epi8(c2, c3);
+  _mm_storeu_si128((__m128i *)s, _mm_unpacklo_epi16(c01, c23));
+  _mm_storeu_si128((__m128i *)(s+16), _mm_unpackhi_epi16(c01, c23));
+  c01 = _mm_unpackhi_epi8(c0, c1);
+  c23 = _mm_unpackhi_epi8(c2, c3);
+  _mm_storeu_si128((__m128i *)(s+32), _mm_unpacklo_epi16(c01, c23));
+  _mm_storeu_si128((__m128i *)(s+48), _mm_unpackhi_epi16(c01, c23));
+}
+
+/*
+  write the visual representation of "c" into "s", which must have space for p->var_cnt+1 chars
+  This function is MT-safe, returns "s"
+*/
+char *bcp_GetStringFromCubeBuffer(bcp p, bc c, char *s)
 {
   int i, var_cnt = p->var_cnt;
-  char *s = p->cube_to_str; 
-  for( i = 0; i < var_cnt; i++ )
+  char tail[64];
+  if ( __builtin_cpu_supports("ssse3") )
   {
-    s[i] = "x01-"[bcp_GetCubeVar(p, c, i)];
+    for( i = 0; i + 64 <= var_cnt; i += 64 )
+      bcp_GetStringFromBlockSSSE3(c + i/64, s + i);
+    if ( i < var_cnt )
+    {
+      bcp_GetStringFromBlockSSSE3(c + i/64, tail);
+      memcpy(s + i, tail, var_cnt - i);
+    }
+  }
+  else
+  {
+    for( i = 0; i < var_cnt; i++ )
+      s[i] = "x01-"[bcp_GetCubeVar(p, c, i)];
   }
   s[var_cnt] = '\0';
   return s;
 }
 
+/* the result is stored in the string buffer of the context and is valid until the next call */
+const char *bcp_GetStringFromCube(bcp p, bc c)
+{
+  return bcp_GetStringFromCubeBuffer(p, c, p->cube_to_str);
+}
+
 
+/*
+  convert 16 chars into 16 variables (4 bytes of the cube), SSSE3 version
+  returns 0 if any of the chars is white space, a line end or the end of the string,
+  in this case the chars must be processed one by one.
+*/
+__attribute__ ((target("ssse3")))
+static int bcp_SetBlockByStringSSSE3(uint8_t *c, const char *s)
+{
+  __m128i x = _mm_loadu_si128((const __m128i *)s);
+  __m128i code;
+  uint32_t v;
+  if ( _mm_movemask_epi8(_mm_cmpgt_epi8(x, _mm_set1_epi8(' '))) != 0xffff )
+    return 0;
+  /* '0' --> 1, '1' --> 2, 'x' --> 0, all other chars --> 3 */
+  code = _mm_set1_epi8(3);
+  code = _mm_xor_si128(code, _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('0')), _mm_set1_epi8(2)));
+  code = _mm_xor_si128(code, _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('1')), _mm_set1_epi8(1)));
+  code = _mm_xor_si128(code, _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('x')), _mm_set1_epi8(3)));
+  /* combine 2 codes into 4 bits, 4 codes into 8 bits and pack the bytes */
+  code = _mm_maddubs_epi16(code, _mm_set1_epi16(0x0401));
+  code = _mm_madd_epi16(code, _mm_set1_epi32(0x00100001));
+  code = _mm_packs_epi32(code, code);
+  code = _mm_packus_epi16(code, code);
+  v = (uint32_t)_mm_cvtsi128_si32(code);
+  memcpy(c, &v, sizeof(uint32_t));
+  return 1;
+}
 
 /*
   use string "s" to fill the content of cube "c"
     '0' --> bit value 01
     '1' --> bit value 10
     '-' --> bit value 11
-    'x' (or any other char > 32 --> bit value "00" (which is the illegal value)
+    'x' --> bit value "00" (which is the illegal value)
+    any other char > 32 --> bit value 11
     ' ', '\t' --> ignored
-    '\0', '\r', '\n' --> reading from "s" will stop
-  
+    '\0', '\r', '\n' --> reading from "s" will stop, the remaining variables are don't care
+  "end" must point to the terminating '\0' of the string, it is used to find out, whether 
+  16 chars can be converted at once.
 */
-void bcp_SetCubeByStringPointer(bcp p, bc c,  const char **s)
+void bcp_SetCubeByStringRange(bcp p, bc c, const char **s, const char *end)
 {
-  int i, var_cnt = p->var_cnt;
+  int i = 0, var_cnt = p->var_cnt;
+  int is_ssse3 = __builtin_cpu_supports("ssse3");
   unsigned v;
-  for( i = 0; i < var_cnt; i++ )
+  while( i < var_cnt )
   {
+    if ( is_ssse3 && (i & 15) == 0 && i + 16 <= var_cnt && end - *s >= 16 )
+    {
+      if ( bcp_SetBlockByStringSSSE3((uint8_t *)c + i/4, *s) )
+      {
+        *s += 16;
+        i += 16;
+        continue;
+      }
+    }
     while( **s == ' ' || **s == '\t' )            // skip white space
       (*s)++;
     if ( **s == '0' ) { v = 1; }
@@ -91,9 +181,15 @@ void bcp_SetCubeByStringPointer(bcp p, bc c,  const char **s)
     if ( **s != '\0' && **s != '\r' && **s != '\n' )       // stop looking at further chars if the line/string ends
       (*s)++;
     bcp_SetCubeVar(p, c, i, v);
+    i++;
   }
 }
 
+void bcp_SetCubeByStringPointer(bcp p, bc c,  const char **s)
+{
+  bcp_SetCubeByStringRange(p, c, s, *s + strlen(*s));
+}
+
 void bcp_SetCubeByString(bcp p, bc c, const char *s)
 {
   bcp_SetCubeByStringPointer(p, c, &s);
@@ -118,7 +214,7 @@ int bcp_IsTautologyCube(bcp p, bc c)
   calculate intersection of a and b, result is stored in r
   return 0, if there is no intersection
 */
-int bcp_IntersectionCube(bcp p, bc r, bc a, bc b)
+static int bcp_IntersectionCubeSSE2(bcp p, bc r, bc a, bc b)
 {
   int i, cnt = p->blk_cnt;
   __m128i z = _mm_loadu_si128(bcp_GetBCLCube(p, p->global_cube_list, 1));
@@ -191,7 +287,7 @@ int bcp_IsAndZero(bcp p, bc a, bc b)
 /*
   do a bitwise or and return the number of bits in the result;
 */
-unsigned bcp_OrBitCnt(bcp p, bc r, bc a, bc b)
+static unsigned bcp_OrBitCntSSE2(bcp p, bc r, bc a, bc b)
 {
   int i, cnt = p->blk_cnt;
   __m128i rr;
@@ -207,7 +303,7 @@ unsigned bcp_OrBitCnt(bcp p, bc r, bc a, bc b)
   return bitcnt;
 }
 
-int bcp_IsIntersectionCube(bcp p, bc a, bc b)
+static int bcp_IsIntersectionCubeSSE2(bcp p, bc a, bc b)
 {
   int i, cnt = p->blk_cnt;
   __m128i z = _mm_loadu_si128(bcp_GetBCLCube(p, p->global_cube_list, 1));
@@ -272,7 +368,22 @@ int bcp_GetCubeVariableCount(bcp p, bc cube)
   return delta;
 }
 
-int bcp_GetCubeDelta(bcp p, bc a, bc b)
+/*
+  fold the inverted cube into 64 bits, all blocks are used (like the kernels above)
+  if "b" is a subset of "a", then a&~b is zero for all bits, so the signature of "a" is a subset of the signature of "b".
+  if a&b contains a 00 code, then the signature of a|b contains a 11 code.
+*/
+uint64_t bcp_GetCubeSignature(bcp p, bc c)
+{
+  const uint64_t *w = (const uint64_t *)c;
+  int i, cnt = p->blk_cnt*2;
+  uint64_t s = 0;
+  for( i = 0; i < cnt; i++ )
+    s |= ~w[i];
+  return s;
+}
+
+static int bcp_GetCubeDeltaSSE2(bcp p, bc a, bc b)
 {
   int i, cnt = p->blk_cnt;
   int delta = 0;
@@ -299,7 +410,7 @@ int bcp_GetCubeDelta(bcp p, bc a, bc b)
     1: yes, "b" is a subset of "a"
     0: no, "b" is not a subset of "a"
 */
-int bcp_IsSubsetCube(bcp p, bc a, bc b)
+static int bcp_IsSubsetCubeSSE2(bcp p, bc a, bc b)
 {
   int i;
   __m128i bb;
@@ -313,3 +424,245 @@ int bcp_IsSubsetCube(bcp p, bc a, bc b)
   return 1;
 }
 
+
+/*============================================================*/
+/* 
+  AVX2 and AVX-512 versions of the above kernels 
+
+  The kernels are compiled with the gcc target attribute, so that no -march option is required.
+  bcp_SetCubeFunctions() will select the kernels according to p->simd_level.
+  Precondition: p->blk_cnt is a multiple of bcp_GetSIMDBlkCnt(p->simd_level), 
+  the additional blocks contain don't care values (see bcp_var_cnt_init).
+*/
+
+__attribute__ ((target("avx2")))
+static int bcp_IntersectionCubeAVX2(bcp p, bc r, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  __m256i z = _mm256_set1_epi8(0x55);
+  __m256i rr;
+  __m256i f = _mm256_setzero_si256();
+  for( i = 0; i < cnt; i+=2 )
+  {
+    rr = _mm256_and_si256(_mm256_loadu_si256((__m256i *)(a+i)), _mm256_loadu_si256((__m256i *)(b+i)));      // calculate the intersection
+    _mm256_storeu_si256((__m256i *)(r+i), rr);          // and store the intersection in the destination cube
+    f = _mm256_or_si256(f, _mm256_andnot_si256(_mm256_or_si256( rr, _mm256_srli_epi16(rr,1)), z));      // x0 --> 01: collect illegal variables
+  }
+  return _mm256_testz_si256(f, f);      // return 1 if there is no illegal variable
+}
+
+__attribute__ ((target("avx2")))
+static int bcp_IsIntersectionCubeAVX2(bcp p, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  __m256i z = _mm256_set1_epi8(0x55);
+  __m256i rr;
+  for( i = 0; i < cnt; i+=2 )
+  {
+    rr = _mm256_and_si256(_mm256_loadu_si256((__m256i *)(a+i)), _mm256_loadu_si256((__m256i *)(b+i)));      // calculate the intersection
+    rr = _mm256_andnot_si256(_mm256_or_si256( rr, _mm256_srli_epi16(rr,1)), z); // 01 for each illegal variable
+    if ( _mm256_testz_si256(rr, rr) == 0 )
+      return 0;
+  }
+  return 1;
+}
+
+__attribute__ ((target("avx2")))
+static int bcp_IsSubsetCubeAVX2(bcp p, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  for( i = 0; i < cnt; i+=2 )
+  {
+    /* a&b == b ? testc calculates ~a&b == 0 */
+    if ( _mm256_testc_si256(_mm256_loadu_si256((__m256i *)(a+i)), _mm256_loadu_si256((__m256i *)(b+i))) == 0 )
+      return 0;
+  }
+  return 1;
+}
+
+__attribute__ ((target("avx2,popcnt")))
+static int bcp_GetCubeDeltaAVX2(bcp p, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  int delta = 0;
+  __m256i zeromask = _mm256_set1_epi8(0x55);
+  __m256i c;
+  for( i = 0; i < cnt; i+=2 )
+  {
+    c = _mm256_and_si256(_mm256_loadu_si256((__m256i *)(a+i)), _mm256_loadu_si256((__m256i *)(b+i)));
+    c = _mm256_or_si256( c, _mm256_srli_epi16(c,1));
+    c = _mm256_andnot_si256(c, zeromask);
+    delta += __builtin_popcountll(_mm256_extract_epi64(c, 0));
+    delta += __builtin_popcountll(_mm256_extract_epi64(c, 1));
+    delta += __builtin_popcountll(_mm256_extract_epi64(c, 2));
+    delta += __builtin_popcountll(_mm256_extract_epi64(c, 3));
+  }
+  return delta;
+}
+
+__attribute__ ((target("avx2,popcnt")))
+static unsigned bcp_OrBitCntAVX2(bcp p, bc r, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  __m256i rr;
+  unsigned bitcnt = 0;
+  for( i = 0; i < cnt; i+=2 )
+  {
+    rr = _mm256_or_si256(_mm256_loadu_si256((__m256i *)(a+i)), _mm256_loadu_si256((__m256i *)(b+i)));
+    _mm256_storeu_si256((__m256i *)(r+i), rr);
+    bitcnt += __builtin_popcountll(_mm256_extract_epi64(rr, 0));
+    bitcnt += __builtin_popcountll(_mm256_extract_epi64(rr, 1));
+    bitcnt += __builtin_popcountll(_mm256_extract_epi64(rr, 2));
+    bitcnt += __builtin_popcountll(_mm256_extract_epi64(rr, 3));
+  }
+  return bitcnt;
+}
+
+/* 
+  AVX-512 versions: only AVX512F is required.
+  The 64 bit shift is ok here, because the bit, which is shifted across the 16 bit boundary, is masked out with 0x55
+*/
+
+__attribute__ ((target("avx512f")))
+static int bcp_IntersectionCubeAVX512(bcp p, bc r, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  __m512i z = _mm512_set1_epi8(0x55);
+  __m512i rr;
+  __m512i f = _mm512_setzero_si512();
+  for( i = 0; i < cnt; i+=4 )
+  {
+    rr = _mm512_and_si512(_mm512_loadu_si512(a+i), _mm512_loadu_si512(b+i));
+    _mm512_storeu_si512(r+i, rr);
+    f = _mm512_or_si512(f, _mm512_andnot_si512(_mm512_or_si512( rr, _mm512_srli_epi64(rr,1)), z));
+  }
+  return _mm512_test_epi64_mask(f, f) == 0;
+}
+
+__attribute__ ((target("avx512f")))
+static int bcp_IsIntersectionCubeAVX512(bcp p, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  __m512i z = _mm512_set1_epi8(0x55);
+  __m512i rr;
+  for( i = 0; i < cnt; i+=4 )
+  {
+    rr = _mm512_and_si512(_mm512_loadu_si512(a+i), _mm512_loadu_si512(b+i));
+    rr = _mm512_andnot_si512(_mm512_or_si512( rr, _mm512_srli_epi64(rr,1)), z);    // 01 for each illegal variable
+    if ( _mm512_test_epi64_mask(rr, rr) != 0 )
+      return 0;
+  }
+  return 1;
+}
+
+__attribute__ ((target("avx512f")))
+static int bcp_IsSubsetCubeAVX512(bcp p, bc a, bc b)
+{
+  int i, cnt = p->blk_cnt;
+  __m512i bb;
+  for( i = 0; i < cnt; i+=4 )
+  {
+    bb = _mm512_loadu_si512(b+i);
+    if ( _mm512_cmpneq_epi64_mask(_mm512_and_si512(_mm512_loadu_si512(a+i), bb), bb) != 0 )
+      return 0;
+  }
+  return 1;
+}
+
+__attribute__ ((target("avx512f,popcnt")))
+static int bcp_GetCubeDeltaAVX512(bcp p, bc a, bc b)
+{
+  int i, j, cnt = p->blk_cnt;
+  int delta = 0;
+  __m512i zeromask = _mm512_set1_epi8(0x55);
+  __m512i c;
+  uint64_t w[8];
+  for( i = 0; i < cnt; i+=4 )
+  {
+    c = _mm512_and_si512(_mm512_loadu_si512(a+i), _mm512_loadu_si512(b+i));
+    c = _mm512_andnot_si512(_mm512_or_si512( c, _mm512_srli_epi64(c,1)), zeromask);
+    if ( _mm512_test_epi64_mask(c, c) == 0 )
+      continue;         // no delta in these 256 variables
+    _mm512_storeu_si512(w, c);
+    for( j = 0; j < 8; j++ )
+      delta += __builtin_popcountll(w[j]);
+  }
+  return delta;
+}
+
+__attribute__ ((target("avx512f,popcnt")))
+static unsigned bcp_OrBitCntAVX512(bcp p, bc r, bc a, bc b)
+{
+  int i, j, cnt = p->blk_cnt;
+  __m512i rr;
+  unsigned bitcnt = 0;
+  uint64_t w[8];
+  for( i = 0; i < cnt; i+=4 )
+  {
+    rr = _mm512_or_si512(_mm512_loadu_si512(a+i), _mm512_loadu_si512(b+i));
+    _mm512_storeu_si512(r+i, rr);
+    _mm512_storeu_si512(w, rr);
+    for( j = 0; j < 8; j++ )
+      bitcnt += __builtin_popcountll(w[j]);
+  }
+  return bitcnt;
+}
+
+/*============================================================*/
+/* kernel selection */
+
+/* number of __m128i blocks, which are processed by one kernel loop for the given SIMD level */
+int bcp_GetSIMDBlkCnt(int simd_level)
+{
+  if ( simd_level == BCP_SIMD_AVX512 )
+    return 4;
+  if ( simd_level == BCP_SIMD_AVX2 )
+    return 2;
+  return 1;
+}
+
+/*
+  return the SIMD level for a cube with "blk_cnt" __m128i blocks.
+  The result is limited by the CPU (checked with CPUID) and BCP_SIMD_MAX_LEVEL.
+  A wider level is only used if the padding overhead is small: AVX2 for 2 or more blocks,
+  AVX-512 for 8 or more blocks or if blk_cnt is already a multiple of 4.
+*/
+int bcp_GetSIMDLevel(int blk_cnt)
+{
+  int level = BCP_SIMD_SSE2;
+  __builtin_cpu_init();
+  if ( BCP_SIMD_MAX_LEVEL >= BCP_SIMD_AVX2 && blk_cnt >= 2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt") )
+    level = BCP_SIMD_AVX2;
+  if ( BCP_SIMD_MAX_LEVEL >= BCP_SIMD_AVX512 && level == BCP_SIMD_AVX2 && (blk_cnt >= 8 || (blk_cnt % 4) == 0) && __builtin_cpu_supports("avx512f") )
+    level = BCP_SIMD_AVX512;
+  return level;
+}
+
+/* assign the cube kernels for p->simd_level, called by bcp_var_cnt_init() */
+void bcp_SetCubeFunctions(bcp p)
+{
+  switch(p->simd_level)
+  {
+    case BCP_SIMD_AVX512:
+      p->intersection_cube = bcp_IntersectionCubeAVX512;
+      p->is_intersection_cube = bcp_IsIntersectionCubeAVX512;
+      p->is_subset_cube = bcp_IsSubsetCubeAVX512;
+      p->get_cube_delta = bcp_GetCubeDeltaAVX512;
+      p->or_bit_cnt = bcp_OrBitCntAVX512;
+      break;
+    case BCP_SIMD_AVX2:
+      p->intersection_cube = bcp_IntersectionCubeAVX2;
+      p->is_intersection_cube = bcp_IsIntersectionCubeAVX2;
+      p->is_subset_cube = bcp_IsSubsetCubeAVX2;
+      p->get_cube_delta = bcp_GetCubeDeltaAVX2;
+      p->or_bit_cnt = bcp_OrBitCntAVX2;
+      break;
+    default:
+      p->intersection_cube = bcp_IntersectionCubeSSE2;
+      p->is_intersection_cube = bcp_IsIntersectionCubeSSE2;
+      p->is_subset_cube = bcp_IsSubsetCubeSSE2;
+      p->get_cube_delta = bcp_GetCubeDeltaSSE2;
+      p->or_bit_cnt = bcp_OrBitCntSSE2;
+      break;
+  }
+}
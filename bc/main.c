@@ -3,7 +3,9 @@
 #include <assert.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <sys/times.h>
+#include <unistd.h>
 
 /*============================================================*/
 
@@ -103,7 +105,7 @@ int main3(int argc, char **argv)
   fp = fopen(argv[1], "r");
   if ( fp == NULL )
     return perror(argv[1]), 0;
-  bc_ExecuteJSON(fp);
+  bc_ExecuteJSON(fp, BCJ_DEFAULT_SLOT_CNT, 1);
   fclose(fp);
   return 0;
 }
@@ -129,35 +131,65 @@ int main4()
 
 /*============================================================*/
 
+int json_slot_cnt = BCJ_DEFAULT_SLOT_CNT;       // -slotcnt
+int json_thread_cnt = 1;        // -threadcnt, default is the number of processors
+
+int bench_rep_cnt = BC_BENCH_DEFAULT_REP_CNT;  // -benchrep
+const char *bench_out_name = "-";               // -benchout
+const char *bench_baseline_name = NULL;         // -benchbaseline
+double bench_tolerance = BC_BENCH_DEFAULT_TOLERANCE;    // -benchtolerance
+
+int is_pla_output = 0;          // -pla: stdout is a PLA file, the user time is written as PLA comment
 
 int bc_ExecuteJSONFile(const char *jsonfilename)
 {
   FILE *fp = fopen(jsonfilename, "r");
   if ( fp == NULL )
     return perror(jsonfilename), 0;
-  bc_ExecuteJSON(fp);
+  bc_ExecuteJSON(fp, json_slot_cnt, json_thread_cnt);
   fclose(fp);
   return 1;
 }
 
 int bc_ExecuteDIMACSCNF(const char *dimacscnffilename)
 {
-  FILE *fp = fopen(dimacscnffilename, "r");
+  bcd d = bcp_NewBCDByName(dimacscnffilename);   // "-" reads from stdin
   bcp p;
   bcl l;
   int is_tautology;
-  if ( fp == NULL )
-    return perror(dimacscnffilename), 0;
+  if ( d == NULL )
+    return printf("DIMACS CNF read error (%s)\n", dimacscnffilename), 0;
   printf("DIMACS CNF read from %s\n", dimacscnffilename);
-  p = bcp_NewByDIMACSCNF(fp);
-  l = bcp_NewBCLByDIMACSCNF(p, fp);   // create a bcl from a DIMACS CNF
+  p = bcp_NewByBCD(d);
+  if ( p == NULL )
+    return bcp_DeleteBCD(d), 0;
+  l = bcp_NewBCLByBCD(p, d);   // create a bcl from a DIMACS CNF
+  bcp_DeleteBCD(d);
+  if ( l == NULL )
+    return puts("DIMACS CNF clause error"), bcp_Delete(p), 0;
   printf("DIMACS CNF with %d clauses\n", l->cnt);
   
   is_tautology = bcp_IsBCLTautology(p, l);
   printf("DIMACS CNF tautology=%d\n", is_tautology);
+  bcp_ShowStat(p);
 
-  
-  fclose(fp);
+  bcp_DeleteBCL(p, l);
+  bcp_Delete(p);
+  return 1;
+}
+
+/* minimize all outputs of a PLA and write the result to stdout, all other messages are PLA comments */
+int bc_ExecutePLA(const char *plafilename)
+{
+  bcf f = bcp_NewBCFByPLAName(plafilename);   // "-" reads from stdin
+  if ( f == NULL )
+    return printf("# PLA read error (%s)\n", plafilename), 0;
+  printf("# PLA read from %s, inputs=%d, outputs=%d, cubes=%d\n", plafilename, f->in_cnt, f->out_cnt, f->on->cnt);
+  if ( bcp_MinimizeBCF(f) == 0 )
+    puts("# PLA minimize memory error");
+  printf("# PLA minimized cubes=%d\n", f->on->cnt);
+  bcp_WriteBCFPLA(f, stdout);
+  bcp_DeleteBCF(f);
   return 1;
 }
 
@@ -166,7 +198,6 @@ int bc_ExecuteParse(const char *s)
   bcl l;
   bcp p = bcp_New(0);
   bcx x = bcp_Parse(p, s, 1);
-  char *expr;
     
   bcp_ShowBCX(p, x);
   puts("");
@@ -181,10 +212,9 @@ int bc_ExecuteParse(const char *s)
 
   bcp_ShowBCL(p, l);
  
-  expr = bcp_GetExpressionBCL(p, l);
-  puts(expr);
+  bcp_WriteExpressionBCL(p, l, stdout);
+  puts("");
 
-  free(expr);
   bcp_DeleteBCX(p, x);
   bcp_DeleteBCL(p, l);
   bcp_Delete(p);
@@ -197,9 +227,18 @@ int bc_ExecuteParse(const char *s)
 void help()
 {
   puts("-test");
+  puts("-slotcnt <n>, number of slots for the following -json or -server, default 9");
+  puts("-threadcnt <n>, number of threads for the following -json or -server, default is the number of processors");
   puts("-json <json file>");
-  puts("-dimacscnf <dimacs cnf file>");
+  puts("-server, read one json request per line from stdin, see bcserver.c");
+  puts("-dimacscnf <dimacs cnf file>, use \"-\" for stdin");
+  puts("-pla <pla file>, minimize all outputs and write the result as PLA, use \"-\" for stdin");
   puts("-parse <boolean expression>");
+  puts("-benchrep <n>, number of repetitions for each benchmark of the following -bench, default 7");
+  puts("-benchout <json file>, result file of the following -bench, default is stdout");
+  puts("-benchbaseline <json file>, compare the result of the following -bench with this previous result");
+  puts("-benchtolerance <x>, allowed slowdown against the baseline, default 0.10");
+  puts("-bench [<dimacs cnf or pla file> ...], run the benchmarks, see bcbench.c");
 }
 
 int main(int argc, char **argv)
@@ -208,6 +247,8 @@ int main(int argc, char **argv)
   if ( *argv == NULL )
       return 0;
   times(&start);
+  if ( sysconf(_SC_NPROCESSORS_ONLN) > 1 )
+    json_thread_cnt = (int)sysconf(_SC_NPROCESSORS_ONLN);
   argv++;    // skip program name
   for(;;)
   {
@@ -222,9 +263,65 @@ int main(int argc, char **argv)
     else if ( strcmp(*argv, "-test") == 0 )
     {
       internalTest(7);
+      cubeKernelTest(130);
+      cubeKernelTest(520);
+      sliceTest(70);
+      sliceTest(200);
+      signatureTest(20);
+      signatureTest(150);
+      sccTest(20);
+      sccTest(130);
+      arenaTest(200);
+      reserveTest(60);
+      moveTest(70);
+      urpComplementTest(24);
+      tautologyCacheTest(40);
+      tautologyLeafTest(14);
+      truthTableTest(5);
+      truthTableTest(14);
+      partitionTest(4);
+      dimacsCNFTest(30);
+      plaTest(10, 4, "fd");
+      plaTest(6, 3, "fr");
+      plaTest(8, 1, "f");
+      binaryBCLTest(150);
+      stringConversionTest(13);
+      stringConversionTest(64);
+      stringConversionTest(203);
+      expressionOutputTest(150);
+      expandTest(12);
+      expandTest(24);
+      reduceMinimizeTest(12);
+      reduceMinimizeTest(20);
+      intersectionTest(20);
+      intersectionTest(100);
+      splitTableTest(20);
+      splitTableTest(70);
+      parallelTautologyTest(80);
+      contextTest(60);
+      parallelMCCTest(14);
+      jsonTest(40);
+      serverTest();
+      statTest(30);
       expressionTest();
       argv++;
     }
+    else if ( strcmp(*argv, "-slotcnt") == 0 )
+    {
+      argv++;
+      if ( (*argv) == NULL || atoi(*argv) <= 0 )
+        return puts("slot count missing"), 1;
+      json_slot_cnt = atoi(*argv);
+      argv++;
+    }
+    else if ( strcmp(*argv, "-threadcnt") == 0 )
+    {
+      argv++;
+      if ( (*argv) == NULL || atoi(*argv) <= 0 )
+        return puts("thread count missing"), 1;
+      json_thread_cnt = atoi(*argv);
+      argv++;
+    }
     else if ( strcmp(*argv, "-json") == 0 )
     {
       argv++;
@@ -233,6 +330,11 @@ int main(int argc, char **argv)
       bc_ExecuteJSONFile(*argv);
       argv++;
     }
+    else if ( strcmp(*argv, "-server") == 0 )
+    {
+      bc_ExecuteServer(stdin, stdout, json_slot_cnt, json_thread_cnt);
+      argv++;
+    }
     else if ( strcmp(*argv, "-dimacscnf") == 0 )
     {
       argv++;
@@ -241,6 +343,59 @@ int main(int argc, char **argv)
       bc_ExecuteDIMACSCNF(*argv);
       argv++;
     }
+    else if ( strcmp(*argv, "-pla") == 0 )
+    {
+      argv++;
+      if ( (*argv) == NULL )
+        return puts("pla filename missing"), 1;
+      bc_ExecutePLA(*argv);
+      is_pla_output = 1;
+      argv++;
+    }
+    else if ( strcmp(*argv, "-benchrep") == 0 )
+    {
+      argv++;
+      if ( (*argv) == NULL || atoi(*argv) <= 0 )
+        return puts("repetition count missing"), 1;
+      bench_rep_cnt = atoi(*argv);
+      argv++;
+    }
+    else if ( strcmp(*argv, "-benchout") == 0 )
+    {
+      argv++;
+      if ( (*argv) == NULL )
+        return puts("bench output filename missing"), 1;
+      bench_out_name = *argv;
+      argv++;
+    }
+    else if ( strcmp(*argv, "-benchbaseline") == 0 )
+    {
+      argv++;
+      if ( (*argv) == NULL )
+        return puts("bench baseline filename missing"), 1;
+      bench_baseline_name = *argv;
+      argv++;
+    }
+    else if ( strcmp(*argv, "-benchtolerance") == 0 )
+    {
+      argv++;
+      if ( (*argv) == NULL || atof(*argv) < 0.0 )
+        return puts("bench tolerance missing"), 1;
+      bench_tolerance = atof(*argv);
+      argv++;
+    }
+    else if ( strcmp(*argv, "-bench") == 0 )
+    {
+      char **file_list;
+      int file_cnt = 0;
+      argv++;
+      file_list = argv;         // all following arguments, which are not an option, are corpus files
+      while( file_list[file_cnt] != NULL && file_list[file_cnt][0] != '-' )
+        file_cnt++;
+      argv += file_cnt;
+      if ( bc_ExecuteBench(bench_rep_cnt, file_list, file_cnt, bench_out_name, bench_baseline_name, bench_tolerance) != 0 )
+        return puts("bench failed"), 1;
+    }
     else if ( strcmp(*argv, "-parse") == 0 )
     {
       argv++;
@@ -257,8 +412,8 @@ int main(int argc, char **argv)
     }
       
   }
-  printf("user time: %lld\n", (long long int)(end.tms_utime-start.tms_utime));
   times(&end);
+  printf("%suser time: %.3f\n", is_pla_output ? "# " : "", (double)(end.tms_utime-start.tms_utime)/(double)sysconf(_SC_CLK_TCK));
   return 0;
 }
 